@@ -27,7 +27,15 @@ public:
     void AnimateValue(float from, float to, const SpringConfig& config,
                       ValueCallback onUpdate, CompletionCallback onComplete = nullptr);
 
-    // Clear all animations
+    // Frame-timed playback (animated images): onTick gets each Update's
+    // elapsed seconds and returns true when it put up a new frame. Only those
+    // updates count as active, so playback renders at the content's frame
+    // rate instead of continuously. Returns an id for RemoveFrameClock().
+    using TickCallback = std::function<bool(float)>;
+    uint32_t AddFrameClock(TickCallback onTick);
+    void RemoveFrameClock(uint32_t id);
+
+    // Clear all animations (frame clocks stay registered)
     void Clear();
 
 private:
@@ -39,6 +47,14 @@ private:
     };
 
     std::vector<ManagedSpring> springs_;
+
+    struct FrameClock {
+        uint32_t id = 0;
+        TickCallback onTick;
+    };
+    std::vector<FrameClock> clocks_;
+    uint32_t nextClockId_ = 1;
+    bool frameTicked_ = false;  // a clock advanced during the last Update
 };
 
 } // namespace Animation
@@ -30,6 +30,10 @@ public:
     float GetVelocity() const { return velocity_; }
     const SpringConfig& GetConfig() const { return config_; }
 
+    // Where the spring comes to rest. The integrator converges on the target
+    // for any positive stiffness/damping, so this is exact up to restThreshold.
+    float PredictRestValue() const { return target_; }
+
     // Snap to target immediately
     void SnapToTarget();
 
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <filesystem>
+#include <cstdint>
+#include <wrl/client.h>
+#include <wincodec.h>
+
+namespace UltraImageViewer {
+namespace Core {
+
+class MemoryMappedFile;
+
+// One composited frame of an animation, ready to show
+struct AnimationFrame {
+    std::unique_ptr<uint8_t[]> pixels;   // tightly packed PBGRA
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t delayMs = 0;                // how long it stays up
+};
+
+/**
+ * Streaming decoder for animated GIF and WebP. Frames are decoded one at a
+ * time, as playback asks for them, and composited onto a canvas per their
+ * disposal and blend modes: memory holds the canvas (plus a saved copy while
+ * a frame asks to be restored to the previous one), never the whole
+ * animation. Output frames are the canvas fit to maxDimension.
+ * The file is read through a mapped view. GIF frames and metadata come from
+ * WIC; WebP ANMF chunks are parsed here and each frame's bitstream is handed
+ * to WIC on its own.
+ * Single-threaded: one caller at a time.
+ */
+class AnimationDecoder {
+public:
+    ~AnimationDecoder();
+
+    // nullptr when the file can't be read or has a single frame
+    static std::unique_ptr<AnimationDecoder> Open(IWICImagingFactory2* factory,
+                                                  const std::filesystem::path& filePath,
+                                                  uint32_t maxDimension);
+
+    // Output size (the canvas fit to maxDimension, never upscaled)
+    uint32_t GetWidth() const { return outWidth_; }
+    uint32_t GetHeight() const { return outHeight_; }
+    uint32_t GetCanvasWidth() const { return canvasWidth_; }
+    uint32_t GetCanvasHeight() const { return canvasHeight_; }
+    uint32_t GetFrameCount() const { return static_cast<uint32_t>(frames_.size()); }
+
+    // Composites the next frame, starting over after the last. False on a
+    // decode error or once the file's loop count has played out.
+    bool DecodeNext(AnimationFrame& out);
+
+private:
+    enum class Disposal : uint8_t { Keep, Background, Previous };
+
+    struct FrameInfo {
+        uint32_t x = 0;             // placement on the canvas
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t delayMs = 0;
+        Disposal disposal = Disposal::Keep;
+        bool blend = true;          // alpha-blend over the canvas, else replace
+        size_t offset = 0;          // WebP: frame data (ALPH / VP8 / VP8L chunks)
+        size_t length = 0;
+    };
+
+    AnimationDecoder() = default;
+
+    bool OpenGif();
+    bool OpenWebp();
+
+    // Frame index's own pixels as PBGRA into framePixels_ (GIF frames fill
+    // in their FrameInfo here: it's read with the frame)
+    bool ReadGifFrame(uint32_t index);
+    bool ReadWebpFrame(uint32_t index);
+
+    void Composite(const FrameInfo& frame, const uint8_t* pixels);
+    void ClearRect(const FrameInfo& frame);
+
+    Microsoft::WRL::ComPtr<IWICImagingFactory2> factory_;
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> gifDecoder_;
+    std::unique_ptr<MemoryMappedFile> file_;
+
+    std::vector<FrameInfo> frames_;
+    uint32_t canvasWidth_ = 0;
+    uint32_t canvasHeight_ = 0;
+    uint32_t outWidth_ = 0;
+    uint32_t outHeight_ = 0;
+    uint32_t playCount_ = 0;        // times through the frames, 0 = forever
+
+    std::vector<uint8_t> canvas_;   // PBGRA, canvasWidth_ x canvasHeight_
+    std::vector<uint8_t> saved_;    // canvas before a Disposal::Previous frame
+    std::vector<uint8_t> framePixels_;
+    std::vector<uint8_t> bitstream_; // WebP: one frame wrapped as a still file
+    uint32_t next_ = 0;             // frame DecodeNext composites
+    uint32_t loopsPlayed_ = 0;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
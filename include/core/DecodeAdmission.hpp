@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <condition_variable>
+
+namespace UltraImageViewer {
+namespace Core {
+
+/**
+ * Byte semaphore for large decodes. Each decode reserves its expected output
+ * size before allocating, so concurrent full-resolution decodes can't
+ * together exceed the in-flight budget.
+ * A reservation larger than the whole capacity is admitted once nothing
+ * else is in flight (it could never fit otherwise).
+ */
+class DecodeAdmission {
+public:
+    explicit DecodeAdmission(size_t capacityBytes = 0);
+
+    // User-initiated decodes: block until the bytes fit.
+    // Returns false only after Shutdown().
+    bool Acquire(size_t bytes);
+
+    // Prefetch decodes: never block, and yield to any waiting Acquire().
+    bool TryAcquire(size_t bytes);
+
+    void Release(size_t bytes);
+
+    // Budget changes (memory pressure) apply to the next admission
+    void SetCapacity(size_t capacityBytes);
+
+    // Fail all current and future Acquire() calls (pipeline teardown)
+    void Shutdown();
+
+    size_t GetInFlightBytes() const;
+
+private:
+    bool FitsLocked(size_t bytes) const { return inFlight_ == 0 || inFlight_ + bytes <= capacity_; }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t capacity_;
+    size_t inFlight_ = 0;
+    int waiters_ = 0;
+    bool shutdown_ = false;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// What the gallery needs from a JPEG's EXIF block
+struct ExifInfo {
+    uint16_t orientation = 1;      // EXIF 1..8 (1 = upright)
+    size_t thumbnailOffset = 0;    // embedded JPEG thumbnail, offset from file start
+    size_t thumbnailLength = 0;    // 0 = none
+    int year = 0;                  // DateTimeOriginal; 0 when absent
+    int month = 0;
+};
+
+// Parses the APP1 "Exif" segment of a JPEG held in memory. data may be just
+// the head of the file: the segment sits before the frame header, within the
+// first 64 KB. Returns false when there's no (readable) EXIF block.
+bool ReadExif(const uint8_t* data, size_t size, ExifInfo& info);
+
+// Same fields from a bare TIFF structure: a TIFF file (or RAW container) or
+// an APP1 payload. The thumbnail offset is relative to data.
+bool ReadExifTiff(const uint8_t* data, size_t size, ExifInfo& info);
+
+// Largest embedded JPEG preview of a TIFF-based RAW file
+struct RawPreview {
+    size_t offset = 0;             // from file start
+    size_t length = 0;
+    uint32_t width = 0;            // JPEG frame size, as stored
+    uint32_t height = 0;
+    uint16_t orientation = 1;      // the RAW's (IFD0), applies to the preview
+};
+
+// Searches IFD0's chain and SubIFDs of a TIFF-based RAW (CR2, NEF, ARW, DNG,
+// PEF, SRW) for baseline/progressive JPEG previews: JPEGInterchangeFormat
+// blocks and single-strip JPEG images. Only the IFDs and each candidate's
+// header are read, so a mapped view faults in a few pages. False when none.
+bool FindRawPreview(const uint8_t* data, size_t size, RawPreview& preview);
+
+// Pages of a multi-page TIFF: the IFDs chained from IFD0 (SubIFDs hold
+// reduced copies, not pages). Only the IFD entry tables are read. 0 when
+// data isn't a classic TIFF.
+uint32_t CountTiffPages(const uint8_t* data, size_t size);
+
+// Orientation tag of page's IFD (1 when absent or past the last page)
+uint16_t TiffPageOrientation(const uint8_t* data, size_t size, uint32_t page);
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace UltraImageViewer {
+namespace Core {
+
+/**
+ * Scripted gallery scroll against a real ImagePipeline with no window or GPU
+ * (textures come from NullTextureFactory). Exercises request -> decode ->
+ * ready queue -> upload -> evict -> persist with fixed frame pacing, so runs
+ * over the same folder are comparable.
+ */
+struct HeadlessBenchmarkOptions {
+    int columns = 6;
+    int visibleRows = 4;
+    float cellPx = 240.0f;
+    float scrollPxPerFrame = 96.0f;    // ~5800 px/s at 60 Hz: a brisk flick
+    double frameMs = 1000.0 / 60.0;
+    int maxSettleFrames = 600;         // give up waiting for the last screen after 10 s
+    bool warmPass = true;              // second pass reading the persistent cache the first one wrote
+};
+
+// Runs the cold pass (and optionally the warm pass) over the images in
+// folder and returns a human-readable report. Requires COM on the calling thread.
+std::string RunHeadlessBenchmark(const std::filesystem::path& folder,
+                                 const HeadlessBenchmarkOptions& options = {});
+
+// Decodes every image in folder with the native codecs and with WIC (full
+// size and into a thumbnailPx box) and reports timings per backend, files
+// the native codecs declined, and PSNR of native output against WIC's.
+// Requires COM on the calling thread.
+std::string RunDecodeBenchmark(const std::filesystem::path& folder, uint32_t thumbnailPx = 256);
+
+// Mutation fuzzing of the native codecs: every image in folder a native
+// codec accepts seeds mutationsPerFile decodes of a corrupted copy (bit
+// flips, truncation, random and boundary bytes in JPEG header segments),
+// at full size and DCT-scaled. Returning at all is the pass; build with
+// ASan to catch overruns that don't crash.
+std::string RunCodecFuzz(const std::filesystem::path& folder, uint32_t mutationsPerFile = 2000);
+
+// Thumbnails every image in folder on a thread pool twice: one task per file
+// in a shuffled order (how scattered requests hit the disk), then through
+// ImageDecoder::DecodeBatch. Each pass starts with the files pushed out of
+// the OS cache (best effort) and reports images/s. Requires COM on the
+// calling thread.
+std::string RunBatchBenchmark(const std::filesystem::path& folder, uint32_t thumbnailPx = 256);
+
+// Stress test of ImageDecoder::DecodeAsync on a synthetic image written to
+// the temp folder, decodeCount decodes per phase: mass submit (every decode
+// calls back once, with an image), cancellation mid-flight (no callback
+// once the stop was seen), and the decoder destroyed with decodes still
+// queued, then after the pool purged them (the destructor returns and
+// nothing calls back afterwards). Requires COM on the calling thread.
+std::string RunAsyncStress(uint32_t decodeCount = 10000);
+
+// Times every Simd::ConvertToPBGRA layout and Simd::ToneMapToPBGRA operator
+// at each SIMD tier the CPU runs on pixelCount synthetic pixels (GB/s of
+// source + destination traffic), and checks each tier's output against the
+// scalar reference: byte for byte, within one step for tone mapping.
+std::string RunConvertBenchmark(size_t pixelCount = 8u << 20);
+
+// Bit-exact check of Simd::ConvertToPBGRA for every layout at each SIMD tier
+// the CPU runs, against a per-pixel reference written from the documented
+// formulas: every 8-bit channel/alpha pair and 16-bit value, plus every run
+// length up to past two vector blocks at misaligned source and destination
+// pointers (writes outside the run fail too). passed (optional) receives the
+// verdict.
+std::string RunConvertCheck(bool* passed = nullptr);
+
+} // namespace Core
+} // namespace UltraImageViewer
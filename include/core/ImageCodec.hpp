@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// Output of a native codec: tightly packed 32bpp premultiplied BGRA
+struct CodecImage {
+    std::unique_ptr<uint8_t[]> pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t sourceWidth = 0;   // full image size (differs from width/height for scaled decodes)
+    uint32_t sourceHeight = 0;
+};
+
+/**
+ * Portable decoder for one file format, working on an in-memory file.
+ * No platform APIs: native codecs build and run anywhere. A codec that
+ * meets a variant it doesn't implement returns false, and ImageDecoder
+ * falls back to WIC.
+ */
+class ImageCodec {
+public:
+    virtual ~ImageCodec() = default;
+
+    virtual const char* Name() const = 0;
+
+    // Signature check on the first bytes of the file
+    virtual bool Matches(const uint8_t* data, size_t size) const = 0;
+
+    // Dimensions from the header only
+    virtual bool ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const = 0;
+
+    // maxDimension is a hint: codecs that can decode at reduced size return
+    // the smallest such image still covering the box. 0 = full resolution.
+    virtual bool Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const = 0;
+};
+
+// Ordered list of native codecs; the first whose signature matches decodes
+class CodecRegistry {
+public:
+    void Register(std::unique_ptr<ImageCodec> codec);
+    const ImageCodec* Find(const uint8_t* data, size_t size) const;
+
+    // JPEG, BMP and uncompressed TIFF
+    static CodecRegistry CreateDefault();
+
+private:
+    std::vector<std::unique_ptr<ImageCodec>> codecs_;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
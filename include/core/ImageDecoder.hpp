@@ -6,8 +6,13 @@
 #include <filesystem>
 #include <optional>
 #include <functional>
+#include <stop_token>
 #include <wrl/client.h>
 #include <wincodec.h>
+#include "TiledImage.hpp"
+#include "AnimatedImage.hpp"
+#include "ImageCodec.hpp"
+#include "ThreadPool.hpp"
 
 namespace UltraImageViewer {
 namespace Core {
@@ -19,13 +24,18 @@ struct ImageInfo {
     WICPixelFormatGUID pixelFormat;
     size_t dataSize;
     bool hasAlpha;
-    bool isHDR;
+    bool isHDR;          // over 8 bits per channel, or float / fixed point (scRGB)
 };
 
 struct DecodedImage {
+    // 32bpp PBGRA; 64bpp premultiplied half-float RGBA (info.bitsPerPixel
+    // 64) when decoded with DecoderFlags::HighBitDepth
     std::unique_ptr<uint8_t[]> data;
     ImageInfo info;
     std::filesystem::path sourcePath;
+    // Source frame dimensions (differ from info for scaled decodes)
+    uint32_t sourceWidth = 0;
+    uint32_t sourceHeight = 0;
 
     // Zero-copy metadata
     void* userData = nullptr;
@@ -37,7 +47,8 @@ enum class DecoderFlags {
     ZeroCopy = 1 << 0,
     MemoryMapped = 1 << 1,
     Cacheable = 1 << 3,
-    BackgroundLoad = 1 << 4
+    BackgroundLoad = 1 << 4,
+    HighBitDepth = 1 << 5    // keep deep sources (16-bit PNG/TIFF, JXR) at full depth: twice the memory, viewer only
 };
 
 inline DecoderFlags operator|(DecoderFlags a, DecoderFlags b) {
@@ -48,29 +59,79 @@ inline bool HasFlag(DecoderFlags flags, DecoderFlags flag) {
     return (static_cast<int>(flags) & static_cast<int>(flag)) != 0;
 }
 
+// Which decoder handles formats that have a native codec (JPEG, BMP, TIFF)
+enum class DecodeBackend {
+    Auto,    // native codec, WIC when the codec declines the file
+    Native,  // native codec only (benchmarks; unsupported variants fail)
+    WIC      // WIC only
+};
+
+// Streaming decodes report each finished band of rows, top to bottom.
+// Rows [firstRow, firstRow + rowCount) of image.data are final when called;
+// info is already set (stride = width * 4). Runs on the decoding thread.
+// Images with a non-trivial EXIF orientation report one band once upright.
+using RowBandCallback = std::function<void(const DecodedImage& image, uint32_t firstRow, uint32_t rowCount)>;
+
 /**
  * Zero-copy image decoder
  * Supports JPEG, PNG, TIFF, BMP, GIF, WebP, and RAW formats
+ * Every decode comes back upright: EXIF orientation is applied once here
+ * (info and source sizes are the turned ones), never at draw time.
  */
 class ImageDecoder {
 public:
     ImageDecoder();
     ~ImageDecoder();
 
-    // Main decoding interface
+    // Main decoding interface. With DecoderFlags::MemoryMapped, large files
+    // decode straight from a mapped view and onBand (optional) sees the
+    // output fill in row bands.
     std::unique_ptr<DecodedImage> Decode(
         const std::filesystem::path& filePath,
-        DecoderFlags flags = DecoderFlags::ZeroCopy
+        DecoderFlags flags = DecoderFlags::ZeroCopy,
+        const RowBandCallback& onBand = nullptr
     );
 
-    // Async decoding
+    // Async decoding on the given lane of a shared pool. callback runs once
+    // on the pool thread with the image (nullptr if decoding failed), unless
+    // cancel was requested before the result was ready. Tasks still queued
+    // when the decoder is destroyed are dropped without a callback; the
+    // destructor waits for any that are mid-decode.
     void DecodeAsync(
+        ThreadPool& pool,
         const std::filesystem::path& filePath,
         std::function<void(std::unique_ptr<DecodedImage>)> callback,
+        TaskPriority priority = TaskPriority::Normal,
+        std::stop_token cancel = {},
         DecoderFlags flags = DecoderFlags::ZeroCopy | DecoderFlags::BackgroundLoad
     );
 
-    // Image info without full decoding
+    // Throughput-oriented decode of many files (bulk thumbnailing, cache
+    // warming). Files are read one after another in on-disk order by the
+    // calling thread while pool workers decode what has been read, so a cold
+    // HDD or network share streams instead of seeking. sink runs on a pool
+    // thread as each file completes, with its index in paths (image nullptr
+    // on failure); calls may overlap. maxDimension > 0 fits images into that
+    // box like GenerateThumbnail(), 0 decodes full size. Stops queuing once
+    // cancel is requested and returns after every queued file was sunk (or
+    // purged from the pool), so call it from outside pool.
+    using BatchSink = std::function<void(size_t index, std::unique_ptr<DecodedImage> image)>;
+    void DecodeBatch(
+        ThreadPool& pool,
+        const std::vector<std::filesystem::path>& paths,
+        const BatchSink& sink,
+        uint32_t maxDimension = 0,
+        TaskPriority priority = TaskPriority::Normal,
+        std::stop_token cancel = {}
+    );
+
+    // The order DecodeBatch() reads paths in, as indices into paths: per
+    // volume by first cluster (FSCTL_GET_RETRIEVAL_POINTERS), then by file ID
+    // for files without clusters of their own (small files live in the MFT),
+    // then directory order for network paths and anything not queryable
+    static std::vector<size_t> DiskOrder(const std::vector<std::filesystem::path>& paths);
+
+    // Image info without full decoding (upright size, like Decode's)
     std::optional<ImageInfo> GetImageInfo(const std::filesystem::path& filePath);
 
     // Thumbnail generation (fast, low-resolution)
@@ -79,30 +140,121 @@ public:
         uint32_t maxSize = 256
     );
 
+    // JPEG's embedded EXIF thumbnail (typically 160x120), read through a
+    // small mapped view of the file head, cropped to the main image's aspect
+    // and turned upright. orientation receives the EXIF orientation (1 when
+    // absent) even when there's no usable thumbnail. nullptr for non-JPEGs /
+    // no thumbnail.
+    std::unique_ptr<DecodedImage> DecodeExifThumbnail(
+        const std::filesystem::path& filePath,
+        uint16_t& orientation
+    );
+
+    // Region decoder for images too large to decode whole (nullptr on failure)
+    std::shared_ptr<TiledImageSource> OpenTiled(const std::filesystem::path& filePath);
+
+    // Frame-by-frame decoder for an animated GIF/WebP, frames fit to
+    // maxDimension (0 = canvas size). nullptr for stills and on failure.
+    std::unique_ptr<AnimationDecoder> OpenAnimation(const std::filesystem::path& filePath,
+                                                    uint32_t maxDimension);
+
+    // Pages of a multi-page TIFF or the images of an ICO, counted from the
+    // headers (no pixels decoded); 1 for other formats and unreadable files
+    uint32_t GetPageCount(const std::filesystem::path& filePath);
+
+    // One page fit to maxDimension (0 = full size), upright. Page 0 is the
+    // image Decode() and GenerateThumbnail() show; nullptr past the last.
+    std::unique_ptr<DecodedImage> DecodePage(const std::filesystem::path& filePath,
+                                             uint32_t page, uint32_t maxDimension);
+
+    // Set before decoding starts; not synchronized with in-flight decodes
+    void SetBackend(DecodeBackend backend) { backend_ = backend; }
+    DecodeBackend GetBackend() const { return backend_; }
+
     // Supported formats
     static bool IsSupportedFormat(const std::filesystem::path& filePath);
     static std::vector<std::wstring> GetSupportedExtensions();
 
+    // TIFF-based camera RAW (CR2, NEF, ARW, DNG, ...): shown through the
+    // largest embedded JPEG preview, no demosaic
+    static bool IsRawFormat(const std::filesystem::path& filePath);
+
+    // Containers that may hold an animation (GIF, WebP); only
+    // OpenAnimation() tells whether a given file does
+    static bool IsAnimatedFormat(const std::filesystem::path& filePath);
+
+    // Containers that may hold several pages (TIFF, ICO); only
+    // GetPageCount() tells how many a given file has
+    static bool IsMultiPageFormat(const std::filesystem::path& filePath);
+
 private:
+    // Native codec path: whole file in memory, decode, downsample to fit
+    // maxDimension (0 = full size). nullptr when no codec takes the file.
+    std::unique_ptr<DecodedImage> DecodeNative(
+        const std::filesystem::path& filePath,
+        uint32_t maxDimension
+    );
+
+    bool UseNative(const std::filesystem::path& filePath) const;
+
+    // Native codec over a file already in memory; bytes are released once
+    // decoded and left intact when no codec takes them
+    std::unique_ptr<DecodedImage> DecodeNativeBytes(
+        const std::filesystem::path& filePath,
+        std::vector<uint8_t>& bytes,
+        uint32_t maxDimension
+    );
+
+    // A frame of a WIC decoder, fit to maxDimension (0 = full size): Fant
+    // for the bulk of a big reduction, the linear-light resampler for the rest
+    std::unique_ptr<DecodedImage> DecodeWicFrame(
+        IWICBitmapDecoder* decoder,
+        const std::filesystem::path& filePath,
+        uint32_t maxDimension,
+        uint16_t orientation,
+        uint32_t frameIndex = 0
+    );
+
+    // DecodeBatch's worker: a file read ahead into bytes
+    std::unique_ptr<DecodedImage> DecodeBuffer(
+        const std::filesystem::path& filePath,
+        std::vector<uint8_t>& bytes,
+        uint32_t maxDimension
+    );
+
+    // Deep sources as linear premultiplied half floats, upright; nullptr for
+    // 8-bit ones so Decode() carries on down its usual path
+    std::unique_ptr<DecodedImage> DecodeHighBitDepth(const std::filesystem::path& filePath);
+
     // WIC decoder implementation
     std::unique_ptr<DecodedImage> DecodeWithWIC(
         const std::filesystem::path& filePath,
         DecoderFlags flags
     );
 
-    // RAW decoder implementation
+    // RAW via its embedded preview, read from a mapped view (only the IFDs
+    // and the preview's pages are touched); fit to maxDimension (0 = full)
     std::unique_ptr<DecodedImage> DecodeRAW(
         const std::filesystem::path& filePath,
-        DecoderFlags flags
+        uint32_t maxDimension
     );
 
-    // Memory-mapped file support
+    // Decode from a read-only view of the whole file: no read buffer, the
+    // native codec or a WIC memory stream parses the mapped pages directly
     std::unique_ptr<DecodedImage> DecodeMemoryMapped(
         const std::filesystem::path& filePath,
-        DecoderFlags flags
+        DecoderFlags flags,
+        const RowBandCallback& onBand
     );
 
     Microsoft::WRL::ComPtr<IWICImagingFactory2> wicFactory_;
+    CodecRegistry codecs_ = CodecRegistry::CreateDefault();
+    DecodeBackend backend_ = DecodeBackend::Auto;
+
+    // Outlives the decoder: queued DecodeAsync tasks check it, not `this`
+    struct AsyncState;
+    struct AsyncTicket;
+    std::shared_ptr<AsyncState> async_;
 };
 
 } // namespace Core
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include <mutex>
 #include <shared_mutex>
@@ -17,16 +18,35 @@
 #include "ImageDecoder.hpp"
 #include "CacheManager.hpp"
 #include "ThreadPool.hpp"
-#include "../rendering/Direct2DRenderer.hpp"
+#include "MemoryGovernor.hpp"
+#include "DecodeAdmission.hpp"
+#include "PipelineTrace.hpp"
+#include "../rendering/TextureFactory.hpp"
 
 namespace UltraImageViewer {
 namespace Core {
 
+// Thumbnail resolution ladder (longest edge, px). Level 0 is cheap enough to
+// upload during fast scroll; higher levels replace it once scrolling settles.
+inline constexpr uint32_t kThumbnailLevelPx[] = {48, 160, 320};
+inline constexpr int kThumbnailLevelCount = 3;
+
 struct ScannedImage {
     std::filesystem::path path;
     std::filesystem::path sourceFolder;  // Top-level scan folder this image came from
-    int year = 0;
+    int year = 0;            // EXIF DateTimeOriginal when present, else last write time
     int month = 0;
+    uint64_t contentId = 0;  // equal for byte-identical files (whole-file hash); 0 = no same-size file was found
+
+    // Header probe (width 0 = not probed / unknown format)
+    uint32_t width = 0;      // stored frame size, before orientation
+    uint32_t height = 0;
+    uint16_t orientation = 1;
+    uint8_t bitDepth = 0;
+
+    // Change detection: probe results are reused while both match
+    uint64_t fileSize = 0;
+    uint64_t modified = 0;   // FILETIME of the last write
 };
 
 class ImagePipeline {
@@ -34,24 +54,97 @@ public:
     ImagePipeline();
     ~ImagePipeline();
 
-    void Initialize(ImageDecoder* decoder, CacheManager* cache, Rendering::Direct2DRenderer* renderer);
+    void Initialize(ImageDecoder* decoder, CacheManager* cache, Rendering::TextureFactory* renderer);
     void Shutdown();
 
-    // Synchronous bitmap retrieval (from cache first)
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> GetBitmap(const std::filesystem::path& path);
-
     // Asynchronous bitmap retrieval
     using BitmapCallback = std::function<void(Microsoft::WRL::ComPtr<ID2D1Bitmap>)>;
     void GetBitmapAsync(const std::filesystem::path& path, BitmapCallback callback);
 
+    // Staged viewer open: decode to fit a maxDimension box (never upscaled) off
+    // the UI thread; maxDimension 0 decodes at full resolution. isFullResolution
+    // is true when the result holds every source pixel. Cached results call back
+    // immediately; otherwise the callback runs from FlushReadyBitmaps().
+    using PreviewCallback = std::function<void(Microsoft::WRL::ComPtr<ID2D1Bitmap>, bool isFullResolution)>;
+    void GetPreviewAsync(const std::filesystem::path& path, uint32_t maxDimension,
+                         PreviewCallback callback, TaskPriority priority = TaskPriority::High);
+
+    // Drop all outstanding GetPreviewAsync() work: queued decodes are skipped and
+    // finished ones are cached without running their callbacks, unless a later
+    // request for the same image and size takes them over. Call on page change.
+    void CancelOpenRequests();
+
+    // Source dimensions (upright) recorded by the last GetPreviewAsync()
+    // decode of path, else from its scan probe (SetScannedSizes)
+    bool GetSourceSize(const std::filesystem::path& path, uint32_t& width, uint32_t& height) const;
+
+    // --- Tiled images (see TiledImageSource) ---
+    // Returns the cached tile bitmap, or nullptr and queues its decode.
+    // Queued tile decodes are dropped by CancelOpenRequests() like previews.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestTile(const std::filesystem::path& path,
+                                                    int level, uint32_t tileX, uint32_t tileY);
+
+    // Called by the viewer each frame: upload decoded tiles. Returns bitmaps created.
+    int FlushReadyTiles(int maxCount);
+
+    // --- Animated images (GIF, WebP; see AnimationDecoder) ---
+    // Current frame of path's animation fit to maxDimension, or nullptr while
+    // it opens and for stills: callers draw the poster (thumbnail or preview)
+    // meanwhile. The first request opens a streaming decoder on the pool.
+    // UI thread only, like AdvanceAnimations().
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestAnimationFrame(const std::filesystem::path& path,
+                                                              uint32_t maxDimension);
+
+    // Frame clock (see AnimationEngine::AddFrameClock): puts up each
+    // animation's next frame once its delay has run out and keeps its ring of
+    // frames decoded ahead topped up. An animation whose frame wasn't drawn
+    // before the next one fell due is off screen: it's released, leaving only
+    // its poster resident. Returns true when a shown frame changed.
+    bool AdvanceAnimations(float deltaTime);
+
+    // --- Multi-page documents (TIFF pages, ICO images) ---
+    // Page count from the file's headers, 1 for single-page formats;
+    // remembered per path. UI thread only, like the calls below.
+    uint32_t GetDocPageCount(const std::filesystem::path& path);
+
+    // Page of path's document fit to maxDimension (> 0), or nullptr and
+    // queues its decode. Pages are decoded on demand and only the requested
+    // one and its neighbours stay resident: the neighbours are decoded ahead,
+    // pages further away (and every page of another document) are released.
+    // Page 0 belongs to the staged open (GetPreviewAsync), so it only moves
+    // the window here and always returns nullptr.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestDocPage(const std::filesystem::path& path,
+                                                       uint32_t page, uint32_t maxDimension);
+
+    // Page strip thumbnail, decoded on demand; kept while within
+    // Theme::DocPageStripRadius of the last RequestDocPage() page
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestDocPageThumbnail(const std::filesystem::path& path,
+                                                                uint32_t page, uint32_t maxDimension);
+
+    // Called by the viewer each frame: upload decoded pages. Returns bitmaps created.
+    int FlushReadyDocPages(int maxCount);
+
+    // Drop every page bitmap; queued page decodes are skipped
+    void ReleaseDocPages();
+
     // Thumbnail (fast, low-resolution) — synchronous, kept for compatibility
     Microsoft::WRL::ComPtr<ID2D1Bitmap> GetThumbnail(const std::filesystem::path& path, uint32_t maxSize = 256);
 
     // --- Async thumbnail API (non-blocking) ---
 
     // Returns cached bitmap immediately, or nullptr if not yet decoded.
-    // Queues a background decode request on cache miss.
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestThumbnail(const std::filesystem::path& path, uint32_t targetSize);
+    // targetSize is rounded up to a ladder level; a cached lower level is
+    // returned while the requested one decodes. viewportDistance is the
+    // signed offset (px) of the cell centre from the viewport centre, positive
+    // below; requests closer to the centre are decoded first.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> RequestThumbnail(const std::filesystem::path& path, uint32_t targetSize,
+                                                         float viewportDistance = 0.0f);
+
+    // Re-rank queued thumbnail requests once per frame. Applies the distances
+    // reported by RequestThumbnail() for already-pending paths since the last
+    // call. scrollDirection: +1 scrolling down, -1 up, 0 idle — requests
+    // behind the scroll direction are pushed back.
+    void UpdateThumbnailPriorities(int scrollDirection);
 
     // Called by render thread each frame. Creates D2D bitmaps from decoded pixel
     // buffers (up to maxCount per frame to stay within frame budget).
@@ -62,6 +155,10 @@ public:
     // decoded by worker threads and runs their callbacks on the UI thread.
     int FlushReadyBitmaps(int maxCount);
 
+    // Called once per frame by the UI thread. Reports tier usage to the memory
+    // governor and evicts immediately when it shrinks budgets under pressure.
+    void UpdateMemoryBudgets();
+
     // Drop all D2D device-dependent resources after device loss.
     void ReleaseDeviceResources();
 
@@ -84,13 +181,16 @@ public:
     // Scan arbitrary folders recursively for images (with date grouping)
     // Optional flushCallback is invoked periodically with sorted intermediate results
     // (every 200 images or after each top-level folder).
+    // Every image's header is probed (dimensions, orientation, capture date);
+    // entries in known whose size and write time still match are not re-read.
     using ScanFlushCallback = std::function<void(const std::vector<ScannedImage>&)>;
 
     static std::vector<ScannedImage> ScanFolders(
         const std::vector<std::filesystem::path>& folders,
         std::atomic<bool>& cancelFlag,
         std::atomic<size_t>& outCount,
-        ScanFlushCallback flushCallback = nullptr);
+        ScanFlushCallback flushCallback = nullptr,
+        const std::vector<ScannedImage>* known = nullptr);
 
     // Scan system image folders (Pictures, Desktop, Downloads) recursively
     static std::vector<ScannedImage> ScanSystemImages(
@@ -98,10 +198,14 @@ public:
         std::atomic<size_t>& outCount);
 
     // Cache-only thumbnail lookup (no decode queuing). Used during fast scroll
-    // to display already-loaded thumbnails without starting new work.
+    // to display already-loaded thumbnails without starting new work; falls
+    // back to the smallest persisted level, which is the cheapest to upload.
     Microsoft::WRL::ComPtr<ID2D1Bitmap> GetCachedThumbnail(const std::filesystem::path& path);
 
-    // Check if a thumbnail is already cached
+    // Smallest ladder level covering targetSize (top level if none does)
+    static int ThumbnailLevelFor(uint32_t targetSize);
+
+    // Check if a thumbnail (any level) is already cached
     bool HasThumbnail(const std::filesystem::path& path) const;
     bool HasFullImage(const std::filesystem::path& path) const;
 
@@ -109,17 +213,59 @@ public:
     void LoadPersistentThumbs(const std::filesystem::path& cachePath);
     void SavePersistentThumbs(const std::filesystem::path& cachePath);
 
+    // Byte-identical images (equal ScannedImage::contentId) share one set of
+    // thumbnails, cached and persisted under the group's canonical path (the
+    // lowest path, case-insensitive). Replaces the previous alias set.
+    void SetContentAliases(const std::vector<ScannedImage>& images);
+
+    // Header probes from a scan (ScannedImage::width/height/orientation/
+    // bitDepth) answer admission estimates and GetSourceSize for files not
+    // decoded yet, without reading them again. Replaces the previous set.
+    void SetScannedSizes(const std::vector<ScannedImage>& images);
+
+    // Stage timing of thumbnail requests (off by default)
+    PipelineTrace& GetTrace() { return trace_; }
+
 private:
-    // Decode and create D2D bitmap from a path
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> DecodeAndCreateBitmap(const std::filesystem::path& path);
+    // Decode and create a D2D thumbnail bitmap (GetThumbnail)
     Microsoft::WRL::ComPtr<ID2D1Bitmap> DecodeAndCreateThumbnail(const std::filesystem::path& path, uint32_t maxSize);
 
+    // Pool task: pops the best-ranked request from schedQueue_ and decodes it
+    void RunNextThumbnailRequest();
+
+    // Fit pixels into a ladder level's box (area downsample, never upscales)
+    static std::unique_ptr<uint8_t[]> ScaleToLevel(const uint8_t* src, uint32_t width, uint32_t height,
+                                                   int level, uint32_t& outWidth, uint32_t& outHeight);
+
+    // Render thread: upload the persisted level closest to wantedLevel straight
+    // into the GPU cache (counts against persistSyncBudget_). Returns the level
+    // uploaded, or -1.
+    int UploadPersistentThumb(const std::filesystem::path& path, int wantedLevel,
+                              Microsoft::WRL::ComPtr<ID2D1Bitmap>& outBitmap);
+
+    // Worker thread: copy the smallest persisted level >= level, downsampled to level
+    bool ReadPersistentThumb(const std::filesystem::path& path, int level,
+                             std::unique_ptr<uint8_t[]>& outPixels,
+                             uint32_t& outWidth, uint32_t& outHeight);
+
+    // Insert/replace a GPU cache entry; a lower level never replaces a higher one.
+    // Caller holds cacheMutex_.
+    void StoreThumbnailLocked(const std::filesystem::path& path,
+                              const Microsoft::WRL::ComPtr<ID2D1Bitmap>& bitmap,
+                              uint32_t width, uint32_t height, int level);
+
+    // Drop the pending marker unless a higher level is still queued. Caller holds cacheMutex_.
+    void ErasePendingLocked(const std::filesystem::path& path, int level);
+
     // Single-task thumbnail decode (submitted to ThreadPool)
     void ThumbnailDecodeTask(const std::filesystem::path& path,
-                             uint32_t targetSize, uint64_t generation);
+                             uint32_t targetSize, uint64_t generation,
+                             TraceTimeline trace = {});
 
     // LRU eviction for full-size image cache
     void EvictFullImagesIfNeeded();
+    void EvictPreviewsIfNeeded();
+    void EvictTilesIfNeeded();
 
     // LRU eviction for thumbnail cache (demotes to Tier 2 compressed cache)
     void EvictThumbnailsIfNeeded();
@@ -134,11 +280,14 @@ private:
         uint32_t rawSize = 0;  // uncompressed BGRA size
         uint16_t width = 0;
         uint16_t height = 0;
+        uint8_t level = 0;
         std::chrono::steady_clock::time_point lastAccess;
     };
     std::unordered_map<std::filesystem::path, CompressedThumbnail> tier2Cache_;
-    size_t tier2Bytes_ = 0;  // total compressed bytes
-    static constexpr size_t kTier2MaxBytes = 256ULL * 1024 * 1024;  // 256MB compressed
+    size_t tier2Bytes_ = 0;  // total compressed bytes (budget: MemoryTier::Tier2Compressed)
+
+    // Drop least recently used entries until incomingBytes fits. Caller holds cacheMutex_.
+    void EvictTier2Locked(size_t incomingBytes);
 
     // Compress/decompress helpers (Windows Compression API: XPRESS + Huffman)
     static bool CompressPixels(const uint8_t* src, uint32_t srcSize,
@@ -148,7 +297,22 @@ private:
 
     ImageDecoder* decoder_ = nullptr;
     CacheManager* cache_ = nullptr;
-    Rendering::Direct2DRenderer* renderer_ = nullptr;
+    Rendering::TextureFactory* renderer_ = nullptr;
+
+    // Owns the byte budgets of every cache tier below (and of cache_)
+    MemoryGovernor governor_;
+
+    PipelineTrace trace_;
+    size_t decodeCacheBudget_ = 0;
+
+    // Full-size and preview decodes reserve their output bytes here first.
+    // Capacity follows the governor's FullImage budget.
+    DecodeAdmission admission_;
+
+    // Expected BGRA bytes of decoding path into a maxDimension box
+    // (0 = full size), from the scan probe or else a header probe. 0 if the
+    // probe fails.
+    size_t ExpectedDecodeBytes(const std::filesystem::path& path, uint32_t maxDimension);
 
     // Unified thread pool (replaces all ad-hoc threads)
     std::unique_ptr<ThreadPool> threadPool_;
@@ -159,6 +323,7 @@ private:
         Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
         uint32_t width = 0;
         uint32_t height = 0;
+        int level = 0;  // ladder level this entry was produced for
         std::chrono::steady_clock::time_point lastAccess;
     };
     std::unordered_map<std::filesystem::path, ThumbnailCacheEntry> thumbnailCache_;
@@ -166,7 +331,31 @@ private:
 
     std::unordered_map<std::filesystem::path, Microsoft::WRL::ComPtr<ID2D1Bitmap>> fullImageCache_;
     size_t fullImageCacheBytes_ = 0;
-    static constexpr size_t kFullImageCacheMax = 256ULL * 1024 * 1024;  // ~3 x 20MP images
+
+    // Screen-resolution previews from GetPreviewAsync(). Same arbitrary-order eviction.
+    std::unordered_map<std::filesystem::path, Microsoft::WRL::ComPtr<ID2D1Bitmap>> previewCache_;
+    size_t previewCacheBytes_ = 0;
+    std::unordered_map<std::filesystem::path, std::pair<uint32_t, uint32_t>> sourceSizes_;
+
+    // Decoded tiles of tiled images, LRU by lastAccess
+    struct TileKey {
+        std::filesystem::path path;
+        int level = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        bool operator==(const TileKey&) const = default;
+    };
+    struct TileKeyHash {
+        size_t operator()(const TileKey& key) const noexcept;
+    };
+    struct TileEntry {
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+        size_t bytes = 0;
+        std::chrono::steady_clock::time_point lastAccess;
+    };
+    std::unordered_map<TileKey, TileEntry, TileKeyHash> tileCache_;
+    size_t tileCacheBytes_ = 0;
+    std::unordered_map<TileKey, bool, TileKeyHash> pendingTiles_;
     mutable std::mutex cacheMutex_;
 
     // --- Async thumbnail pipeline ---
@@ -177,6 +366,8 @@ private:
         std::unique_ptr<uint8_t[]> pixels;
         uint32_t width;
         uint32_t height;
+        int level = 0;
+        TraceTimeline trace;
     };
 
     // Ready queue: decoded pixel buffers waiting for GPU upload (deque for O(1) pop_front)
@@ -188,21 +379,190 @@ private:
         std::unique_ptr<uint8_t[]> pixels;
         uint32_t width = 0;
         uint32_t height = 0;
+        DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM;  // half floats for deep full-size decodes
         BitmapCallback callback;
+
+        // GetPreviewAsync() results; the callback stays in pendingPreviews_
+        bool isPreview = false;
+        uint32_t previewMaxDimension = 0;
+        uint64_t previewTicket = 0;
+        bool isFullResolution = false;
+        uint32_t sourceWidth = 0;
+        uint32_t sourceHeight = 0;
+
+        size_t reservedBytes = 0;  // admission_ reservation, released after upload
     };
     std::deque<ReadyBitmap> readyBitmapQueue_;
     mutable std::mutex readyBitmapMutex_;
 
+    struct ReadyTile {
+        TileKey key;
+        std::unique_ptr<uint8_t[]> pixels;  // null if cancelled or failed
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // One region decoder at a time: the image open in the viewer. It reads
+    // one tile at a time, so a single pool task drains the tile queue
+    // rather than parking a High worker per tile on the source's lock.
+    std::shared_ptr<TiledImageSource> tiledSource_;
+    std::filesystem::path tiledSourcePath_;
+    std::deque<ReadyTile> readyTiles_;
+    std::deque<std::pair<TileKey, uint64_t>> tileQueue_;  // (tile, open generation) awaiting the drainer
+    bool tileDrainerActive_ = false;
+    std::mutex tiledMutex_;  // guards the tiled members above; never held across a decode or file open
+
+    // Pool task: decode queued tiles until tileQueue_ is empty
+    void DrainTileQueue();
+
+    // Decode one tile through tiledSource_ (reopened on path change)
+    void TileDecodeTask(const TileKey& key, uint64_t openGeneration);
+
+    // A playing animation. While `decoding` is set a pool task owns decoder;
+    // ring and the flags are shared under mutex, the rest is UI thread only.
+    struct AnimationState {
+        std::mutex mutex;
+        std::unique_ptr<AnimationDecoder> decoder;
+        std::deque<AnimationFrame> ring;   // composited ahead, oldest first
+        bool decoding = false;
+        bool ended = false;                // played out or failed: last frame stays up
+        bool still = false;                // a single frame after all
+        uint32_t canvasEdge = 0;           // longest canvas edge, once opened
+        std::atomic<bool> cancelled = false;
+
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;  // frame on screen
+        uint32_t maxDimension = 0;
+        uint32_t delayMs = 0;
+        float elapsedMs = 0.0f;
+        bool requested = true;             // drawn since its frame went up
+        std::chrono::steady_clock::time_point lastRequest;
+    };
+    std::unordered_map<std::filesystem::path, std::shared_ptr<AnimationState>> animations_;
+    std::unordered_set<std::filesystem::path> stillImages_;  // GIF/WebP without animation
+
+    // Pool task: open the decoder on first run, then fill the ring
+    void AnimationDecodeTask(const std::shared_ptr<AnimationState>& state, const std::filesystem::path& path);
+    void ClearAnimations();
+
+    // Pages of the document open in the viewer (docPagesPath_), keyed by
+    // DocPageKey(). UI thread only except where noted.
+    struct DocPageEntry {
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+        uint32_t maxDimension = 0;   // box bitmap was decoded for
+        size_t bytes = 0;
+        bool pending = false;
+        bool failed = false;         // not re-queued
+    };
+    struct ReadyDocPage {
+        uint32_t page = 0;
+        bool thumbnail = false;
+        bool decoded = false;        // false when skipped (out of window, no memory)
+        std::unique_ptr<uint8_t[]> pixels;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t maxDimension = 0;
+        uint64_t generation = 0;
+        size_t reservedBytes = 0;    // admission_ reservation, released after upload
+    };
+    std::filesystem::path docPagesPath_;
+    std::unordered_map<uint64_t, DocPageEntry> docPages_;
+    size_t docPageBytes_ = 0;        // reported with the Preview tier
+    std::unordered_map<std::filesystem::path, uint32_t> docPageCounts_;
+    std::atomic<uint32_t> docPageCursor_{0};      // last RequestDocPage() page, read by tasks
+    std::atomic<uint64_t> docPagesGeneration_{0}; // bumped by ReleaseDocPages()
+    std::deque<ReadyDocPage> readyDocPages_;
+    std::mutex docPagesMutex_;       // guards readyDocPages_
+
+    // Switch to path's document and centre the resident window on page
+    void FocusDocPage(const std::filesystem::path& path, uint32_t page);
+
+    // Cached bitmap for a page (possibly decoded for a smaller box), queuing
+    // a decode when there's none or it's too small
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> LookupDocPage(uint32_t page, bool thumbnail, uint32_t maxDimension,
+                                                      TaskPriority priority);
+
+    // Pool task: decode one page unless it left the window meanwhile
+    void DocPageDecodeTask(const std::filesystem::path& path, uint32_t page, bool thumbnail,
+                           uint32_t maxDimension, uint64_t generation, TaskPriority priority);
+
     // Generation counter: incremented on InvalidateRequests()
     std::atomic<uint64_t> generation_{0};
 
+    // Incremented on CancelOpenRequests(); stale preview work is skipped
+    std::atomic<uint64_t> openGeneration_{0};
+
     // Track which paths have pending requests to avoid duplicate queuing
     // Protected by cacheMutex_
-    std::unordered_map<std::filesystem::path, uint64_t> pendingRequests_;
+    struct PendingThumb {
+        uint64_t generation = 0;
+        int level = 0;
+    };
+    std::unordered_map<std::filesystem::path, PendingThumb> pendingRequests_;
+
+    // --- Distance-ranked request scheduling ---
+    // Pool tasks don't carry a path; each one pops the currently best-ranked
+    // request, so re-ranking never resubmits work to the pool.
+    struct ThumbRequest {
+        std::filesystem::path path;
+        uint32_t targetSize = 0;
+        uint64_t generation = 0;
+        float distance = 0.0f;  // signed px from viewport centre
+        float score = 0.0f;     // lower = decoded sooner
+        TraceTimeline trace;
+    };
+    struct ThumbRequestLater {
+        bool operator()(const ThumbRequest& a, const ThumbRequest& b) const { return a.score > b.score; }
+    };
+    static float ScoreThumbRequest(float distance, int scrollDirection);
+
+    std::vector<ThumbRequest> schedQueue_;  // min-heap on score (ThumbRequestLater)
+    std::unordered_map<std::filesystem::path, float> schedUpdates_;  // new distances, applied per frame
+    int schedDirection_ = 0;
+    std::mutex schedMutex_;
 
     // Full-size async requests. Protected by cacheMutex_.
     std::unordered_map<std::filesystem::path, bool> pendingFullRequests_;
 
+    // GetPreviewAsync() decodes queued or running, one per (path, size), so
+    // a repeated request takes over the one in flight. ticket identifies the
+    // pool task that owns the entry; the callback and generation follow
+    // whoever asked last. Protected by cacheMutex_.
+    struct PreviewKey {
+        std::filesystem::path path;
+        uint32_t maxDimension = 0;
+        bool operator==(const PreviewKey&) const = default;
+    };
+    struct PreviewKeyHash {
+        size_t operator()(const PreviewKey& key) const noexcept;
+    };
+    struct PendingPreview {
+        uint64_t ticket = 0;
+        uint64_t openGeneration = 0;
+        TaskPriority priority = TaskPriority::Normal;
+        bool started = false;
+        PreviewCallback callback;
+    };
+    std::unordered_map<PreviewKey, PendingPreview, PreviewKeyHash> pendingPreviews_;
+    uint64_t nextPreviewTicket_ = 0;
+
+    // Duplicate path -> canonical path (see SetContentAliases)
+    std::unordered_map<std::filesystem::path, std::filesystem::path> contentAliases_;
+    mutable std::shared_mutex aliasMutex_;  // leaf lock: nothing is locked while holding it
+
+    // Scan probe results (see SetScannedSizes)
+    struct ScannedSize {
+        uint32_t width = 0;   // upright
+        uint32_t height = 0;
+        bool deep = false;    // over 8 bits per channel
+    };
+    std::unordered_map<std::filesystem::path, ScannedSize> scannedSizes_;
+    mutable std::shared_mutex scannedSizeMutex_;  // leaf lock
+    bool FindScannedSize(const std::filesystem::path& path, ScannedSize& size) const;
+
+    // Returns path, or its canonical copy (stored in storage) if it's a duplicate
+    const std::filesystem::path& ResolveAlias(const std::filesystem::path& path,
+                                              std::filesystem::path& storage) const;
+
     // Currently visible paths (for prioritization). Protected by cacheMutex_
     std::unordered_map<std::filesystem::path, bool> visiblePaths_;
 
@@ -210,11 +570,14 @@ private:
     void ClosePersistentMapping();
 
     struct PersistThumbInfo {
-        const uint8_t* pixelData;  // pointer into memory-mapped region
-        uint16_t width;
-        uint16_t height;
+        const uint8_t* pixelData = nullptr;  // pointer into memory-mapped region
+        uint16_t width = 0;
+        uint16_t height = 0;
     };
-    std::unordered_map<std::filesystem::path, PersistThumbInfo> persistIndex_;
+    struct PersistThumbSet {
+        PersistThumbInfo levels[kThumbnailLevelCount];  // pixelData == nullptr: level not stored
+    };
+    std::unordered_map<std::filesystem::path, PersistThumbSet> persistIndex_;
     void* persistFileH_ = nullptr;      // HANDLE, nullptr = not open
     void* persistMapH_ = nullptr;       // HANDLE
     const uint8_t* persistData_ = nullptr;
@@ -223,12 +586,16 @@ private:
 
     // Save buffer: raw pixels collected during FlushReadyThumbnails
     struct ThumbSaveEntry {
-        uint16_t width;
-        uint16_t height;
-        uint32_t pixelSize;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint32_t pixelSize = 0;
         std::unique_ptr<uint8_t[]> pixels;
     };
-    std::unordered_map<std::filesystem::path, ThumbSaveEntry> thumbSaveBuffer_;
+    struct ThumbSaveSet {
+        ThumbSaveEntry levels[kThumbnailLevelCount];
+    };
+    std::unordered_map<std::filesystem::path, ThumbSaveSet> thumbSaveBuffer_;
+    size_t thumbSaveBytes_ = 0;  // past MemoryTier::SaveBuffer only level 0 is kept
     std::mutex thumbSaveMutex_;
 
     // Per-frame budget for synchronous D2D bitmap creation from persistent cache
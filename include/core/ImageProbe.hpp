@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// What layout and decode admission need to know before any decode
+struct ImageProbeResult {
+    uint32_t width = 0;          // stored frame size (before EXIF orientation)
+    uint32_t height = 0;
+    uint16_t orientation = 1;    // EXIF 1..8
+    uint8_t bitDepth = 0;        // bits per channel
+    uint8_t channels = 0;        // stored channels (palette images count as 1)
+    int year = 0;                // EXIF DateTimeOriginal; 0 when absent
+    int month = 0;
+};
+
+enum class ProbeStatus {
+    Ok,
+    NeedMoreData,   // headers continue past the bytes given (e.g. a large EXIF block)
+    Unsupported     // unknown or malformed format
+};
+
+// Header-only probe of JPEG, PNG, GIF, BMP, TIFF and WebP from the first
+// bytes of a file. No decoding, no platform APIs.
+ProbeStatus ProbeImage(const uint8_t* data, size_t size, ImageProbeResult& out);
+
+// Reads kProbeHeadBytes of the file and probes them, re-reading up to
+// kProbeMaxBytes when the headers don't fit
+inline constexpr size_t kProbeHeadBytes = 8 * 1024;
+inline constexpr size_t kProbeMaxBytes = 128 * 1024;
+bool ProbeFile(const std::filesystem::path& path, ImageProbeResult& out);
+
+} // namespace Core
+} // namespace UltraImageViewer
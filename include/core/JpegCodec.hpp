@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ImageCodec.hpp"
+
+namespace UltraImageViewer {
+namespace Core {
+
+/**
+ * Native JPEG decoder: baseline and progressive Huffman, 8-bit, grayscale,
+ * YCbCr or RGB, whole-number sampling ratios up to 4, restart intervals.
+ * SSE2 IDCT (same arithmetic as libjpeg's islow) and colour conversion.
+ * With a maxDimension hint it decodes at 1/2, 1/4 or 1/8 scale in the DCT
+ * domain: the smallest scale still covering the box.
+ * Arithmetic coding, 12-bit, lossless and CMYK files are left to WIC.
+ */
+class JpegCodec : public ImageCodec {
+public:
+    const char* Name() const override { return "jpeg"; }
+    bool Matches(const uint8_t* data, size_t size) const override;
+    bool ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const override;
+    bool Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const override;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <Windows.h>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// Every cache that holds image memory. Order doubles as shed priority:
+// under pressure budgets collapse to their floor starting from the top.
+enum class MemoryTier : uint8_t {
+    DecodeCache = 0,    // CacheManager (decoded CPU images)
+    Tiles,              // tiled-image GPU tiles
+    Preview,            // viewer screen-resolution previews
+    FullImage,          // full-resolution GPU bitmaps
+    Tier2Compressed,    // compressed thumbnail pixels in RAM
+    SaveBuffer,         // thumbnail pixels waiting to be persisted
+    ThumbnailGpu,       // thumbnail GPU bitmaps (gallery)
+    Count
+};
+
+enum class MemoryPressure : uint8_t { Normal, Elevated, Critical };
+
+/**
+ * Process-wide memory budget shared by all cache tiers.
+ * Sizes the total from physical RAM, splits it between tiers by their
+ * marginal value (recent misses per MB held) and sheds tiers in MemoryTier
+ * order as system memory load rises.
+ */
+class MemoryGovernor {
+public:
+    MemoryGovernor();
+    ~MemoryGovernor();
+
+    // Re-read system memory state and rebalance. Cheap to call every frame:
+    // does real work at most every kUpdateInterval. Returns true if any
+    // budget shrank (callers should evict now).
+    bool Update();
+
+    size_t GetBudget(MemoryTier tier) const;
+    MemoryPressure GetPressure() const { return pressure_.load(std::memory_order_relaxed); }
+
+    // Counters feeding the rebalance (thread-safe, lock-free)
+    void RecordHit(MemoryTier tier);
+    void RecordMiss(MemoryTier tier);
+    void ReportUsage(MemoryTier tier, size_t bytes);
+
+private:
+    static constexpr size_t kTierCount = static_cast<size_t>(MemoryTier::Count);
+    static constexpr auto kUpdateInterval = std::chrono::milliseconds(500);
+
+    struct TierLimits {
+        size_t minBytes;
+        size_t maxBytes;
+        bool rebalance;  // share follows hit/miss traffic
+    };
+    static const std::array<TierLimits, kTierCount> kLimits;
+
+    struct TierState {
+        std::atomic<size_t> budget{0};
+        std::atomic<size_t> usage{0};
+        std::atomic<uint32_t> hits{0};
+        std::atomic<uint32_t> misses{0};
+        float share = 1.0f;        // relative claim on the slack above minBytes
+        float missRate = 0.0f;     // EWMA of misses per update window
+    };
+
+    MemoryPressure ReadPressure(uint64_t& totalPhys);
+    void Rebalance(size_t processBudget, MemoryPressure pressure);
+
+    std::array<TierState, kTierCount> tiers_;
+    std::atomic<MemoryPressure> pressure_{MemoryPressure::Normal};
+    std::chrono::steady_clock::time_point lastUpdate_;
+    HANDLE lowMemoryNotification_ = nullptr;
+    std::mutex updateMutex_;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// Points in a thumbnail request's life, in order. Events a request skips
+// (e.g. Decoded after a Tier 2 hit) stay 0.
+enum class TraceEvent : uint8_t {
+    Requested = 0,  // queued by RequestThumbnail()
+    Started,        // popped by a pool worker
+    Tier2Checked,   // compressed RAM cache looked up (and decompressed on hit)
+    Tier3Checked,   // persistent cache read attempted
+    Decoded,        // source image decoded
+    Ready,          // pixels pushed to the ready queue
+    UploadBegin,    // popped by FlushReadyThumbnails()
+    Uploaded,       // bitmap created and cached
+    Count
+};
+inline constexpr size_t kTraceEventCount = static_cast<size_t>(TraceEvent::Count);
+
+// Timestamps carried along with one request. id 0 = not traced.
+struct TraceTimeline {
+    uint64_t id = 0;
+    std::array<int64_t, kTraceEventCount> ns{};  // since the trace epoch
+    uint8_t level = 0;
+
+    explicit operator bool() const { return id != 0; }
+};
+
+/**
+ * Per-request stage timing for the thumbnail pipeline.
+ * Each stage (time from the previous recorded event to the next) feeds a
+ * log2 histogram; every Nth request also keeps its whole timeline for export
+ * as a Chrome trace (chrome://tracing, Perfetto). Disabled, Begin() returns
+ * an empty timeline and every Mark() is a single branch.
+ */
+class PipelineTrace {
+public:
+    PipelineTrace();
+
+    // sampleEvery: keep the full timeline of one request in this many (0 = none)
+    void SetEnabled(bool enabled, uint32_t sampleEvery = 64);
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    TraceTimeline Begin(uint8_t level);
+
+    void Mark(TraceTimeline& timeline, TraceEvent event) const
+    {
+        if (timeline) timeline.ns[static_cast<size_t>(event)] = NowNs();
+    }
+
+    // completed: the request ended in an upload (false: dropped or failed)
+    void Finish(const TraceTimeline& timeline, const std::filesystem::path& path, bool completed);
+
+    // Per-stage count / mean / p50 / p95 / p99 (bucket upper bounds)
+    std::string FormatHistograms() const;
+
+    // Sampled timelines as Chrome trace-event JSON
+    bool ExportTimelines(const std::filesystem::path& jsonPath) const;
+
+    void Reset();
+
+private:
+    static constexpr size_t kBuckets = 32;        // log2(us): bucket b holds [2^(b-1), 2^b) us
+    static constexpr size_t kMaxSamples = 4096;   // ring buffer of exported timelines
+
+    struct Histogram {
+        std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalUs{0};
+    };
+    // One per event after Requested (time spent reaching it), plus end-to-end
+    static constexpr size_t kStageCount = kTraceEventCount;
+
+    struct Sample {
+        TraceTimeline timeline;
+        std::filesystem::path path;
+        bool completed = false;
+    };
+
+    int64_t NowNs() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch_).count();
+    }
+    void Record(size_t stage, int64_t ns);
+
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint32_t> sampleEvery_{64};
+    std::atomic<uint64_t> nextId_{1};
+    std::atomic<uint64_t> dropped_{0};
+    std::array<Histogram, kStageCount> stages_;
+
+    std::vector<Sample> samples_;
+    size_t sampleNext_ = 0;
+    mutable std::mutex sampleMutex_;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
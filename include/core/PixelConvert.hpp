@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Core {
+namespace Simd {
+
+// Source pixel layouts with a kernel to premultiplied BGRA. Byte order as
+// named; 16-bit channels are little-endian (WIC's native order).
+enum class PixelLayout : uint8_t {
+    BGR24,
+    RGB24,
+    BGRA32,   // straight alpha
+    RGBA32,   // straight alpha
+    BGRX32,   // padding byte ignored
+    PBGRA32,  // already the target: plain copy
+    Gray8,
+    CMYK32,   // 0 = no ink
+    RGB48,
+    RGBA64,   // straight alpha
+    Gray16,
+};
+
+// Kernel tiers; every tier produces bit-identical output
+enum class SimdLevel : uint8_t { Scalar, SSE2, AVX2 };
+
+uint32_t BytesPerPixel(PixelLayout layout);
+
+// Highest tier this CPU runs (needs DetectFeatures first). The SSE2 tier
+// uses SSSE3 byte shuffles for the 24-bit layouts when SSE4.2 is present
+// and scalar code for them otherwise.
+SimdLevel MaxSimdLevel();
+
+// count pixels of src to premultiplied BGRA in dst (opaque layouts get
+// alpha 255). Straight alpha is premultiplied as (c * a + 127) / 255 and
+// 16-bit channels narrowed as round(v / 257). level is capped at
+// MaxSimdLevel(). src and dst must not overlap.
+void ConvertToPBGRA(PixelLayout layout, const uint8_t* src, uint8_t* dst, size_t count,
+                    SimdLevel level = SimdLevel::AVX2);
+
+// 16-bit samples to 8-bit, round(v / 257)
+void Narrow16To8(const uint16_t* src, uint8_t* dst, size_t count, SimdLevel level = SimdLevel::AVX2);
+
+// Curves from scene-linear light (scRGB: 1.0 = SDR white, HDR above it) to
+// the SDR range
+enum class ToneMapOperator : uint8_t {
+    Reinhard,  // x / (1 + x): never clips, flattens midtones
+    AcesFit,   // Narkowicz's fit of the ACES filmic curve: more contrast
+};
+
+// count pixels of premultiplied linear RGBA floats (WIC's 128bppPRGBAFloat)
+// to premultiplied sRGB BGRA: colour is unpremultiplied, scaled by exposure,
+// mapped per channel, sRGB encoded through a table and premultiplied again
+// as (c * a + 127) / 255. The SIMD tiers run 4 (SSE2) or 8 (AVX2) pixels per
+// step; float rounding may leave them one step off the scalar reference.
+void ToneMapToPBGRA(const float* src, uint8_t* dst, size_t count,
+                    ToneMapOperator op = ToneMapOperator::AcesFit, float exposure = 1.0f,
+                    SimdLevel level = SimdLevel::AVX2);
+
+} // namespace Simd
+} // namespace Core
+} // namespace UltraImageViewer
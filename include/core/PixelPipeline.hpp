@@ -0,0 +1,195 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "PixelConvert.hpp"
+#include "SimdUtils.hpp"
+
+namespace UltraImageViewer {
+namespace Core {
+
+/**
+ * Compile-time composed pixel pipeline: a load stage (swizzle from the source
+ * layout), any number of per-pixel ops, and the EXIF orientation folded into
+ * the store address, all in one pass over the source. Rotations walk the
+ * source in square tiles so both the reads and the transposed writes stay in
+ * cache. Pixels travel between stages packed as 0xAARRGGBB (BGRA in memory).
+ */
+namespace Fused {
+
+using Pixel = uint32_t;
+
+// ---- Load stages: kBytes per source pixel ----
+
+struct LoadPBGRA {
+    static constexpr uint32_t kBytes = 4;
+    static Pixel Load(const uint8_t* p)
+    {
+        Pixel v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+};
+
+// Straight alpha; pair with Premultiply
+struct LoadBGRA : LoadPBGRA {};
+
+struct LoadBGRX {
+    static constexpr uint32_t kBytes = 4;
+    static Pixel Load(const uint8_t* p) { return LoadPBGRA::Load(p) | 0xFF000000u; }
+};
+
+// Straight alpha; pair with Premultiply
+struct LoadRGBA {
+    static constexpr uint32_t kBytes = 4;
+    static Pixel Load(const uint8_t* p)
+    {
+        Pixel v = LoadPBGRA::Load(p);
+        return (v & 0xFF00FF00u) | ((v >> 16) & 0xFFu) | ((v & 0xFFu) << 16);
+    }
+};
+
+struct LoadBGR {
+    static constexpr uint32_t kBytes = 3;
+    static Pixel Load(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | 0xFF000000u; }
+};
+
+struct LoadRGB {
+    static constexpr uint32_t kBytes = 3;
+    static Pixel Load(const uint8_t* p) { return p[2] | (p[1] << 8) | (p[0] << 16) | 0xFF000000u; }
+};
+
+// ---- Per-pixel ops ----
+
+// Straight -> premultiplied alpha, (c * a + 127) / 255 like Simd::ConvertToPBGRA
+struct Premultiply {
+    static Pixel Apply(Pixel v)
+    {
+        const uint32_t a = v >> 24;
+        if (a == 255) return v;
+        Pixel out = a << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t t = ((v >> shift) & 0xFFu) * a + 128;
+            out |= ((t + (t >> 8)) >> 8) << shift;
+        }
+        return out;
+    }
+};
+
+template <class Load, class... Ops>
+class PixelPipeline {
+public:
+    static constexpr uint32_t kTile = 64;
+
+    // width x height source pixels, rows srcStride bytes apart (point src at
+    // a crop's first pixel to crop for free), into tightly packed BGRA turned
+    // upright per orientation (EXIF 1-8). dst rows are height pixels wide for
+    // orientations 5-8. src and dst must not overlap.
+    static void Run(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height,
+                    uint16_t orientation, uint8_t* dst)
+    {
+        auto* out = reinterpret_cast<Pixel*>(dst);
+        switch (orientation) {
+        case 2: RunOriented<2>(src, srcStride, width, height, out); break;
+        case 3: RunOriented<3>(src, srcStride, width, height, out); break;
+        case 4: RunOriented<4>(src, srcStride, width, height, out); break;
+        case 5: RunOriented<5>(src, srcStride, width, height, out); break;
+        case 6: RunOriented<6>(src, srcStride, width, height, out); break;
+        case 7: RunOriented<7>(src, srcStride, width, height, out); break;
+        case 8: RunOriented<8>(src, srcStride, width, height, out); break;
+        default: RunOriented<1>(src, srcStride, width, height, out); break;
+        }
+    }
+
+private:
+    // Output index of source pixel (x, y)
+    template <uint16_t O>
+    static size_t Target(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+    {
+        if constexpr (O == 1) return static_cast<size_t>(y) * w + x;
+        else if constexpr (O == 2) return static_cast<size_t>(y) * w + (w - 1 - x);               // mirror horizontal
+        else if constexpr (O == 3) return static_cast<size_t>(h - 1 - y) * w + (w - 1 - x);       // rotate 180
+        else if constexpr (O == 4) return static_cast<size_t>(h - 1 - y) * w + x;                 // mirror vertical
+        else if constexpr (O == 5) return static_cast<size_t>(x) * h + y;                         // transpose
+        else if constexpr (O == 6) return static_cast<size_t>(x) * h + (h - 1 - y);               // rotate 90 CW
+        else if constexpr (O == 7) return static_cast<size_t>(w - 1 - x) * h + (h - 1 - y);       // transverse
+        else return static_cast<size_t>(w - 1 - x) * h + y;                                       // rotate 90 CCW
+    }
+
+    template <uint16_t O>
+    static void RunOriented(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height, Pixel* out)
+    {
+        // Row order already matches the output unless the image turns sideways
+        const uint32_t tileW = O >= 5 ? kTile : width;
+        const uint32_t tileH = O >= 5 ? kTile : height;
+        for (uint32_t ty = 0; ty < height; ty += tileH) {
+            const uint32_t yEnd = std::min(height, ty + tileH);
+            for (uint32_t tx = 0; tx < width; tx += tileW) {
+                const uint32_t xEnd = std::min(width, tx + tileW);
+                for (uint32_t y = ty; y < yEnd; ++y) {
+                    const uint8_t* row = src + y * srcStride;
+                    for (uint32_t x = tx; x < xEnd; ++x) {
+                        Pixel p = Load::Load(row + static_cast<size_t>(x) * Load::kBytes);
+                        ((p = Ops::Apply(p)), ...);
+                        out[Target<O>(x, y, width, height)] = p;
+                    }
+                }
+            }
+        }
+    }
+};
+
+// The common paths, chosen at runtime by source layout
+using FromBGRX = PixelPipeline<LoadBGRX>;
+using FromBGR = PixelPipeline<LoadBGR>;                 // WIC JPEG output
+using FromRGB = PixelPipeline<LoadRGB>;
+using FromBGRA = PixelPipeline<LoadBGRA, Premultiply>;
+using FromRGBA = PixelPipeline<LoadRGBA, Premultiply>;  // WIC PNG output
+
+} // namespace Fused
+
+// Layouts ConvertOriented handles
+inline bool CanConvertOriented(Simd::PixelLayout layout)
+{
+    switch (layout) {
+    case Simd::PixelLayout::PBGRA32:
+    case Simd::PixelLayout::BGRX32:
+    case Simd::PixelLayout::BGR24:
+    case Simd::PixelLayout::RGB24:
+    case Simd::PixelLayout::BGRA32:
+    case Simd::PixelLayout::RGBA32:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Converts and orients in one pass (see Fused::PixelPipeline for the
+// arguments). Upright images take the per-row SIMD converters instead, which
+// are already a single pass; PBGRA sources take the SIMD orientation kernels
+// (a pure permutation, nothing to fuse). Returns false for layouts without a
+// fused loader, leaving dst untouched.
+inline bool ConvertOriented(Simd::PixelLayout layout, const uint8_t* src, size_t srcStride,
+                            uint32_t width, uint32_t height, uint16_t orientation, uint8_t* dst)
+{
+    if (orientation < 2 || orientation > 8) {
+        for (uint32_t y = 0; y < height; ++y) {
+            Simd::ConvertToPBGRA(layout, src + y * srcStride, dst + static_cast<size_t>(y) * width * 4, width);
+        }
+        return true;
+    }
+
+    switch (layout) {
+    case Simd::PixelLayout::PBGRA32: Simd::OrientBGRA(src, srcStride, width, height, orientation, dst); return true;
+    case Simd::PixelLayout::BGRX32:  Fused::FromBGRX::Run(src, srcStride, width, height, orientation, dst); return true;
+    case Simd::PixelLayout::BGR24:   Fused::FromBGR::Run(src, srcStride, width, height, orientation, dst); return true;
+    case Simd::PixelLayout::RGB24:   Fused::FromRGB::Run(src, srcStride, width, height, orientation, dst); return true;
+    case Simd::PixelLayout::BGRA32:  Fused::FromBGRA::Run(src, srcStride, width, height, orientation, dst); return true;
+    case Simd::PixelLayout::RGBA32:  Fused::FromRGBA::Run(src, srcStride, width, height, orientation, dst); return true;
+    default: return false;
+    }
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
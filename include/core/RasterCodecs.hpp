@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ImageCodec.hpp"
+
+namespace UltraImageViewer {
+namespace Core {
+
+/**
+ * BMP: BI_RGB 1/4/8/16/24/32-bit, BI_BITFIELDS 16/32-bit, top-down or
+ * bottom-up. RLE, embedded JPEG/PNG and OS/2 headers are left to WIC.
+ */
+class BmpCodec : public ImageCodec {
+public:
+    const char* Name() const override { return "bmp"; }
+    bool Matches(const uint8_t* data, size_t size) const override;
+    bool ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const override;
+    bool Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const override;
+};
+
+/**
+ * Uncompressed strip TIFF, both byte orders: 8-bit gray, RGB and RGBA
+ * (associated or unassociated alpha), chunky layout, first IFD only.
+ * Compressed, tiled, planar and high bit depth files are left to WIC.
+ */
+class TiffCodec : public ImageCodec {
+public:
+    const char* Name() const override { return "tiff"; }
+    bool Matches(const uint8_t* data, size_t size) const override;
+    bool ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const override;
+    bool Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const override;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Core {
+
+enum class ResampleFilter : uint8_t {
+    Auto,      // Area above 3x reduction, Lanczos3 otherwise (per axis)
+    Area,      // exact box coverage: cheap and alias-free for big reductions
+    Lanczos3,  // sharper for moderate reductions (and enlargements)
+};
+
+/**
+ * Separable resampler for tightly packed premultiplied BGRA.
+ * Filters in linear light: sRGB values are linearized (after unpremultiplying
+ * translucent pixels) and re-encoded on output, so downscaled highlights
+ * and fine detail keep their brightness. Filter passes use SSE.
+ * Output is processed in bands of rows; threads = 0 picks a worker count
+ * from the image size (1 for thumbnail-sized output). Extra workers run as
+ * tasks on the calling task's ThreadPool lane; called outside a pool task,
+ * the caller resamples alone.
+ */
+void ResampleBGRA(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                  uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight,
+                  ResampleFilter filter = ResampleFilter::Auto, uint32_t threads = 0);
+
+} // namespace Core
+} // namespace UltraImageViewer
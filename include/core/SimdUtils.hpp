@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <cstddef>
+#include <cstdint>
 
 namespace UltraImageViewer {
 namespace Core {
@@ -20,6 +21,17 @@ inline void ToLowerInPlace(std::wstring& s) {
     ToLowerInPlace(s.data(), s.size());
 }
 
+// Turns BGRA upright per an EXIF orientation (1-8; anything
+// else copies). src rows are srcStride bytes apart; dst is packed, with rows
+// height pixels wide for orientations 5-8. SSE2 4x4 transposes inside
+// cache-sized tiles for the sideways cases. src and dst must not overlap.
+void OrientBGRA(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height,
+                uint16_t orientation, uint8_t* dst);
+
+// CRC-32C (Castagnoli). SSE4.2 crc32 instruction when available, table
+// fallback otherwise; both give the same result. Chain calls via crc.
+uint32_t Crc32c(const uint8_t* data, size_t length, uint32_t crc = 0);
+
 } // namespace Simd
 } // namespace Core
 } // namespace UltraImageViewer
@@ -24,6 +24,9 @@ public:
     // Only meaningful inside a task callback. Returns -1 outside a task.
     static int CurrentLane() { return tl_currentLane_; }
 
+    // Pool running the calling thread's task, or nullptr outside a task.
+    static ThreadPool* Current() { return tl_currentPool_; }
+
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
 
@@ -83,6 +86,7 @@ private:
     std::atomic<bool> shutdown_{false};
 
     static thread_local int tl_currentLane_;
+    static thread_local ThreadPool* tl_currentPool_;
 };
 
 } // namespace Core
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <wrl/client.h>
+#include <wincodec.h>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// Tile edge (px) at every pyramid level
+inline constexpr uint32_t kTileSize = 256;
+
+/**
+ * Region decoder for images too large to hold as one bitmap.
+ * Level n of the pyramid is the source scaled by 1/2^n; tiles are
+ * kTileSize squares in that level's pixel space (edge tiles are clipped).
+ * Geometry is upright: with an EXIF orientation, each tile is read from the
+ * matching stored region and turned.
+ * Reads are serialized: WIC frames don't support concurrent CopyPixels.
+ */
+class TiledImageSource {
+public:
+    TiledImageSource(Microsoft::WRL::ComPtr<IWICImagingFactory2> factory,
+                     Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder,
+                     Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame,
+                     uint32_t width, uint32_t height, uint16_t orientation = 1);
+
+    uint32_t GetWidth() const { return width_; }
+    uint32_t GetHeight() const { return height_; }
+    int GetLevelCount() const { return levelCount_; }
+
+    // Decode one tile to tightly packed 32bpp PBGRA
+    bool ReadTile(int level, uint32_t tileX, uint32_t tileY,
+                  std::unique_ptr<uint8_t[]>& outPixels,
+                  uint32_t& outWidth, uint32_t& outHeight);
+
+    // Pyramid geometry, shared with the viewer's tile layout
+    static void LevelSize(uint32_t width, uint32_t height, int level,
+                          uint32_t& outWidth, uint32_t& outHeight);
+    static int LevelCountFor(uint32_t width, uint32_t height);
+
+private:
+    // PBGRA source for a level (scaler + converter built on first use)
+    IWICBitmapSource* LevelSource(int level);
+
+    Microsoft::WRL::ComPtr<IWICImagingFactory2> factory_;
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder_;
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame_;
+    std::vector<Microsoft::WRL::ComPtr<IWICBitmapSource>> levels_;
+    uint32_t width_ = 0;          // upright
+    uint32_t height_ = 0;
+    uint32_t storedWidth_ = 0;    // frame as stored
+    uint32_t storedHeight_ = 0;
+    uint16_t orientation_ = 1;
+    int levelCount_ = 1;
+    std::mutex mutex_;
+};
+
+} // namespace Core
+} // namespace UltraImageViewer
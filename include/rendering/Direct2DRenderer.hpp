@@ -10,6 +10,8 @@
 #include <filesystem>
 #include <functional>
 
+#include "TextureFactory.hpp"
+
 namespace UltraImageViewer {
 namespace Rendering {
 
@@ -23,7 +25,7 @@ using namespace Microsoft::WRL;
  * - Smooth zooming and panning
  * - Effect pipeline
  */
-class Direct2DRenderer {
+class Direct2DRenderer : public TextureFactory {
 public:
     Direct2DRenderer();
     ~Direct2DRenderer();
@@ -57,7 +59,7 @@ public:
         uint32_t height,
         const void* pixelData,
         DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM
-    );
+    ) override;
 
     ComPtr<ID2D1Bitmap1> CreateBitmapFromWIC(IWICBitmapSource* wicSource);
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "TextureFactory.hpp"
+#include <atomic>
+#include <memory>
+
+namespace UltraImageViewer {
+namespace Rendering {
+
+/**
+ * D2D-bound test double: an in-memory TextureFactory for headless runs
+ * (benchmarks, no window or GPU). It hand-implements ID2D1Bitmap, so it
+ * still builds only against the Windows SDK. Bitmaps it returns report
+ * their size and format like real D2D bitmaps but only hold a copy of the
+ * pixels; they can't be drawn, and methods that need a device fail.
+ */
+class NullTextureFactory : public TextureFactory {
+public:
+    // retainPixels: keep a CPU copy per bitmap so memory use resembles a
+    // real upload; false measures the pipeline without that cost.
+    explicit NullTextureFactory(bool retainPixels = true);
+
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> CreateBitmap(
+        uint32_t width,
+        uint32_t height,
+        const void* pixelData,
+        DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM
+    ) override;
+
+    // Shared with outstanding bitmaps, so it stays valid after the factory dies
+    struct Counters {
+        std::atomic<uint64_t> uploads{0};
+        std::atomic<uint64_t> uploadedBytes{0};
+        std::atomic<int64_t> liveBitmaps{0};
+        std::atomic<int64_t> liveBytes{0};
+        std::atomic<int64_t> peakLiveBytes{0};
+    };
+    const Counters& GetCounters() const { return *counters_; }
+
+private:
+    std::shared_ptr<Counters> counters_;
+    bool retainPixels_;
+};
+
+} // namespace Rendering
+} // namespace UltraImageViewer
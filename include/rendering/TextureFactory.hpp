@@ -0,0 +1,32 @@
+#pragma once
+
+#include <d2d1.h>
+#include <wrl/client.h>
+#include <cstdint>
+
+namespace UltraImageViewer {
+namespace Rendering {
+
+/**
+ * Where decoded pixels become textures. ImagePipeline only needs this one
+ * call from a renderer, so it depends on this interface rather than on
+ * Direct2DRenderer; NullTextureFactory stands in for headless runs.
+ *
+ * Not renderer-agnostic: the handle is still ID2D1Bitmap, so the pipeline
+ * and every implementation need d2d1.h and run on Windows only. This seam
+ * removes the window and GPU from tests, not the platform.
+ */
+class TextureFactory {
+public:
+    virtual ~TextureFactory() = default;
+
+    virtual Microsoft::WRL::ComPtr<ID2D1Bitmap> CreateBitmap(
+        uint32_t width,
+        uint32_t height,
+        const void* pixelData,
+        DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM
+    ) = 0;
+};
+
+} // namespace Rendering
+} // namespace UltraImageViewer
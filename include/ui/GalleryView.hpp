@@ -125,6 +125,15 @@ public:
     static std::wstring FormatNumber(size_t n);
 
 private:
+    // Thumbnail readiness when a scroll comes to rest (predictive prefetch
+    // metrics), logged once when the view goes away
+    struct ScrollPrefetchStats {
+        uint64_t stops = 0;           // scroll motions that came to rest
+        uint64_t predictedStops = 0;  // ... whose landing window was prefetched ahead
+        uint64_t visibleCells = 0;    // on-screen cells at rest
+        uint64_t readyCells = 0;      // ... with a thumbnail ready on the first rest frame
+        uint64_t marginCells = 0;     // ... inside the fixed PrefetchScreens margin at motion start
+    };
 
     GridLayout CalculateGridLayout(float viewWidth) const;
     AlbumGridLayout CalculateAlbumGridLayout(float viewWidth) const;
@@ -158,6 +167,21 @@ private:
     // Folder detail section layout helpers
     void ComputeFolderDetailSectionLayouts(const GridLayout& grid) const;
 
+    // No drag or scroll motion: on-screen cells may request the sharp thumbnail level
+    bool IsScrollSettled() const;
+
+    // Predictive prefetch: request the window where the active scroll will settle
+    float PredictScrollLanding(const Animation::SpringAnimation& spring, float maxScroll) const;
+    void PrefetchScrollLanding(const Animation::SpringAnimation& spring, float maxScroll,
+                               const GridLayout& grid,
+                               const std::vector<std::filesystem::path>& images,
+                               const std::vector<SectionLayoutInfo>& layouts,
+                               const std::vector<Section>& sections,
+                               float contentHeight, float dpiScale);
+    void RecordScrollStop(const Animation::SpringAnimation& spring,
+                          const std::vector<std::filesystem::path>& visiblePaths,
+                          float scroll, float contentHeight);
+
     // Tab state
     GalleryTab activeTab_ = GalleryTab::Photos;
 
@@ -263,6 +287,15 @@ private:
     // Fast-scroll detection
     float scrollVelocitySmoothed_ = 0.0f;
     bool isFastScrolling_ = false;
+    int scrollDirection_ = 0;  // +1 scrolling down, -1 up, 0 idle
+
+    // Scroll motion tracking (for landing prediction + hit-rate metrics)
+    const Animation::SpringAnimation* scrollMotionSpring_ = nullptr;
+    bool scrollMotionActive_ = false;
+    bool scrollStopPending_ = false;
+    bool scrollLandingPrefetched_ = false;
+    float scrollMotionStart_ = 0.0f;
+    ScrollPrefetchStats prefetchStats_;
 
     // Mouse hover
     float hoverX_ = -1.0f;
@@ -70,6 +70,25 @@ private:
     void LoadCurrentPage();
     void NavigateToPage(int direction);
 
+    // Staged open: cached thumbnail -> screen-resolution preview -> full
+    // resolution, the last only once zoom magnifies the preview.
+    enum class OpenStage { None, Thumbnail, Preview, Full };
+    void RequestFullResolutionIfNeeded();
+    uint32_t PreviewMaxPx() const;
+
+    // Draw the visible tiles of a tiled image over the preview at destRect
+    void RenderTiles(Rendering::Direct2DRenderer* renderer, const D2D1_RECT_F& destRect);
+
+    // Multi-page documents (TIFF, ICO): PageUp/PageDown or a click in the
+    // page strip along the bottom turn pages within the current image
+    void GoToDocPage(uint32_t page);
+    void RenderDocPageStrip(Rendering::Direct2DRenderer* renderer, float alpha);
+    D2D1_RECT_F DocPageCellRect(uint32_t page) const;
+    int DocPageAt(float x, float y) const;  // strip cell under a point, -1 for none
+
+    // What the current image shows: the open document page, else currentBitmap_
+    ID2D1Bitmap* DisplayedBitmap() const;
+
     // Image data
     std::vector<std::filesystem::path> images_;
     size_t currentIndex_ = 0;
@@ -78,6 +97,17 @@ private:
     Microsoft::WRL::ComPtr<ID2D1Bitmap> currentBitmap_;
     Microsoft::WRL::ComPtr<ID2D1Bitmap> prevBitmap_;
     Microsoft::WRL::ComPtr<ID2D1Bitmap> nextBitmap_;
+    OpenStage currentStage_ = OpenStage::None;
+    bool pageRequested_ = false;   // LoadCurrentPage() issued for currentIndex_
+    bool fullRequested_ = false;
+    bool currentTiled_ = false;    // too large for one bitmap: zoom renders tiles
+    uint32_t sourceWidth_ = 0;
+    uint32_t sourceHeight_ = 0;
+
+    // Document pages of the current image (page 0 is the staged open's)
+    uint32_t docPageCount_ = 1;
+    uint32_t currentDocPage_ = 0;
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> docPageBitmap_;  // last page > 0 shown, up while the next decodes
 
     // Horizontal paging
     Animation::SpringAnimation pageOffsetX_;
@@ -120,6 +150,7 @@ private:
     // View dimensions
     float viewWidth_ = 1280.0f;
     float viewHeight_ = 720.0f;
+    float dpiScale_ = 1.0f;
 
     // Callback
     DismissCallback dismissCallback_;
@@ -132,6 +163,7 @@ private:
     Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> bgBrush_;
     Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> overlayTextBrush_;
     Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> overlayBgBrush_;
+    Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> accentBrush_;
     Microsoft::WRL::ComPtr<IDWriteTextFormat> counterFormat_;
     Microsoft::WRL::ComPtr<IDWriteTextFormat> filenameFormat_;
     bool resourcesCreated_ = false;
@@ -95,9 +95,18 @@ namespace Theme {
     constexpr int MaxBitmapsPerFrame = 64;               // max GPU uploads (D2D bitmap creation) per frame
     constexpr int PersistSyncBudgetPerFrame = 200;       // max synchronous disk→GPU loads per frame
     constexpr int ThumbnailWorkerThreads = 4;            // background decode threads
-    constexpr size_t ThumbnailCacheMaxBytes = 1024ULL * 1024 * 1024;  // 1GB LRU eviction threshold
-    constexpr uint32_t ThumbnailMaxPx = 160;                         // max thumbnail decode resolution (px)
+    constexpr size_t ThumbnailCacheMaxBytes = 1024ULL * 1024 * 1024;  // 1GB ceiling; MemoryGovernor sets the live LRU budget
+    constexpr uint32_t ThumbnailMaxPx = 320;             // sharp ladder level: on-screen cells once scrolling settles (px)
+    constexpr uint32_t ThumbnailScrollPx = 160;          // max level requested while scrolling and for prefetch (px)
     constexpr float PrefetchScreens = 3.0f;              // prefetch N screens above/below viewport
+    constexpr float ThumbnailBehindScrollPenalty = 3.0f; // distance multiplier for cells behind the scroll direction
+    constexpr float LandingPrefetchScreens = 0.5f;       // extra screens around a predicted scroll landing to prefetch
+    constexpr uint32_t TiledImageMinEdge = 8192;        // longest edge (px) above which the viewer zooms through tiles
+    constexpr size_t TileCacheMaxBytes = 192ULL * 1024 * 1024;  // decoded tile LRU ceiling (MemoryGovernor)
+    constexpr int MaxTilesPerFrame = 16;                 // max tile uploads per viewer frame
+    constexpr int MaxDocPagesPerFrame = 4;               // max document page uploads per viewer frame
+    constexpr uint32_t DocPageStripRadius = 6;           // pages either side of the current one in the page strip
+    constexpr float DocPageStripCell = 56.0f;            // page strip cell edge (DIP)
     constexpr float ContentBudgetMs = 12.0f;              // max ms for content rendering (reserves time for glass overlays)
     constexpr int BudgetCheckInterval = 16;                // check budget every N cells (amortize QueryPerformanceCounter)
 
@@ -69,6 +69,7 @@ private:
 
     Animation::AnimationEngine* animEngine_ = nullptr;
     Core::ImagePipeline* pipeline_ = nullptr;
+    uint32_t frameClockId_ = 0;  // animated images, ticked by animEngine_
 
     float viewWidth_ = 1280.0f;
     float viewHeight_ = 720.0f;
@@ -26,10 +26,20 @@ void AnimationEngine::Update(float deltaTime)
             ++it;
         }
     }
+
+    frameTicked_ = false;
+    for (auto& clock : clocks_) {
+        if (clock.onTick(deltaTime)) {
+            frameTicked_ = true;
+        }
+    }
 }
 
 bool AnimationEngine::HasActiveAnimations() const
 {
+    if (frameTicked_) {
+        return true;
+    }
     for (const auto& ms : springs_) {
         if (!ms.animation->IsFinished()) {
             return true;
@@ -70,6 +80,22 @@ void AnimationEngine::AnimateValue(float from, float to, const SpringConfig& con
     springs_.push_back(std::move(ms));
 }
 
+uint32_t AnimationEngine::AddFrameClock(TickCallback onTick)
+{
+    uint32_t id = nextClockId_++;
+    clocks_.push_back({id, std::move(onTick)});
+    return id;
+}
+
+void AnimationEngine::RemoveFrameClock(uint32_t id)
+{
+    clocks_.erase(
+        std::remove_if(clocks_.begin(), clocks_.end(),
+            [id](const FrameClock& clock) { return clock.id == id; }),
+        clocks_.end()
+    );
+}
+
 void AnimationEngine::Clear()
 {
     springs_.clear();
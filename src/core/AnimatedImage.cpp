@@ -0,0 +1,368 @@
+#include "core/AnimatedImage.hpp"
+#include "core/MemoryManager.hpp"
+#include "core/Resampler.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+// Larger canvases are shown as stills (an 8K canvas is already 256 MB of
+// canvas plus saved copy)
+constexpr uint32_t kMaxCanvasEdge = 8192;
+
+// Delays under 20 ms play at 100 ms, as browsers do: such files were
+// authored against that behaviour
+constexpr uint32_t kMinDelayMs = 20;
+constexpr uint32_t kDefaultDelayMs = 100;
+
+inline uint16_t LE16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t LE24(const uint8_t* p) { return p[0] | (p[1] << 8) | (static_cast<uint32_t>(p[2]) << 16); }
+inline uint32_t LE32(const uint8_t* p) { return LE24(p) | (static_cast<uint32_t>(p[3]) << 24); }
+
+inline void PutLE24(uint8_t* p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+}
+
+inline void PutLE32(uint8_t* p, uint32_t v)
+{
+    PutLE24(p, v);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+uint32_t FrameDelay(uint32_t ms)
+{
+    return ms < kMinDelayMs ? kDefaultDelayMs : ms;
+}
+
+// Unsigned integer metadata item (fallback when absent or of another type)
+uint32_t ReadMetadataUInt(IWICMetadataQueryReader* reader, const wchar_t* name, uint32_t fallback)
+{
+    PROPVARIANT value;
+    PropVariantInit(&value);
+    uint32_t result = fallback;
+    if (SUCCEEDED(reader->GetMetadataByName(name, &value))) {
+        if (value.vt == VT_UI1) result = value.bVal;
+        else if (value.vt == VT_UI2) result = value.uiVal;
+        else if (value.vt == VT_UI4) result = value.ulVal;
+    }
+    PropVariantClear(&value);
+    return result;
+}
+
+// Byte-vector metadata item (GIF application extensions)
+bool ReadMetadataBytes(IWICMetadataQueryReader* reader, const wchar_t* name, std::vector<uint8_t>& bytes)
+{
+    PROPVARIANT value;
+    PropVariantInit(&value);
+    bool ok = false;
+    if (SUCCEEDED(reader->GetMetadataByName(name, &value)) && value.vt == (VT_VECTOR | VT_UI1)) {
+        bytes.assign(value.caub.pElems, value.caub.pElems + value.caub.cElems);
+        ok = true;
+    }
+    PropVariantClear(&value);
+    return ok;
+}
+
+// Whole of source as tightly packed PBGRA
+bool CopyPBGRA(IWICImagingFactory2* factory, IWICBitmapSource* source,
+               uint32_t width, uint32_t height, std::vector<uint8_t>& pixels)
+{
+    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+    if (FAILED(factory->CreateFormatConverter(&converter)) ||
+        FAILED(converter->Initialize(source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone,
+                                     nullptr, 0.0, WICBitmapPaletteTypeCustom))) {
+        return false;
+    }
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+    return SUCCEEDED(converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(pixels.size()), pixels.data()));
+}
+
+} // namespace
+
+AnimationDecoder::~AnimationDecoder() = default;
+
+std::unique_ptr<AnimationDecoder> AnimationDecoder::Open(IWICImagingFactory2* factory,
+                                                         const std::filesystem::path& filePath,
+                                                         uint32_t maxDimension)
+{
+    if (!factory) return nullptr;
+
+    std::unique_ptr<AnimationDecoder> anim(new AnimationDecoder());
+    anim->factory_ = factory;
+    anim->file_ = std::make_unique<MemoryMappedFile>(filePath);
+    if (!anim->file_->Map() || anim->file_->GetSize() < 16 || anim->file_->GetSize() > MAXDWORD) {
+        return nullptr;
+    }
+
+    const uint8_t* data = anim->file_->GetData();
+    bool opened = false;
+    if (std::memcmp(data, "GIF87a", 6) == 0 || std::memcmp(data, "GIF89a", 6) == 0) {
+        opened = anim->OpenGif();
+    } else if (std::memcmp(data, "RIFF", 4) == 0 && std::memcmp(data + 8, "WEBP", 4) == 0) {
+        opened = anim->OpenWebp();
+    }
+    if (!opened || anim->frames_.size() < 2) return nullptr;
+
+    const uint32_t cw = anim->canvasWidth_;
+    const uint32_t ch = anim->canvasHeight_;
+    if (cw == 0 || ch == 0 || cw > kMaxCanvasEdge || ch > kMaxCanvasEdge) return nullptr;
+    anim->canvas_.assign(static_cast<size_t>(cw) * ch * 4, 0);
+
+    // Fit the canvas within maxDimension, never upscaled
+    anim->outWidth_ = cw;
+    anim->outHeight_ = ch;
+    if (maxDimension > 0 && std::max(cw, ch) > maxDimension) {
+        if (cw >= ch) {
+            anim->outWidth_ = maxDimension;
+            anim->outHeight_ = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(ch) * maxDimension / cw));
+        } else {
+            anim->outHeight_ = maxDimension;
+            anim->outWidth_ = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(cw) * maxDimension / ch));
+        }
+    }
+    return anim;
+}
+
+bool AnimationDecoder::OpenGif()
+{
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    if (FAILED(factory_->CreateStream(&stream)) ||
+        FAILED(stream->InitializeFromMemory(const_cast<BYTE*>(file_->GetData()), static_cast<DWORD>(file_->GetSize()))) ||
+        FAILED(factory_->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &gifDecoder_))) {
+        return false;
+    }
+
+    UINT count = 0;
+    if (FAILED(gifDecoder_->GetFrameCount(&count)) || count < 2) return false;
+
+    // Logical screen and the NETSCAPE2.0 loop count. Without the extension a
+    // GIF plays once; with it, browsers play the count plus one times.
+    const uint8_t* data = file_->GetData();
+    canvasWidth_ = LE16(data + 6);
+    canvasHeight_ = LE16(data + 8);
+    playCount_ = 1;
+    Microsoft::WRL::ComPtr<IWICMetadataQueryReader> meta;
+    if (SUCCEEDED(gifDecoder_->GetMetadataQueryReader(&meta))) {
+        std::vector<uint8_t> app, ext;
+        if (ReadMetadataBytes(meta.Get(), L"/appext/application", app) && app.size() == 11 &&
+            (std::memcmp(app.data(), "NETSCAPE2.0", 11) == 0 || std::memcmp(app.data(), "ANIMEXTS1.0", 11) == 0) &&
+            ReadMetadataBytes(meta.Get(), L"/appext/data", ext) && ext.size() >= 4 && ext[0] >= 3 && ext[1] == 1) {
+            uint32_t loops = LE16(ext.data() + 2);
+            playCount_ = loops == 0 ? 0 : loops + 1;
+        }
+    }
+
+    // Per-frame placement and timing are read with each frame
+    frames_.resize(count);
+    return true;
+}
+
+bool AnimationDecoder::OpenWebp()
+{
+    const uint8_t* data = file_->GetData();
+    const size_t end = std::min<size_t>(file_->GetSize(), static_cast<size_t>(LE32(data + 4)) + 8);
+
+    // Walk the top-level chunks: VP8X (canvas + animation flag), ANIM (loop
+    // count), then one ANMF per frame. Only chunk headers are touched.
+    bool animated = false;
+    size_t pos = 12;
+    while (pos + 8 <= end) {
+        const uint8_t* chunk = data + pos;
+        const size_t length = LE32(chunk + 4);
+        const size_t payload = pos + 8;
+        if (length > end - payload) break;  // truncated: keep the frames so far
+        const uint8_t* p = data + payload;
+
+        if (std::memcmp(chunk, "VP8X", 4) == 0 && length >= 10) {
+            animated = (p[0] & 0x02) != 0;
+            canvasWidth_ = LE24(p + 4) + 1;
+            canvasHeight_ = LE24(p + 7) + 1;
+        } else if (std::memcmp(chunk, "ANIM", 4) == 0 && length >= 6) {
+            playCount_ = LE16(p + 4);  // 0 = forever
+        } else if (std::memcmp(chunk, "ANMF", 4) == 0 && length > 16) {
+            FrameInfo frame;
+            frame.x = LE24(p) * 2;
+            frame.y = LE24(p + 3) * 2;
+            frame.width = LE24(p + 6) + 1;
+            frame.height = LE24(p + 9) + 1;
+            frame.delayMs = FrameDelay(LE24(p + 12));
+            frame.blend = (p[15] & 0x02) == 0;
+            frame.disposal = (p[15] & 0x01) ? Disposal::Background : Disposal::Keep;
+            frame.offset = payload + 16;
+            frame.length = length - 16;
+            frames_.push_back(frame);
+        }
+        pos = payload + length + (length & 1);
+    }
+    return animated;
+}
+
+bool AnimationDecoder::ReadGifFrame(uint32_t index)
+{
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    if (FAILED(gifDecoder_->GetFrame(index, &frame))) return false;
+
+    UINT width = 0, height = 0;
+    if (FAILED(frame->GetSize(&width, &height)) || width == 0 || height == 0) return false;
+
+    FrameInfo& info = frames_[index];
+    info.width = width;
+    info.height = height;
+    info.delayMs = kDefaultDelayMs;
+    Microsoft::WRL::ComPtr<IWICMetadataQueryReader> meta;
+    if (SUCCEEDED(frame->GetMetadataQueryReader(&meta))) {
+        info.x = ReadMetadataUInt(meta.Get(), L"/imgdesc/Left", 0);
+        info.y = ReadMetadataUInt(meta.Get(), L"/imgdesc/Top", 0);
+        info.delayMs = FrameDelay(ReadMetadataUInt(meta.Get(), L"/grctlext/Delay", 0) * 10);
+        switch (ReadMetadataUInt(meta.Get(), L"/grctlext/Disposal", 0)) {
+        case 2: info.disposal = Disposal::Background; break;
+        case 3: info.disposal = Disposal::Previous; break;
+        default: info.disposal = Disposal::Keep; break;
+        }
+    }
+    // Transparent palette entries come through the converter as alpha 0
+    info.blend = true;
+    return CopyPBGRA(factory_.Get(), frame.Get(), width, height, framePixels_);
+}
+
+bool AnimationDecoder::ReadWebpFrame(uint32_t index)
+{
+    FrameInfo& info = frames_[index];
+    const uint8_t* data = file_->GetData() + info.offset;
+
+    // Wrap the frame's chunks as a still WebP. An ALPH chunk needs a VP8X
+    // header with the alpha flag in front of it.
+    bool hasAlpha = false;
+    for (size_t pos = 0; pos + 8 <= info.length; ) {
+        const size_t length = LE32(data + pos + 4);
+        if (std::memcmp(data + pos, "ALPH", 4) == 0) hasAlpha = true;
+        if (length > info.length - pos - 8) break;
+        pos += 8 + length + (length & 1);
+    }
+
+    const size_t header = 12 + (hasAlpha ? 18 : 0);
+    bitstream_.resize(header + info.length);
+    uint8_t* out = bitstream_.data();
+    std::memcpy(out, "RIFF", 4);
+    PutLE32(out + 4, static_cast<uint32_t>(bitstream_.size() - 8));
+    std::memcpy(out + 8, "WEBP", 4);
+    if (hasAlpha) {
+        std::memcpy(out + 12, "VP8X", 4);
+        PutLE32(out + 16, 10);
+        PutLE32(out + 20, 0x10);
+        PutLE24(out + 24, info.width - 1);
+        PutLE24(out + 27, info.height - 1);
+    }
+    std::memcpy(out + header, data, info.length);
+
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    if (FAILED(factory_->CreateStream(&stream)) ||
+        FAILED(stream->InitializeFromMemory(bitstream_.data(), static_cast<DWORD>(bitstream_.size()))) ||
+        FAILED(factory_->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder)) ||
+        FAILED(decoder->GetFrame(0, &frame))) {
+        return false;
+    }
+
+    // The bitstream's own size wins over the ANMF header's if they disagree
+    UINT width = 0, height = 0;
+    if (FAILED(frame->GetSize(&width, &height)) || width == 0 || height == 0) return false;
+    info.width = width;
+    info.height = height;
+    return CopyPBGRA(factory_.Get(), frame.Get(), width, height, framePixels_);
+}
+
+void AnimationDecoder::ClearRect(const FrameInfo& frame)
+{
+    if (frame.x >= canvasWidth_ || frame.y >= canvasHeight_) return;
+    const uint32_t w = std::min(frame.width, canvasWidth_ - frame.x);
+    const uint32_t h = std::min(frame.height, canvasHeight_ - frame.y);
+    for (uint32_t y = 0; y < h; ++y) {
+        uint8_t* dst = canvas_.data() + ((static_cast<size_t>(frame.y) + y) * canvasWidth_ + frame.x) * 4;
+        std::memset(dst, 0, static_cast<size_t>(w) * 4);
+    }
+}
+
+void AnimationDecoder::Composite(const FrameInfo& frame, const uint8_t* pixels)
+{
+    if (frame.x >= canvasWidth_ || frame.y >= canvasHeight_) return;
+    const uint32_t w = std::min(frame.width, canvasWidth_ - frame.x);
+    const uint32_t h = std::min(frame.height, canvasHeight_ - frame.y);
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t* src = pixels + static_cast<size_t>(y) * frame.width * 4;
+        uint8_t* dst = canvas_.data() + ((static_cast<size_t>(frame.y) + y) * canvasWidth_ + frame.x) * 4;
+        if (!frame.blend) {
+            std::memcpy(dst, src, static_cast<size_t>(w) * 4);
+            continue;
+        }
+        // Premultiplied source-over; GIF pixels are all-or-nothing
+        for (uint32_t x = 0; x < w; ++x, src += 4, dst += 4) {
+            const uint32_t a = src[3];
+            if (a == 255) {
+                std::memcpy(dst, src, 4);
+            } else if (a != 0) {
+                const uint32_t keep = 255 - a;
+                for (int c = 0; c < 4; ++c) {
+                    uint32_t t = dst[c] * keep + 128;
+                    dst[c] = static_cast<uint8_t>(src[c] + ((t + (t >> 8)) >> 8));
+                }
+            }
+        }
+    }
+}
+
+bool AnimationDecoder::DecodeNext(AnimationFrame& out)
+{
+    if (frames_.empty()) return false;
+
+    if (next_ == 0) {
+        if (playCount_ != 0 && loopsPlayed_ >= playCount_) return false;
+        std::fill(canvas_.begin(), canvas_.end(), 0);
+    } else {
+        // Dispose of the frame on screen before drawing over it
+        const FrameInfo& prev = frames_[next_ - 1];
+        if (prev.disposal == Disposal::Background) {
+            ClearRect(prev);
+        } else if (prev.disposal == Disposal::Previous && saved_.size() == canvas_.size()) {
+            canvas_.swap(saved_);
+        }
+    }
+
+    const bool read = gifDecoder_ ? ReadGifFrame(next_) : ReadWebpFrame(next_);
+    if (!read) return false;
+
+    const FrameInfo& frame = frames_[next_];
+    if (frame.disposal == Disposal::Previous) {
+        saved_ = canvas_;
+    }
+    Composite(frame, framePixels_.data());
+
+    const size_t bytes = static_cast<size_t>(outWidth_) * outHeight_ * 4;
+    out.pixels = std::make_unique_for_overwrite<uint8_t[]>(bytes);
+    out.width = outWidth_;
+    out.height = outHeight_;
+    out.delayMs = frame.delayMs;
+    if (outWidth_ == canvasWidth_ && outHeight_ == canvasHeight_) {
+        std::memcpy(out.pixels.get(), canvas_.data(), bytes);
+    } else {
+        // One frame is small; the pool already runs other animations in parallel
+        ResampleBGRA(canvas_.data(), canvasWidth_, canvasHeight_, out.pixels.get(), outWidth_, outHeight_,
+                     ResampleFilter::Auto, 1);
+    }
+
+    if (++next_ == frames_.size()) {
+        next_ = 0;
+        ++loopsPlayed_;
+    }
+    return true;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
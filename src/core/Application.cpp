@@ -225,6 +225,7 @@ int Application::Run(int nCmdShow)
         if (pipeline_ && pipeline_->FlushReadyBitmaps(2) > 0) {
             needsRender_ = true;
         }
+        if (pipeline_) pipeline_->UpdateMemoryBudgets();
 
         // Render only when needed
         bool hasAnimations = animEngine_ && animEngine_->HasActiveAnimations();
@@ -337,9 +338,12 @@ void Application::StartFullScan()
         SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
 
         try {
+            // Header probes from the last scan are reused for unchanged files
+            auto known = LoadScanCache();
+
             // No intermediate flush — gallery is frozen during scan, one-shot rebuild at end
             auto results = ImagePipeline::ScanFolders(
-                folders, scanCancelled_, scanProgress_, nullptr);
+                folders, scanCancelled_, scanProgress_, nullptr, &known);
 
             DebugLog(("Scan found " + std::to_string(results.size()) + " images").c_str());
 
@@ -958,8 +962,11 @@ std::vector<std::filesystem::path> Application::ShowOpenDialog()
     buffer[0] = L'\0';
 
     const wchar_t filter[] =
-        L"Image Files (*.jpg;*.jpeg;*.png;*.bmp;*.gif;*.tif;*.tiff;*.webp;*.ico;*.jxr)\0"
-        L"*.jpg;*.jpeg;*.png;*.bmp;*.gif;*.tif;*.tiff;*.webp;*.ico;*.jxr\0"
+        L"Image Files (*.jpg;*.jpeg;*.png;*.bmp;*.gif;*.tif;*.tiff;*.webp;*.ico;*.jxr;RAW)\0"
+        L"*.jpg;*.jpeg;*.png;*.bmp;*.gif;*.tif;*.tiff;*.webp;*.ico;*.jxr;"
+        L"*.cr2;*.nef;*.nrw;*.arw;*.dng;*.pef;*.srw\0"
+        L"Camera RAW (*.cr2;*.nef;*.nrw;*.arw;*.dng;*.pef;*.srw)\0"
+        L"*.cr2;*.nef;*.nrw;*.arw;*.dng;*.pef;*.srw\0"
         L"All Files (*.*)\0*.*\0";
 
     OPENFILENAMEW ofn = {};
@@ -1293,12 +1300,15 @@ void Application::SaveScanCache(const std::vector<ScannedImage>& results)
     try {
         // Binary layout:
         //   Header (32 bytes): magic(4) + version(4) + entry_count(4) + string_blob_size(4) + timestamp(8) + reserved(8)
-        //   Entry table (entry_count * 12 bytes): path_offset(4) + path_len(2) + year(2) + month(2) + reserved(2)
+        //   Entry table (entry_count * 44 bytes): path_offset(4) + path_len(2) + year(2) + month(2)
+        //                                         + orientation(1) + bit_depth(1) + content_id(8)
+        //                                         + width(4) + height(4) + file_size(8) + modified(8)
+        //                                         [version 3; version 2 entries are 20 bytes, version 1 are 12]
         //   String blob (string_blob_size bytes): packed wchar_t path strings
 
         const uint32_t entryCount = static_cast<uint32_t>(results.size());
         constexpr uint32_t kHeaderSize = 32;
-        constexpr uint32_t kEntrySize = 12;
+        constexpr uint32_t kEntrySize = 44;
 
         // Build entry table and string blob
         std::vector<uint8_t> entryTable(entryCount * kEntrySize);
@@ -1323,8 +1333,13 @@ void Application::SaveScanCache(const std::vector<ScannedImage>& results)
             int16_t month = static_cast<int16_t>(img.month);
             memcpy(entry + 6, &year, 2);
             memcpy(entry + 8, &month, 2);
-            uint16_t reserved = 0;
-            memcpy(entry + 10, &reserved, 2);
+            entry[10] = static_cast<uint8_t>(img.orientation);
+            entry[11] = img.bitDepth;
+            memcpy(entry + 12, &img.contentId, 8);
+            memcpy(entry + 20, &img.width, 4);
+            memcpy(entry + 24, &img.height, 4);
+            memcpy(entry + 28, &img.fileSize, 8);
+            memcpy(entry + 36, &img.modified, 8);
         }
 
         uint32_t stringBlobSize = static_cast<uint32_t>(stringBlob.size());
@@ -1332,7 +1347,7 @@ void Application::SaveScanCache(const std::vector<ScannedImage>& results)
         // Build header
         uint8_t header[kHeaderSize] = {};
         memcpy(header + 0, "UIVC", 4);                         // magic
-        uint32_t version = 1;
+        uint32_t version = 3;
         memcpy(header + 4, &version, 4);                        // version
         memcpy(header + 8, &entryCount, 4);                     // entry_count
         memcpy(header + 12, &stringBlobSize, 4);                // string_blob_size
@@ -1374,7 +1389,6 @@ std::vector<ScannedImage> Application::LoadScanCache()
         _fseeki64(f, 0, SEEK_SET);
 
         constexpr uint32_t kHeaderSize = 32;
-        constexpr uint32_t kEntrySize = 12;
 
         if (fileSize < kHeaderSize) { fclose(f); return results; }
 
@@ -1390,7 +1404,8 @@ std::vector<ScannedImage> Application::LoadScanCache()
 
         uint32_t version, entryCount, stringBlobSize;
         memcpy(&version, buf.data() + 4, 4);
-        if (version != 1) return results;  // unsupported version
+        if (version < 1 || version > 3) return results;  // unsupported version
+        const uint32_t kEntrySize = (version == 1) ? 12 : (version == 2) ? 20 : 44;
 
         memcpy(&entryCount, buf.data() + 8, 4);
         memcpy(&stringBlobSize, buf.data() + 12, 4);
@@ -1426,6 +1441,17 @@ std::vector<ScannedImage> Application::LoadScanCache()
             img.path = std::wstring(pathChars, pathLen);
             img.year = year;
             img.month = month;
+            if (version >= 2) {
+                memcpy(&img.contentId, entry + 12, 8);
+            }
+            if (version >= 3) {
+                img.orientation = entry[10];
+                img.bitDepth = entry[11];
+                memcpy(&img.width, entry + 20, 4);
+                memcpy(&img.height, entry + 24, 4);
+                memcpy(&img.fileSize, entry + 28, 8);
+                memcpy(&img.modified, entry + 36, 8);
+            }
             results.push_back(std::move(img));
         }
 
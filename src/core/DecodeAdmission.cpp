@@ -0,0 +1,73 @@
+#include "core/DecodeAdmission.hpp"
+#include <algorithm>
+
+namespace UltraImageViewer {
+namespace Core {
+
+DecodeAdmission::DecodeAdmission(size_t capacityBytes)
+    : capacity_(capacityBytes)
+{
+}
+
+bool DecodeAdmission::Acquire(size_t bytes)
+{
+    if (bytes == 0) return true;
+
+    std::unique_lock lock(mutex_);
+    ++waiters_;
+    cv_.wait(lock, [&] { return shutdown_ || FitsLocked(bytes); });
+    --waiters_;
+    if (shutdown_) return false;
+
+    inFlight_ += bytes;
+    return true;
+}
+
+bool DecodeAdmission::TryAcquire(size_t bytes)
+{
+    if (bytes == 0) return true;
+
+    std::lock_guard lock(mutex_);
+    if (shutdown_ || waiters_ > 0 || !FitsLocked(bytes)) return false;
+
+    inFlight_ += bytes;
+    return true;
+}
+
+void DecodeAdmission::Release(size_t bytes)
+{
+    if (bytes == 0) return;
+    {
+        std::lock_guard lock(mutex_);
+        inFlight_ -= std::min(inFlight_, bytes);
+    }
+    cv_.notify_all();
+}
+
+void DecodeAdmission::SetCapacity(size_t capacityBytes)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (capacity_ == capacityBytes) return;
+        capacity_ = capacityBytes;
+    }
+    cv_.notify_all();
+}
+
+void DecodeAdmission::Shutdown()
+{
+    {
+        std::lock_guard lock(mutex_);
+        shutdown_ = true;
+    }
+    cv_.notify_all();
+}
+
+size_t DecodeAdmission::GetInFlightBytes() const
+{
+    std::lock_guard lock(mutex_);
+    return inFlight_;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,297 @@
+#include "core/ExifReader.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+constexpr uint16_t kTagOrientation = 0x0112;
+constexpr uint16_t kTagThumbnailOffset = 0x0201;   // JPEGInterchangeFormat
+constexpr uint16_t kTagThumbnailLength = 0x0202;   // JPEGInterchangeFormatLength
+constexpr uint16_t kTagExifIfd = 0x8769;
+constexpr uint16_t kTagDateTimeOriginal = 0x9003;  // "YYYY:MM:DD HH:MM:SS"
+constexpr uint16_t kTagCompression = 0x0103;
+constexpr uint16_t kTagStripOffsets = 0x0111;
+constexpr uint16_t kTagStripByteCounts = 0x0117;
+constexpr uint16_t kTagSubIfds = 0x014A;
+constexpr uint32_t kMaxTiffPages = 65536;
+
+// TIFF structure inside the APP1 payload; offsets are relative to its header
+class TiffView {
+public:
+    TiffView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool Open()
+    {
+        if (size_ < 8) return false;
+        if (data_[0] == 'I' && data_[1] == 'I') bigEndian_ = false;
+        else if (data_[0] == 'M' && data_[1] == 'M') bigEndian_ = true;
+        else return false;
+        return U16(2) == 42;
+    }
+
+    uint32_t FirstIfd() const { return U32(4); }
+
+    bool IfdValid(uint32_t ifd) const
+    {
+        return ifd >= 8 && static_cast<size_t>(ifd) + 2 <= size_ &&
+               ifd + 2 + static_cast<size_t>(U16(ifd)) * 12 <= size_;
+    }
+
+    uint32_t NextIfd(uint32_t ifd) const
+    {
+        size_t at = ifd + 2 + static_cast<size_t>(U16(ifd)) * 12;
+        return at + 4 <= size_ ? U32(at) : 0;
+    }
+
+    // First value of a SHORT or LONG tag
+    bool Tag(uint32_t ifd, uint16_t tag, uint32_t& value) const
+    {
+        return Values(ifd, tag, &value, 1) > 0;
+    }
+
+    // Up to maxCount values of a SHORT, LONG or IFD tag; returns how many
+    // were read (0 when absent, another type, or out of range)
+    uint32_t Values(uint32_t ifd, uint16_t tag, uint32_t* values, uint32_t maxCount) const
+    {
+        uint16_t entries = U16(ifd);
+        for (uint16_t i = 0; i < entries; ++i) {
+            size_t entry = ifd + 2 + static_cast<size_t>(i) * 12;
+            if (U16(entry) != tag) continue;
+            uint16_t type = U16(entry + 2);
+            uint32_t width = type == 3 ? 2 : (type == 4 || type == 13) ? 4 : 0;
+            uint32_t count = std::min(U32(entry + 4), maxCount);
+            if (width == 0 || count == 0) return 0;
+            size_t at = static_cast<size_t>(U32(entry + 4)) * width <= 4 ? entry + 8 : U32(entry + 8);
+            if (at + static_cast<size_t>(count) * width > size_) return 0;
+            for (uint32_t k = 0; k < count; ++k) {
+                values[k] = width == 2 ? U16(at + k * 2) : U32(at + k * 4);
+            }
+            return count;
+        }
+        return 0;
+    }
+
+    // Bytes of an ASCII tag (nullptr when absent or out of range)
+    const char* Ascii(uint32_t ifd, uint16_t tag, uint32_t& count) const
+    {
+        uint16_t entries = U16(ifd);
+        for (uint16_t i = 0; i < entries; ++i) {
+            size_t entry = ifd + 2 + static_cast<size_t>(i) * 12;
+            if (U16(entry) != tag || U16(entry + 2) != 2) continue;
+            count = U32(entry + 4);
+            size_t at = count <= 4 ? entry + 8 : U32(entry + 8);
+            if (at + count > size_) return nullptr;
+            return reinterpret_cast<const char*>(data_ + at);
+        }
+        return nullptr;
+    }
+
+private:
+    uint16_t U16(size_t at) const
+    {
+        const uint8_t* p = data_ + at;
+        return bigEndian_ ? static_cast<uint16_t>((p[0] << 8) | p[1]) : static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+    uint32_t U32(size_t at) const
+    {
+        const uint8_t* p = data_ + at;
+        return bigEndian_ ? (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                                (static_cast<uint32_t>(p[2]) << 8) | p[3]
+                          : static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                                (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    bool bigEndian_ = false;
+};
+
+// Frame size of a baseline or progressive JPEG. Lossless / hierarchical
+// frames (RAW sensor data in CR2 and DNG) don't count as previews.
+bool PreviewFrameSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height)
+{
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+    size_t pos = 2;
+    while (pos + 4 <= size && data[pos] == 0xFF) {
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            ++pos;  // fill byte
+            continue;
+        }
+        size_t length = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+        if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2) {
+            if (length < 7 || pos + 9 > size) return false;
+            height = (static_cast<uint32_t>(data[pos + 5]) << 8) | data[pos + 6];
+            width = (static_cast<uint32_t>(data[pos + 7]) << 8) | data[pos + 8];
+            return width > 0 && height > 0;
+        }
+        if (marker == 0xDA || (marker >= 0xC3 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+                               marker != 0xCC)) {
+            return false;
+        }
+        if (length < 2) return false;
+        pos += 2 + length;
+    }
+    return false;
+}
+
+} // namespace
+
+bool ReadExifTiff(const uint8_t* data, size_t size, ExifInfo& info)
+{
+    info = {};
+    TiffView tiff(data, size);
+    if (!tiff.Open()) return false;
+
+    uint32_t ifd0 = tiff.FirstIfd();
+    if (!tiff.IfdValid(ifd0)) return false;
+
+    uint32_t value = 0;
+    if (tiff.Tag(ifd0, kTagOrientation, value) && value >= 1 && value <= 8) {
+        info.orientation = static_cast<uint16_t>(value);
+    }
+
+    uint32_t exifIfd = 0, count = 0;
+    if (tiff.Tag(ifd0, kTagExifIfd, exifIfd) && tiff.IfdValid(exifIfd)) {
+        const char* date = tiff.Ascii(exifIfd, kTagDateTimeOriginal, count);
+        if (date && count >= 7 && date[4] == ':') {
+            int year = 0, month = 0;
+            for (int i = 0; i < 4; ++i) year = year * 10 + (date[i] - '0');
+            month = (date[5] - '0') * 10 + (date[6] - '0');
+            if (year >= 1900 && year <= 2999 && month >= 1 && month <= 12) {
+                info.year = year;
+                info.month = month;
+            }
+        }
+    }
+
+    // IFD1 describes the embedded thumbnail
+    uint32_t ifd1 = tiff.NextIfd(ifd0);
+    uint32_t offset = 0, thumbLength = 0;
+    if (ifd1 && tiff.IfdValid(ifd1) &&
+        tiff.Tag(ifd1, kTagThumbnailOffset, offset) &&
+        tiff.Tag(ifd1, kTagThumbnailLength, thumbLength) &&
+        thumbLength > 0 && static_cast<size_t>(offset) + thumbLength <= size) {
+        info.thumbnailOffset = offset;
+        info.thumbnailLength = thumbLength;
+    }
+    return true;
+}
+
+bool FindRawPreview(const uint8_t* data, size_t size, RawPreview& preview)
+{
+    preview = {};
+    TiffView tiff(data, size);
+    if (!tiff.Open()) return false;
+
+    ExifInfo exif;
+    if (ReadExifTiff(data, size, exif)) {
+        preview.orientation = exif.orientation;
+    }
+
+    auto consider = [&](uint32_t offset, uint32_t length) {
+        if (length == 0 || static_cast<size_t>(offset) + length > size) return;
+        uint32_t width = 0, height = 0;
+        if (!PreviewFrameSize(data + offset, length, width, height)) return;
+        if (static_cast<uint64_t>(width) * height > static_cast<uint64_t>(preview.width) * preview.height) {
+            preview.offset = offset;
+            preview.length = length;
+            preview.width = width;
+            preview.height = height;
+        }
+    };
+
+    // IFD0's chain and one level of SubIFDs covers CR2, NEF, ARW, PEF, SRW
+    // and DNG; bounded so a looping chain can't spin
+    constexpr uint32_t kMaxIfds = 16;
+    uint32_t pending[kMaxIfds];
+    uint32_t pendingCount = 0;
+    for (uint32_t ifd = tiff.FirstIfd(); ifd && pendingCount < kMaxIfds && tiff.IfdValid(ifd); ifd = tiff.NextIfd(ifd)) {
+        pending[pendingCount++] = ifd;
+    }
+    for (uint32_t i = 0, top = pendingCount; i < top; ++i) {
+        uint32_t subIfds[kMaxIfds];
+        uint32_t count = tiff.Values(pending[i], kTagSubIfds, subIfds, kMaxIfds - pendingCount);
+        for (uint32_t k = 0; k < count; ++k) {
+            if (tiff.IfdValid(subIfds[k])) pending[pendingCount++] = subIfds[k];
+        }
+    }
+
+    for (uint32_t i = 0; i < pendingCount; ++i) {
+        const uint32_t ifd = pending[i];
+        uint32_t offset = 0, length = 0, compression = 0;
+        if (tiff.Tag(ifd, kTagThumbnailOffset, offset) && tiff.Tag(ifd, kTagThumbnailLength, length)) {
+            consider(offset, length);
+        }
+        // A JPEG-compressed image stored as one strip (CR2's full-size preview)
+        if (tiff.Tag(ifd, kTagCompression, compression) && (compression == 6 || compression == 7) &&
+            tiff.Values(ifd, kTagStripOffsets, &offset, 1) == 1 &&
+            tiff.Values(ifd, kTagStripByteCounts, &length, 1) == 1) {
+            consider(offset, length);
+        }
+    }
+    return preview.length > 0;
+}
+
+uint32_t CountTiffPages(const uint8_t* data, size_t size)
+{
+    TiffView tiff(data, size);
+    if (!tiff.Open()) return 0;
+
+    // Bounded so a looping chain can't spin
+    uint32_t count = 0;
+    for (uint32_t ifd = tiff.FirstIfd(); ifd && count < kMaxTiffPages && tiff.IfdValid(ifd); ifd = tiff.NextIfd(ifd)) {
+        ++count;
+    }
+    return count;
+}
+
+uint16_t TiffPageOrientation(const uint8_t* data, size_t size, uint32_t page)
+{
+    TiffView tiff(data, size);
+    if (!tiff.Open() || page >= kMaxTiffPages) return 1;
+
+    uint32_t ifd = tiff.FirstIfd();
+    for (uint32_t i = 0; i < page && ifd && tiff.IfdValid(ifd); ++i) {
+        ifd = tiff.NextIfd(ifd);
+    }
+    uint32_t value = 0;
+    if (ifd && tiff.IfdValid(ifd) && tiff.Tag(ifd, kTagOrientation, value) && value >= 1 && value <= 8) {
+        return static_cast<uint16_t>(value);
+    }
+    return 1;
+}
+
+bool ReadExif(const uint8_t* data, size_t size, ExifInfo& info)
+{
+    info = {};
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+
+    // Walk the marker segments up to the first frame/scan header
+    size_t pos = 2;
+    while (pos + 4 <= size && data[pos] == 0xFF) {
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xDA || (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+                               marker != 0xCC)) {
+            return false;  // image data reached without an EXIF block
+        }
+        size_t length = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+        if (length < 2) return false;
+
+        if (marker == 0xE1 && length >= 16 && pos + 10 <= size && std::memcmp(data + pos + 4, "Exif\0\0", 6) == 0) {
+            const size_t tiffStart = pos + 10;
+            const size_t tiffSize = std::min(pos + 2 + length, size) - tiffStart;
+            if (!ReadExifTiff(data + tiffStart, tiffSize, info)) return false;
+            if (info.thumbnailLength) info.thumbnailOffset += tiffStart;
+            return true;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
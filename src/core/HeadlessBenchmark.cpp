@@ -0,0 +1,907 @@
+#include "core/HeadlessBenchmark.hpp"
+#include "core/ImageCodec.hpp"
+#include "core/ImagePipeline.hpp"
+#include "core/MemoryManager.hpp"
+#include "core/PixelConvert.hpp"
+#include "core/SimdUtils.hpp"
+#include "rendering/NullTextureFactory.hpp"
+#include "ui/Theme.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PassResult {
+    int scrollFrames = 0;
+    int settleFrames = 0;
+    bool settled = false;
+    double wallMs = 0.0;
+    double meanCoverage = 0.0;       // share of visible cells drawn with a thumbnail while scrolling
+    uint64_t uploads = 0;
+    uint64_t uploadedBytes = 0;
+    int64_t peakLiveBytes = 0;
+    std::vector<double> latenciesMs; // first request -> first bitmap, per image
+    std::string stages;              // PipelineTrace histograms
+};
+
+double Percentile(std::vector<double>& values, double p)
+{
+    if (values.empty()) return 0.0;
+    size_t index = static_cast<size_t>(std::ceil(p * static_cast<double>(values.size())));
+    index = std::clamp<size_t>(index, 1, values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+PassResult RunPass(const std::vector<std::filesystem::path>& images,
+                   const HeadlessBenchmarkOptions& options,
+                   const std::filesystem::path& persistPath, bool loadPersisted,
+                   const std::filesystem::path& tracePath)
+{
+    PassResult result;
+
+    ImageDecoder decoder;
+    CacheManager cache;
+    Rendering::NullTextureFactory textures;
+    ImagePipeline pipeline;
+    pipeline.Initialize(&decoder, &cache, &textures);
+    pipeline.GetTrace().SetEnabled(true, 8);
+    if (loadPersisted) {
+        pipeline.LoadPersistentThumbs(persistPath);
+    }
+
+    const int columns = std::max(1, options.columns);
+    const int rows = static_cast<int>((images.size() + columns - 1) / columns);
+    const float viewportPx = options.cellPx * static_cast<float>(options.visibleRows);
+    const float maxScroll = std::max(0.0f, options.cellPx * static_cast<float>(rows) - viewportPx);
+    const auto frameDuration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(options.frameMs));
+
+    std::unordered_map<size_t, Clock::time_point> firstRequest;
+    std::unordered_map<size_t, bool> shown;
+    double coverageSum = 0.0;
+
+    // One gallery frame: request what the viewport shows (plus a row ahead
+    // while scrolling), then upload, like GalleryView::Render does.
+    auto frame = [&](float scrollY, int direction) -> bool {
+        uint32_t targetPx = direction != 0 ? UI::Theme::ThumbnailScrollPx : UI::Theme::ThumbnailMaxPx;
+        int firstRow = static_cast<int>(scrollY / options.cellPx);
+        int lastRow = std::min(rows - 1, static_cast<int>((scrollY + viewportPx) / options.cellPx) +
+                                         (direction != 0 ? 1 : 0));
+        float centerY = scrollY + viewportPx * 0.5f;
+
+        std::vector<std::filesystem::path> visible;
+        int cells = 0, drawn = 0;
+        auto now = Clock::now();
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                size_t index = static_cast<size_t>(row) * columns + col;
+                if (index >= images.size()) break;
+                visible.push_back(images[index]);
+
+                float distance = (static_cast<float>(row) + 0.5f) * options.cellPx - centerY;
+                firstRequest.try_emplace(index, now);
+                auto bitmap = pipeline.RequestThumbnail(images[index], targetPx, distance);
+
+                bool onScreen = std::abs(distance) <= viewportPx * 0.5f + options.cellPx * 0.5f;
+                if (onScreen) ++cells;
+                if (bitmap) {
+                    if (onScreen) ++drawn;
+                    if (shown.emplace(index, true).second) {
+                        result.latenciesMs.push_back(
+                            std::chrono::duration<double, std::milli>(now - firstRequest[index]).count());
+                    }
+                }
+            }
+        }
+        pipeline.SetVisibleRange(visible);
+        pipeline.UpdateThumbnailPriorities(direction);
+        pipeline.FlushReadyThumbnails(UI::Theme::MaxBitmapsPerFrame);
+        pipeline.UpdateMemoryBudgets();
+
+        if (direction != 0 && cells > 0) {
+            coverageSum += static_cast<double>(drawn) / cells;
+        }
+        return cells > 0 && drawn == cells && !pipeline.HasPendingThumbnails();
+    };
+
+    auto start = Clock::now();
+    auto nextFrame = start;
+
+    // Scroll top to bottom at a constant speed
+    for (float scrollY = 0.0f; ; scrollY = std::min(maxScroll, scrollY + options.scrollPxPerFrame)) {
+        frame(scrollY, +1);
+        ++result.scrollFrames;
+        nextFrame += frameDuration;
+        std::this_thread::sleep_until(nextFrame);
+        if (scrollY >= maxScroll) break;
+    }
+
+    // Then hold still until the last screen is fully sharp
+    while (result.settleFrames < options.maxSettleFrames) {
+        ++result.settleFrames;
+        if (frame(maxScroll, 0)) {
+            result.settled = true;
+            break;
+        }
+        nextFrame += frameDuration;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    result.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    result.meanCoverage = result.scrollFrames > 0 ? coverageSum / result.scrollFrames : 0.0;
+
+    const auto& counters = textures.GetCounters();
+    result.uploads = counters.uploads.load();
+    result.uploadedBytes = counters.uploadedBytes.load();
+    result.peakLiveBytes = counters.peakLiveBytes.load();
+
+    result.stages = pipeline.GetTrace().FormatHistograms();
+    pipeline.GetTrace().ExportTimelines(tracePath);
+
+    pipeline.SavePersistentThumbs(persistPath);
+    pipeline.Shutdown();
+    return result;
+}
+
+void AppendPass(std::string& report, const char* name, PassResult& pass, size_t imageCount)
+{
+    char line[512];
+    double seconds = pass.wallMs / 1000.0;
+    std::snprintf(line, sizeof(line),
+        "%s pass: %d scroll + %d settle frames (%s), %.0f ms\n"
+        "  coverage while scrolling: %.1f%%\n"
+        "  first thumbnail latency ms: p50 %.1f  p95 %.1f  p99 %.1f  (%zu/%zu images)\n"
+        "  uploads: %llu (%.1f/s), %.1f MB, peak live %.1f MB\n",
+        name, pass.scrollFrames, pass.settleFrames, pass.settled ? "settled" : "NOT settled", pass.wallMs,
+        pass.meanCoverage * 100.0,
+        Percentile(pass.latenciesMs, 0.50), Percentile(pass.latenciesMs, 0.95),
+        Percentile(pass.latenciesMs, 0.99), pass.latenciesMs.size(), imageCount,
+        static_cast<unsigned long long>(pass.uploads), seconds > 0.0 ? pass.uploads / seconds : 0.0,
+        pass.uploadedBytes / (1024.0 * 1024.0), pass.peakLiveBytes / (1024.0 * 1024.0));
+    report += line;
+    report += pass.stages;
+}
+
+struct BackendTimes {
+    std::vector<double> fullMs;
+    std::vector<double> thumbMs;
+    double megapixels = 0.0;
+    int failed = 0;
+};
+
+double Psnr(const DecodedImage& a, const DecodedImage& b)
+{
+    if (a.info.width != b.info.width || a.info.height != b.info.height) return 0.0;
+    double squared = 0.0;
+    for (size_t i = 0; i < a.info.dataSize; ++i) {
+        double d = static_cast<double>(a.data[i]) - b.data[i];
+        squared += d * d;
+    }
+    double mse = squared / static_cast<double>(a.info.dataSize);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+// Opening a file unbuffered makes the cache manager flush and drop its pages
+// once no cached handle is left, so the next read comes from disk
+void EvictFromCache(const std::vector<std::filesystem::path>& images)
+{
+    for (const auto& path : images) {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    }
+}
+
+// Small 24-bit BMP: decoded by the native codec, so neither WIC nor the
+// disk gets between the stress test and the scheduling it exercises
+bool WriteStressImage(const std::filesystem::path& path)
+{
+    constexpr uint32_t kWidth = 64;
+    constexpr uint32_t kHeight = 48;
+    constexpr uint32_t kHeaderBytes = 54;
+    constexpr uint32_t kPixelBytes = kWidth * 3 * kHeight;  // rows already 4-byte aligned
+
+    std::vector<uint8_t> file(kHeaderBytes + kPixelBytes);
+    auto put16 = [&](size_t at, uint32_t v) {
+        file[at] = static_cast<uint8_t>(v);
+        file[at + 1] = static_cast<uint8_t>(v >> 8);
+    };
+    auto put32 = [&](size_t at, uint32_t v) {
+        put16(at, v & 0xFFFF);
+        put16(at + 2, v >> 16);
+    };
+    file[0] = 'B';
+    file[1] = 'M';
+    put32(2, static_cast<uint32_t>(file.size()));
+    put32(10, kHeaderBytes);
+    put32(14, 40);          // BITMAPINFOHEADER
+    put32(18, kWidth);
+    put32(22, kHeight);     // bottom-up
+    put16(26, 1);
+    put16(28, 24);
+    put32(34, kPixelBytes);
+    for (uint32_t i = 0; i < kPixelBytes; ++i) {
+        file[kHeaderBytes + i] = static_cast<uint8_t>(i * 7);
+    }
+
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    DWORD written = 0;
+    bool ok = WriteFile(handle, file.data(), static_cast<DWORD>(file.size()), &written, nullptr) &&
+              written == file.size();
+    CloseHandle(handle);
+    return ok;
+}
+
+// Marker segments before the first SOS (offset of the FF, total length):
+// where table and frame headers live, so mutations can aim at them
+std::vector<std::pair<size_t, size_t>> FindJpegSegments(const std::vector<uint8_t>& bytes)
+{
+    std::vector<std::pair<size_t, size_t>> segments;
+    size_t at = 2;
+    while (at + 4 <= bytes.size() && bytes[at] == 0xFF && bytes[at + 1] != 0xDA) {
+        size_t length = 2 + ((bytes[at + 2] << 8) | bytes[at + 3]);
+        segments.emplace_back(at, std::min(length, bytes.size() - at));
+        at += length;
+    }
+    return segments;
+}
+
+// One random mutation: flipped bits, a truncation, or bytes near the start
+// of a header segment (Huffman counts, sampling factors, dimensions)
+// set to random or boundary values
+void MutateFile(std::vector<uint8_t>& bytes, const std::vector<std::pair<size_t, size_t>>& segments,
+                std::mt19937& rng)
+{
+    static const uint8_t kEdgeBytes[] = {0x00, 0x01, 0x0F, 0x11, 0x22, 0x33, 0x44, 0x7F, 0x80, 0xFF};
+    auto randomByte = [&] {
+        return rng() & 1 ? static_cast<uint8_t>(rng()) : kEdgeBytes[rng() % std::size(kEdgeBytes)];
+    };
+
+    switch (rng() % 4) {
+    case 0:
+        for (int n = 1 + rng() % 8; n > 0; --n) bytes[rng() % bytes.size()] ^= 1 << (rng() % 8);
+        break;
+    case 1:
+        bytes.resize(1 + rng() % bytes.size());
+        break;
+    default:
+        if (segments.empty()) {
+            bytes[rng() % bytes.size()] = randomByte();
+            break;
+        }
+        for (int n = 1 + rng() % 3; n > 0; --n) {
+            const auto& [offset, length] = segments[rng() % segments.size()];
+            const size_t span = std::min<size_t>(length, 24);
+            if (span > 4) bytes[offset + 4 + rng() % (span - 4)] = randomByte();
+        }
+        break;
+    }
+}
+
+void AppendBackend(std::string& report, const char* name, BackendTimes& times)
+{
+    double totalMs = 0.0;
+    for (double ms : times.fullMs) totalMs += ms;
+    char line[256];
+    std::snprintf(line, sizeof(line),
+        "%-6s full: p50 %.2f ms  p95 %.2f ms  %.1f MP/s | thumb: p50 %.2f ms  p95 %.2f ms | failed %d\n",
+        name, Percentile(times.fullMs, 0.50), Percentile(times.fullMs, 0.95),
+        totalMs > 0.0 ? times.megapixels / (totalMs / 1000.0) : 0.0,
+        Percentile(times.thumbMs, 0.50), Percentile(times.thumbMs, 0.95), times.failed);
+    report += line;
+}
+
+const struct {
+    Simd::PixelLayout layout;
+    const char* name;
+} kConvertLayouts[] = {
+    {Simd::PixelLayout::BGR24, "BGR24"},   {Simd::PixelLayout::RGB24, "RGB24"},
+    {Simd::PixelLayout::BGRA32, "BGRA32"}, {Simd::PixelLayout::RGBA32, "RGBA32"},
+    {Simd::PixelLayout::BGRX32, "BGRX32"}, {Simd::PixelLayout::PBGRA32, "PBGRA32"},
+    {Simd::PixelLayout::Gray8, "Gray8"},   {Simd::PixelLayout::CMYK32, "CMYK32"},
+    {Simd::PixelLayout::RGB48, "RGB48"},   {Simd::PixelLayout::RGBA64, "RGBA64"},
+    {Simd::PixelLayout::Gray16, "Gray16"},
+};
+const char* const kSimdLevelNames[] = {"scalar", "sse2", "avx2"};
+
+bool IsWideLayout(Simd::PixelLayout layout)
+{
+    return layout == Simd::PixelLayout::RGB48 || layout == Simd::PixelLayout::RGBA64 ||
+           layout == Simd::PixelLayout::Gray16;
+}
+
+// One pixel converted straight from the formulas PixelConvert.hpp documents,
+// sharing no code with the kernels: premultiply is (c * a + 127) / 255 and
+// 16-bit channels narrow to round(v / 257)
+void ReferencePBGRA(Simd::PixelLayout layout, const uint8_t* src, uint8_t* dst)
+{
+    auto premultiply = [](uint32_t c, uint32_t a) { return static_cast<uint8_t>((c * a + 127) / 255); };
+    auto narrow = [&](int channel) {
+        uint16_t v;
+        memcpy(&v, src + channel * 2, sizeof(v));
+        return static_cast<uint8_t>(std::lround(v / 257.0));
+    };
+    auto put = [&](uint8_t b, uint8_t g, uint8_t r, uint8_t a) {
+        dst[0] = b;
+        dst[1] = g;
+        dst[2] = r;
+        dst[3] = a;
+    };
+
+    switch (layout) {
+    case Simd::PixelLayout::BGR24:
+    case Simd::PixelLayout::BGRX32:
+        put(src[0], src[1], src[2], 255);
+        break;
+    case Simd::PixelLayout::RGB24:
+        put(src[2], src[1], src[0], 255);
+        break;
+    case Simd::PixelLayout::BGRA32:
+        put(premultiply(src[0], src[3]), premultiply(src[1], src[3]), premultiply(src[2], src[3]), src[3]);
+        break;
+    case Simd::PixelLayout::RGBA32:
+        put(premultiply(src[2], src[3]), premultiply(src[1], src[3]), premultiply(src[0], src[3]), src[3]);
+        break;
+    case Simd::PixelLayout::PBGRA32:
+        put(src[0], src[1], src[2], src[3]);
+        break;
+    case Simd::PixelLayout::Gray8:
+        put(src[0], src[0], src[0], 255);
+        break;
+    case Simd::PixelLayout::CMYK32: {
+        const uint32_t k = 255 - src[3];
+        put(premultiply(255 - src[2], k), premultiply(255 - src[1], k), premultiply(255 - src[0], k), 255);
+        break;
+    }
+    case Simd::PixelLayout::RGB48:
+        put(narrow(2), narrow(1), narrow(0), 255);
+        break;
+    case Simd::PixelLayout::RGBA64: {
+        const uint8_t a = narrow(3);
+        put(premultiply(narrow(2), a), premultiply(narrow(1), a), premultiply(narrow(0), a), a);
+        break;
+    }
+    case Simd::PixelLayout::Gray16:
+        put(narrow(0), narrow(0), narrow(0), 255);
+        break;
+    }
+}
+
+// A prefix that walks every value the layout's math sees (each 16-bit value,
+// each channel/alpha pair for 32-bit layouts, each byte otherwise), then
+// random pixels
+std::vector<uint8_t> MakeCheckSource(Simd::PixelLayout layout, size_t pixelCount, std::mt19937& rng)
+{
+    const uint32_t bpp = Simd::BytesPerPixel(layout);
+    std::vector<uint8_t> source(pixelCount * bpp);
+    for (auto& byte : source) byte = static_cast<uint8_t>(rng());
+
+    if (IsWideLayout(layout)) {
+        for (size_t i = 0; i < 65536 && i * 2 < source.size(); ++i) {
+            const auto v = static_cast<uint16_t>(i);
+            memcpy(&source[i * 2], &v, sizeof(v));
+        }
+    } else if (bpp == 4) {
+        for (size_t i = 0; i < 65536 && i < pixelCount; ++i) {
+            source[i * 4] = static_cast<uint8_t>(i);
+            source[i * 4 + 1] = static_cast<uint8_t>(i + 85);
+            source[i * 4 + 2] = static_cast<uint8_t>(i + 170);
+            source[i * 4 + 3] = static_cast<uint8_t>(i >> 8);
+        }
+    } else {
+        for (size_t i = 0; i < 65536 && i < source.size(); ++i) {
+            source[i] = static_cast<uint8_t>(i);
+        }
+    }
+    return source;
+}
+
+} // namespace
+
+std::string RunHeadlessBenchmark(const std::filesystem::path& folder,
+                                 const HeadlessBenchmarkOptions& options)
+{
+    auto images = ImagePipeline::ScanDirectory(folder);
+    if (images.empty()) {
+        return "No images found in " + folder.string() + "\n";
+    }
+
+    // Private persistent cache so runs don't touch (or benefit from) the app's
+    std::error_code ec;
+    auto persistPath = std::filesystem::temp_directory_path(ec) / "afterglow_bench_thumbs.bin";
+    std::filesystem::remove(persistPath, ec);
+
+    std::string report = "Headless benchmark: " + std::to_string(images.size()) + " images, " +
+                         std::to_string(options.columns) + " columns, " +
+                         std::to_string(static_cast<int>(options.scrollPxPerFrame)) + " px/frame\n";
+
+    auto tempDir = persistPath.parent_path();
+    PassResult cold = RunPass(images, options, persistPath, false, tempDir / "afterglow_bench_cold.json");
+    AppendPass(report, "Cold", cold, images.size());
+
+    if (options.warmPass) {
+        PassResult warm = RunPass(images, options, persistPath, true, tempDir / "afterglow_bench_warm.json");
+        AppendPass(report, "Warm", warm, images.size());
+    }
+
+    std::filesystem::remove(persistPath, ec);
+    report += "Sampled timelines: " + (tempDir / "afterglow_bench_*.json").string() + "\n";
+    return report;
+}
+
+std::string RunDecodeBenchmark(const std::filesystem::path& folder, uint32_t thumbnailPx)
+{
+    auto images = ImagePipeline::ScanDirectory(folder);
+    if (images.empty()) {
+        return "No images found in " + folder.string() + "\n";
+    }
+
+    ImageDecoder native;
+    native.SetBackend(DecodeBackend::Native);
+    ImageDecoder wic;
+    wic.SetBackend(DecodeBackend::WIC);
+
+    BackendTimes nativeTimes, wicTimes;
+    std::vector<double> psnr;
+    int declined = 0;
+
+    auto timed = [](auto&& decode, std::vector<double>& out) {
+        auto start = Clock::now();
+        auto image = decode();
+        if (image) out.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        return image;
+    };
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        const auto& path = images[i];
+        std::unique_ptr<DecodedImage> a, b;
+
+        // Alternate which backend reads the file first so neither always
+        // pays for the cold OS cache
+        auto runNative = [&] { a = timed([&] { return native.Decode(path); }, nativeTimes.fullMs); };
+        auto runWic = [&] { b = timed([&] { return wic.Decode(path); }, wicTimes.fullMs); };
+        if (i & 1) { runWic(); runNative(); } else { runNative(); runWic(); }
+
+        if (!b) {
+            ++wicTimes.failed;
+            continue;
+        }
+        wicTimes.megapixels += b->info.width * static_cast<double>(b->info.height) / 1e6;
+        if (!a) {
+            ++declined;  // format or variant without a native codec
+            continue;
+        }
+        nativeTimes.megapixels += a->info.width * static_cast<double>(a->info.height) / 1e6;
+        psnr.push_back(Psnr(*a, *b));
+        a.reset();
+        b.reset();
+
+        timed([&] { return native.GenerateThumbnail(path, thumbnailPx); }, nativeTimes.thumbMs);
+        timed([&] { return wic.GenerateThumbnail(path, thumbnailPx); }, wicTimes.thumbMs);
+    }
+
+    std::string report = "Decode benchmark: " + std::to_string(images.size()) + " images, " +
+                         std::to_string(psnr.size()) + " decoded natively, " +
+                         std::to_string(declined) + " left to WIC\n";
+    AppendBackend(report, "Native", nativeTimes);
+    AppendBackend(report, "WIC", wicTimes);
+    if (!psnr.empty()) {
+        double worst = *std::min_element(psnr.begin(), psnr.end());
+        char line[128];
+        std::snprintf(line, sizeof(line), "Native vs WIC PSNR: p50 %.1f dB, worst %.1f dB\n",
+                      Percentile(psnr, 0.50), worst);
+        report += line;
+    }
+    return report;
+}
+
+std::string RunCodecFuzz(const std::filesystem::path& folder, uint32_t mutationsPerFile)
+{
+    auto images = ImagePipeline::ScanDirectory(folder);
+    const auto registry = CodecRegistry::CreateDefault();
+    static const uint32_t kScales[] = {0, 256, 64};  // full size and the DCT-scaled paths
+
+    std::mt19937 rng(2024);
+    std::unordered_map<std::string, uint64_t> runsByCodec;
+    uint64_t runs = 0, decoded = 0, threw = 0;
+    size_t seeds = 0;
+    auto start = Clock::now();
+
+    for (const auto& path : images) {
+        MemoryMappedFile file(path);
+        if (!file.Map() || file.GetSize() < 4) continue;
+        const ImageCodec* codec = registry.Find(file.GetData(), file.GetSize());
+        if (!codec) continue;
+        ++seeds;
+
+        const std::vector<uint8_t> seed(file.GetData(), file.GetData() + file.GetSize());
+        const auto segments = FindJpegSegments(seed);
+        std::vector<uint8_t> bytes;
+        for (uint32_t i = 0; i < mutationsPerFile; ++i) {
+            bytes = seed;
+            for (int n = 1 + rng() % 2; n > 0 && !bytes.empty(); --n) MutateFile(bytes, segments, rng);
+            if (!codec->Matches(bytes.data(), bytes.size())) continue;
+
+            ++runs;
+            ++runsByCodec[codec->Name()];
+            try {
+                uint32_t width = 0, height = 0;
+                codec->ReadSize(bytes.data(), bytes.size(), width, height);
+                CodecImage out;
+                if (codec->Decode(bytes.data(), bytes.size(), kScales[i % std::size(kScales)], out)) ++decoded;
+            } catch (const std::exception&) {
+                ++threw;  // allocation failure on a corrupt size: survivable, but worth seeing
+            }
+        }
+    }
+
+    if (seeds == 0) {
+        return "No natively decoded images found in " + folder.string() + "\n";
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "Codec fuzz: %zu seed files, %llu mutated decodes in %.1f s, %llu accepted, %llu threw\n",
+                  seeds, static_cast<unsigned long long>(runs), seconds, static_cast<unsigned long long>(decoded),
+                  static_cast<unsigned long long>(threw));
+    std::string report = line;
+    for (const auto& [name, count] : runsByCodec) {
+        report += "  " + name + ": " + std::to_string(count) + " decodes\n";
+    }
+    report += "No crash (run an ASan build to catch silent overruns)\n";
+    return report;
+}
+
+std::string RunBatchBenchmark(const std::filesystem::path& folder, uint32_t thumbnailPx)
+{
+    auto images = ImagePipeline::ScanDirectory(folder);
+    if (images.empty()) {
+        return "No images found in " + folder.string() + "\n";
+    }
+
+    ImageDecoder decoder;
+    ThreadPool pool;
+    std::string report = "Batch benchmark: " + std::to_string(images.size()) + " images, " +
+                         std::to_string(thumbnailPx) + " px thumbnails, " +
+                         std::to_string(pool.ThreadCount()) + " workers\n";
+
+    auto appendPass = [&](const char* name, double ms, int decoded) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-10s %8.0f ms  %7.1f images/s  (%d/%zu decoded)\n",
+                      name, ms, ms > 0.0 ? decoded / (ms / 1000.0) : 0.0, decoded, images.size());
+        report += line;
+    };
+
+    // Request order: each task opens and reads its own file, in whatever
+    // order the workers get to them
+    {
+        std::vector<std::filesystem::path> shuffled = images;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1234));
+        EvictFromCache(images);
+
+        std::atomic<int> decoded{0};
+        auto start = Clock::now();
+        for (const auto& path : shuffled) {
+            pool.Submit([&decoder, &decoded, &path, thumbnailPx] {
+                if (decoder.GenerateThumbnail(path, thumbnailPx)) decoded.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        pool.WaitIdle();
+        appendPass("Per-file", std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+                   decoded.load());
+    }
+
+    // Disk order, reads overlapped with decodes
+    {
+        EvictFromCache(images);
+
+        std::atomic<int> decoded{0};
+        auto start = Clock::now();
+        decoder.DecodeBatch(pool, images, [&decoded](size_t, std::unique_ptr<DecodedImage> image) {
+            if (image) decoded.fetch_add(1, std::memory_order_relaxed);
+        }, thumbnailPx);
+        appendPass("Batch", std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+                   decoded.load());
+    }
+
+    return report;
+}
+
+std::string RunAsyncStress(uint32_t decodeCount)
+{
+    wchar_t tempDir[MAX_PATH];
+    if (GetTempPathW(MAX_PATH, tempDir) == 0) {
+        return "No temp folder\n";
+    }
+    const std::filesystem::path path = std::filesystem::path(tempDir) / L"uiv-async-stress.bmp";
+    if (!WriteStressImage(path)) {
+        return "Could not write " + path.string() + "\n";
+    }
+
+    ThreadPool pool;
+    std::string report = "Async stress: " + std::to_string(decodeCount) + " decodes per phase, " +
+                         std::to_string(pool.ThreadCount()) + " workers\n";
+    int failures = 0;
+    auto appendPhase = [&](const char* name, bool ok, const char* detail) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-4s %-22s %s\n", ok ? "ok" : "FAIL", name, detail);
+        report += line;
+        if (!ok) ++failures;
+    };
+    char detail[192];
+
+    // Every decode calls back exactly once, with an image
+    {
+        ImageDecoder decoder;
+        std::atomic<uint32_t> called{0}, empty{0};
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < decodeCount; ++i) {
+            decoder.DecodeAsync(pool, path, [&](std::unique_ptr<DecodedImage> image) {
+                if (!image || !image->data) empty.fetch_add(1, std::memory_order_relaxed);
+                called.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        pool.WaitIdle();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::snprintf(detail, sizeof(detail), "%u/%u called back, %u without an image, %.0f ms (%.0f decodes/s)",
+                      called.load(), decodeCount, empty.load(), ms, ms > 0.0 ? decodeCount / (ms / 1000.0) : 0.0);
+        appendPhase("Mass submit", called == decodeCount && empty == 0, detail);
+    }
+
+    // Stop once a quarter has called back. A decode that passed its last
+    // check before the stop may still report, at most one per worker; the
+    // rest are dropped
+    {
+        ImageDecoder decoder;
+        std::stop_source stop;
+        std::atomic<uint32_t> called{0}, afterStop{0};
+        for (uint32_t i = 0; i < decodeCount; ++i) {
+            decoder.DecodeAsync(pool, path, [&](std::unique_ptr<DecodedImage>) {
+                if (stop.stop_requested()) afterStop.fetch_add(1, std::memory_order_relaxed);
+                if (called.fetch_add(1, std::memory_order_relaxed) + 1 == decodeCount / 4) stop.request_stop();
+            }, TaskPriority::Normal, stop.get_token());
+        }
+        pool.WaitIdle();
+        std::snprintf(detail, sizeof(detail), "%u/%u called back, %u after the stop, %u dropped",
+                      called.load(), decodeCount, afterStop.load(), decodeCount - called.load());
+        appendPhase("Cancel mid-flight", stop.stop_requested() && called < decodeCount &&
+                                         afterStop <= pool.ThreadCount(), detail);
+    }
+
+    // The decoder goes away with decodes still queued (skipped when they
+    // run), or after the pool purged them (released without running). State
+    // the callbacks touch is shared so a hung destructor can be abandoned.
+    struct DestroyState {
+        std::atomic<uint32_t> called{0};
+        std::atomic<uint32_t> afterDestroy{0};
+        std::atomic<bool> destroyed{false};
+    };
+    constexpr auto kDestroyTimeout = std::chrono::seconds(30);
+    for (bool purge : {false, true}) {
+        auto state = std::make_shared<DestroyState>();
+        auto decoder = std::make_unique<ImageDecoder>();
+        for (uint32_t i = 0; i < decodeCount; ++i) {
+            decoder->DecodeAsync(pool, path, [state](std::unique_ptr<DecodedImage>) {
+                if (state->destroyed.load()) state->afterDestroy.fetch_add(1, std::memory_order_relaxed);
+                state->called.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        if (purge) pool.PurgeAll();
+
+        auto start = Clock::now();
+        std::thread destroyer([state, owned = std::move(decoder)]() mutable {
+            owned.reset();
+            state->destroyed = true;
+        });
+        while (!state->destroyed.load() && Clock::now() - start < kDestroyTimeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const char* name = purge ? "Destroy after purge" : "Destroy while queued";
+        if (!state->destroyed.load()) {
+            destroyer.detach();
+            appendPhase(name, false, "destructor still waiting after 30 s");
+            continue;
+        }
+        destroyer.join();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        pool.WaitIdle();
+        std::snprintf(detail, sizeof(detail), "destructor returned in %.1f ms, %u/%u called back, %u afterwards",
+                      ms, state->called.load(), decodeCount, state->afterDestroy.load());
+        appendPhase(name, state->afterDestroy == 0, detail);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    report += failures == 0 ? "All phases passed\n" : std::to_string(failures) + " phase(s) failed\n";
+    return report;
+}
+
+std::string RunConvertBenchmark(size_t pixelCount)
+{
+    constexpr int kRuns = 5;
+
+    Simd::DetectFeatures();
+    const auto maxLevel = Simd::MaxSimdLevel();
+
+    std::string report = "Convert benchmark: " + std::to_string(pixelCount) + " pixels, best of " +
+                         std::to_string(kRuns) + ", GB/s (src + dst)\n";
+    std::mt19937 rng(1234);
+    std::vector<uint8_t> reference(pixelCount * 4), output(pixelCount * 4);
+    int mismatches = 0;
+
+    for (const auto& entry : kConvertLayouts) {
+        std::vector<uint8_t> source(pixelCount * Simd::BytesPerPixel(entry.layout));
+        for (auto& byte : source) byte = static_cast<uint8_t>(rng());
+        const double bytes = static_cast<double>(source.size() + output.size());
+
+        char line[160];
+        int used = std::snprintf(line, sizeof(line), "%-8s", entry.name);
+        for (int level = 0; level <= static_cast<int>(maxLevel); ++level) {
+            auto& out = level == 0 ? reference : output;
+            double bestMs = 0.0;
+            for (int run = 0; run < kRuns; ++run) {
+                auto start = Clock::now();
+                Simd::ConvertToPBGRA(entry.layout, source.data(), out.data(), pixelCount,
+                                     static_cast<Simd::SimdLevel>(level));
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if (run == 0 || ms < bestMs) bestMs = ms;
+            }
+            bool exact = level == 0 || memcmp(reference.data(), output.data(), output.size()) == 0;
+            if (!exact) ++mismatches;
+            used += std::snprintf(line + used, sizeof(line) - used, "  %s %6.2f%s", kSimdLevelNames[level],
+                                  bytes / (bestMs * 1e6), exact ? "" : " MISMATCH");
+        }
+        report += line;
+        report += "\n";
+    }
+
+    // Tone mapping from linear floats (0..8, a third translucent): tiers may
+    // round one step apart, so the worst deviation is reported
+    {
+        std::vector<float> source(pixelCount * 4);
+        std::uniform_real_distribution<float> light(0.0f, 8.0f), cover(0.0f, 1.0f);
+        for (size_t i = 0; i < pixelCount; ++i) {
+            float alpha = i % 3 == 0 ? cover(rng) : 1.0f;
+            for (int c = 0; c < 3; ++c) source[i * 4 + c] = light(rng) * alpha;
+            source[i * 4 + 3] = alpha;
+        }
+        const double bytes = static_cast<double>(source.size() * sizeof(float) + output.size());
+        static const struct {
+            Simd::ToneMapOperator op;
+            const char* name;
+        } kOperators[] = {{Simd::ToneMapOperator::Reinhard, "Reinhard"}, {Simd::ToneMapOperator::AcesFit, "ACES"}};
+
+        for (const auto& entry : kOperators) {
+            char line[160];
+            int used = std::snprintf(line, sizeof(line), "%-8s", entry.name);
+            for (int level = 0; level <= static_cast<int>(maxLevel); ++level) {
+                auto& out = level == 0 ? reference : output;
+                double bestMs = 0.0;
+                for (int run = 0; run < kRuns; ++run) {
+                    auto start = Clock::now();
+                    Simd::ToneMapToPBGRA(source.data(), out.data(), pixelCount, entry.op, 1.0f,
+                                         static_cast<Simd::SimdLevel>(level));
+                    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                    if (run == 0 || ms < bestMs) bestMs = ms;
+                }
+                int worst = 0;
+                for (size_t i = 0; level > 0 && i < output.size(); ++i) {
+                    worst = std::max(worst, std::abs(static_cast<int>(reference[i]) - output[i]));
+                }
+                if (worst > 1) ++mismatches;
+                used += std::snprintf(line + used, sizeof(line) - used, "  %s %6.2f%s", kSimdLevelNames[level],
+                                      bytes / (bestMs * 1e6), worst == 0 ? "" : worst == 1 ? " (+-1)" : " MISMATCH");
+            }
+            report += line;
+            report += "\n";
+        }
+    }
+
+    report += mismatches == 0 ? "All tiers match the scalar reference\n"
+                              : std::to_string(mismatches) + " tier(s) differ from scalar\n";
+    return report;
+}
+
+std::string RunConvertCheck(bool* passed)
+{
+    constexpr size_t kPixels = 65536 + 4099;   // exhaustive prefix, then an odd run of random pixels
+    constexpr size_t kMaxTail = 67;            // past two of the widest (32-element) AVX2 blocks
+    constexpr size_t kMaxShift = 4;            // source and destination misalignment
+    constexpr size_t kGuardBytes = 64;
+    constexpr uint8_t kCanary = 0xA5;
+
+    Simd::DetectFeatures();
+    const auto maxLevel = Simd::MaxSimdLevel();
+
+    std::string report = "Convert check: " + std::to_string(kPixels) + " pixels per layout, counts 0.." +
+                         std::to_string(kMaxTail) + " at " + std::to_string(kMaxShift * kMaxShift) +
+                         " alignments, against the documented formulas\n";
+    std::mt19937 rng(4321);
+    std::vector<uint8_t> expected(kPixels * 4), output(kPixels * 4);
+    std::vector<uint8_t> tail(kGuardBytes + kMaxShift + kMaxTail * 4 + kGuardBytes);
+    uint8_t want[4];
+    int failures = 0;
+
+    for (const auto& entry : kConvertLayouts) {
+        const uint32_t bpp = Simd::BytesPerPixel(entry.layout);
+        const size_t shiftBytes = IsWideLayout(entry.layout) ? 2 : 1;  // 16-bit sources stay 2-byte aligned
+        const auto source = MakeCheckSource(entry.layout, kPixels, rng);
+        for (size_t i = 0; i < kPixels; ++i) {
+            ReferencePBGRA(entry.layout, source.data() + i * bpp, expected.data() + i * 4);
+        }
+
+        char line[256];
+        int used = std::snprintf(line, sizeof(line), "%-8s", entry.name);
+        for (int level = 0; level <= static_cast<int>(maxLevel); ++level) {
+            const auto simd = static_cast<Simd::SimdLevel>(level);
+
+            Simd::ConvertToPBGRA(entry.layout, source.data(), output.data(), kPixels, simd);
+            size_t badPixels = 0;
+            for (size_t i = 0; i < kPixels; ++i) {
+                if (memcmp(expected.data() + i * 4, output.data() + i * 4, 4) != 0) ++badPixels;
+            }
+
+            // Short runs from random starts: every tail length at every
+            // alignment, with canaries around the destination to catch overruns
+            size_t badTails = 0;
+            for (size_t srcShift = 0; srcShift < kMaxShift; ++srcShift) {
+                for (size_t dstShift = 0; dstShift < kMaxShift; ++dstShift) {
+                    for (size_t count = 0; count <= kMaxTail; ++count) {
+                        const uint8_t* src = source.data() + (rng() % (kPixels - kMaxTail - 1)) * bpp +
+                                             srcShift * shiftBytes;
+                        uint8_t* dst = tail.data() + kGuardBytes + dstShift;
+                        std::fill(tail.begin(), tail.end(), kCanary);
+                        Simd::ConvertToPBGRA(entry.layout, src, dst, count, simd);
+
+                        bool ok = true;
+                        for (size_t i = 0; ok && i < count; ++i) {
+                            ReferencePBGRA(entry.layout, src + i * bpp, want);
+                            ok = memcmp(want, dst + i * 4, 4) == 0;
+                        }
+                        for (size_t i = 0; ok && i < tail.size(); ++i) {
+                            const bool inside = tail.data() + i >= dst && tail.data() + i < dst + count * 4;
+                            ok = inside || tail[i] == kCanary;
+                        }
+                        if (!ok) ++badTails;
+                    }
+                }
+            }
+
+            const bool exact = badPixels == 0 && badTails == 0;
+            if (!exact) ++failures;
+            if (exact) {
+                used += std::snprintf(line + used, sizeof(line) - used, "  %s ok", kSimdLevelNames[level]);
+            } else {
+                used += std::snprintf(line + used, sizeof(line) - used, "  %s FAIL (%zu px, %zu runs)",
+                                      kSimdLevelNames[level], badPixels, badTails);
+            }
+        }
+        report += line;
+        report += "\n";
+    }
+
+    if (passed) *passed = failures == 0;
+    report += failures == 0 ? "All tiers match the reference bit for bit\n"
+                            : std::to_string(failures) + " tier(s) differ from the reference\n";
+    return report;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
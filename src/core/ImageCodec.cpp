@@ -0,0 +1,36 @@
+#include "core/ImageCodec.hpp"
+#include "core/JpegCodec.hpp"
+#include "core/RasterCodecs.hpp"
+
+namespace UltraImageViewer {
+namespace Core {
+
+void CodecRegistry::Register(std::unique_ptr<ImageCodec> codec)
+{
+    if (codec) {
+        codecs_.push_back(std::move(codec));
+    }
+}
+
+const ImageCodec* CodecRegistry::Find(const uint8_t* data, size_t size) const
+{
+    if (!data || size == 0) return nullptr;
+    for (const auto& codec : codecs_) {
+        if (codec->Matches(data, size)) {
+            return codec.get();
+        }
+    }
+    return nullptr;
+}
+
+CodecRegistry CodecRegistry::CreateDefault()
+{
+    CodecRegistry registry;
+    registry.Register(std::make_unique<JpegCodec>());
+    registry.Register(std::make_unique<BmpCodec>());
+    registry.Register(std::make_unique<TiffCodec>());
+    return registry;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -1,15 +1,419 @@
 #include "core/ImageDecoder.hpp"
 #include "core/SimdUtils.hpp"
+#include "core/ExifReader.hpp"
+#include "core/ImageProbe.hpp"
+#include "core/JpegCodec.hpp"
+#include "core/MemoryManager.hpp"
+#include "core/PixelConvert.hpp"
+#include "core/PixelPipeline.hpp"
+#include "core/Resampler.hpp"
 #include <stdexcept>
 #include <algorithm>
 #include <cstring>
 #include <limits>
-#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <winioctl.h>
 
 namespace UltraImageViewer {
 namespace Core {
 
+namespace {
+
+// APP1 is capped at 64 KB and follows at most a small APP0, so this window
+// holds the whole EXIF block and usually the frame header too
+constexpr size_t kExifWindowBytes = 128 * 1024;
+
+// DecoderFlags::MemoryMapped applies above this size; smaller files are
+// cheaper to read in one call than to map
+constexpr uintmax_t kMemoryMappedThreshold = 50 * 1024 * 1024;
+
+// Rows per WIC CopyPixels call in streaming decodes (~16 MB at 16K wide)
+constexpr uint32_t kBandRows = 256;
+
+// DecodeBatch read-ahead: bytes read but not yet decoded. Enough to keep
+// every worker busy; the reader waits beyond it.
+constexpr size_t kBatchReadAheadBytes = 64 * 1024 * 1024;
+
+// Thumbnail size maintaining aspect ratio. Images that already fit are kept
+// at native size: callers (viewer previews) rely on never getting an
+// upscaled result.
+void FitWithin(uint32_t width, uint32_t height, uint32_t maxSize, uint32_t& fitWidth, uint32_t& fitHeight)
+{
+    if (width <= maxSize && height <= maxSize) {
+        fitWidth = width;
+        fitHeight = height;
+    } else if (width > height) {
+        fitWidth = maxSize;
+        fitHeight = std::max(1u, static_cast<uint32_t>((static_cast<float>(height) / width) * maxSize));
+    } else {
+        fitHeight = maxSize;
+        fitWidth = std::max(1u, static_cast<uint32_t>((static_cast<float>(width) / height) * maxSize));
+    }
+}
+
+bool ReadWholeFile(const std::filesystem::path& filePath, std::vector<uint8_t>& bytes)
+{
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    bool ok = false;
+    LARGE_INTEGER size = {};
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart <= MAXDWORD) {
+        bytes.resize(static_cast<size_t>(size.QuadPart));
+        DWORD read = 0;
+        ok = ReadFile(file, bytes.data(), static_cast<DWORD>(bytes.size()), &read, nullptr) &&
+             read == bytes.size();
+    }
+    CloseHandle(file);
+    return ok;
+}
+
+// WIC formats with a Simd::ConvertToPBGRA kernel
+bool LayoutForWicFormat(const WICPixelFormatGUID& format, Simd::PixelLayout& layout)
+{
+    static const struct {
+        const WICPixelFormatGUID* format;
+        Simd::PixelLayout layout;
+    } kLayouts[] = {
+        {&GUID_WICPixelFormat24bppBGR, Simd::PixelLayout::BGR24},
+        {&GUID_WICPixelFormat24bppRGB, Simd::PixelLayout::RGB24},
+        {&GUID_WICPixelFormat32bppBGRA, Simd::PixelLayout::BGRA32},
+        {&GUID_WICPixelFormat32bppRGBA, Simd::PixelLayout::RGBA32},
+        {&GUID_WICPixelFormat32bppBGR, Simd::PixelLayout::BGRX32},
+        {&GUID_WICPixelFormat32bppPBGRA, Simd::PixelLayout::PBGRA32},
+        {&GUID_WICPixelFormat8bppGray, Simd::PixelLayout::Gray8},
+        {&GUID_WICPixelFormat32bppCMYK, Simd::PixelLayout::CMYK32},
+        {&GUID_WICPixelFormat48bppRGB, Simd::PixelLayout::RGB48},
+        {&GUID_WICPixelFormat64bppRGBA, Simd::PixelLayout::RGBA64},
+        {&GUID_WICPixelFormat16bppGray, Simd::PixelLayout::Gray16},
+    };
+    for (const auto& entry : kLayouts) {
+        if (IsEqualGUID(*entry.format, format)) {
+            layout = entry.layout;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Channel depth of a WIC pixel format
+struct FormatDepth {
+    bool deep = false;     // over 8 bits per channel
+    bool linear = false;   // float / fixed point: scRGB, highlights above 1.0
+};
+
+FormatDepth QueryFormatDepth(IWICImagingFactory2* factory, const WICPixelFormatGUID& format)
+{
+    FormatDepth depth;
+    Microsoft::WRL::ComPtr<IWICComponentInfo> componentInfo;
+    Microsoft::WRL::ComPtr<IWICPixelFormatInfo2> formatInfo;
+    UINT bits = 0, channels = 0;
+    if (FAILED(factory->CreateComponentInfo(format, &componentInfo)) ||
+        FAILED(componentInfo->QueryInterface(IID_PPV_ARGS(&formatInfo))) ||
+        FAILED(formatInfo->GetBitsPerPixel(&bits)) ||
+        FAILED(formatInfo->GetChannelCount(&channels)) || channels == 0) {
+        return depth;
+    }
+    WICPixelFormatNumericRepresentation numeric = WICPixelFormatNumericRepresentationUnspecified;
+    formatInfo->GetNumericRepresentation(&numeric);
+    depth.linear = numeric == WICPixelFormatNumericRepresentationFloat ||
+                   numeric == WICPixelFormatNumericRepresentationFixed;
+    depth.deep = depth.linear || bits / channels > 8;
+    return depth;
+}
+
+// EXIF orientation as a WIC flip/rotate (WIC rotates clockwise, then flips)
+WICBitmapTransformOptions OrientationTransform(uint16_t orientation)
+{
+    switch (orientation) {
+    case 2: return WICBitmapTransformFlipHorizontal;
+    case 3: return WICBitmapTransformRotate180;
+    case 4: return WICBitmapTransformFlipVertical;
+    case 5: return static_cast<WICBitmapTransformOptions>(WICBitmapTransformRotate90 | WICBitmapTransformFlipHorizontal);
+    case 6: return WICBitmapTransformRotate90;
+    case 7: return static_cast<WICBitmapTransformOptions>(WICBitmapTransformRotate270 | WICBitmapTransformFlipHorizontal);
+    case 8: return WICBitmapTransformRotate270;
+    default: return WICBitmapTransformRotate0;
+    }
+}
+
+// Rows of a WIC source as tightly packed premultiplied BGRA. Formats with a
+// SIMD kernel are copied raw and converted here, skipping the extra pass of
+// IWICFormatConverter; anything else (palettes, ...) still uses it. Float and
+// fixed-point sources go through linear floats and are tone mapped, so HDR
+// highlights roll off instead of clipping.
+class PBGRAReader {
+public:
+    bool Initialize(IWICImagingFactory2* factory, IWICBitmapSource* source)
+    {
+        WICPixelFormatGUID format = {};
+        if (FAILED(source->GetSize(&width_, &height_)) || FAILED(source->GetPixelFormat(&format))) {
+            return false;
+        }
+        if (LayoutForWicFormat(format, layout_)) {
+            source_ = source;
+            return true;
+        }
+
+        toneMap_ = QueryFormatDepth(factory, format).linear;
+        Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+        if (FAILED(factory->CreateFormatConverter(&converter)) ||
+            FAILED(converter->Initialize(source,
+                                         toneMap_ ? GUID_WICPixelFormat128bppPRGBAFloat : GUID_WICPixelFormat32bppPBGRA,
+                                         WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom))) {
+            return false;
+        }
+        source_ = converter;
+        layout_ = Simd::PixelLayout::PBGRA32;
+        return true;
+    }
+
+    uint32_t Width() const { return width_; }
+    uint32_t Height() const { return height_; }
+
+    HRESULT CopyRows(uint32_t firstRow, uint32_t rowCount, uint8_t* dst)
+    {
+        WICRect rect = {0, static_cast<INT>(firstRow), static_cast<INT>(width_), static_cast<INT>(rowCount)};
+        const size_t pixels = static_cast<size_t>(width_) * rowCount;
+        if (toneMap_) {
+            staging_.resize(pixels * 16);
+            HRESULT hr = source_->CopyPixels(&rect, width_ * 16, static_cast<UINT>(staging_.size()), staging_.data());
+            if (SUCCEEDED(hr)) {
+                Simd::ToneMapToPBGRA(reinterpret_cast<const float*>(staging_.data()), dst, pixels);
+            }
+            return hr;
+        }
+        if (layout_ == Simd::PixelLayout::PBGRA32) {
+            return source_->CopyPixels(&rect, width_ * 4, static_cast<UINT>(pixels * 4), dst);
+        }
+
+        const UINT stride = width_ * Simd::BytesPerPixel(layout_);
+        staging_.resize(static_cast<size_t>(stride) * rowCount);
+        HRESULT hr = source_->CopyPixels(&rect, stride, static_cast<UINT>(staging_.size()), staging_.data());
+        if (SUCCEEDED(hr)) {
+            Simd::ConvertToPBGRA(layout_, staging_.data(), dst, pixels);
+        }
+        return hr;
+    }
+
+    bool CanCopyOriented() const { return !toneMap_ && CanConvertOriented(layout_); }
+
+    // Whole image from the raw rows, converted and turned upright in one
+    // pass (ConvertOriented); dst is height x width for orientations 5-8
+    HRESULT CopyOriented(uint16_t orientation, uint8_t* dst)
+    {
+        WICRect rect = {0, 0, static_cast<INT>(width_), static_cast<INT>(height_)};
+        const UINT stride = width_ * Simd::BytesPerPixel(layout_);
+        staging_.resize(static_cast<size_t>(stride) * height_);
+        HRESULT hr = source_->CopyPixels(&rect, stride, static_cast<UINT>(staging_.size()), staging_.data());
+        if (SUCCEEDED(hr)) {
+            ConvertOriented(layout_, staging_.data(), stride, width_, height_, orientation, dst);
+        }
+        return hr;
+    }
+
+private:
+    Microsoft::WRL::ComPtr<IWICBitmapSource> source_;
+    Simd::PixelLayout layout_ = Simd::PixelLayout::PBGRA32;
+    bool toneMap_ = false;         // source_ yields 128bppPRGBAFloat
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint8_t> staging_;
+};
+
+// Whole image through reader, kBandRows at a time so a converting read
+// stages one band rather than a second full-size copy
+HRESULT CopyAllRows(PBGRAReader& reader, uint8_t* dst)
+{
+    const size_t stride = static_cast<size_t>(reader.Width()) * 4;
+    for (uint32_t y = 0; y < reader.Height(); y += kBandRows) {
+        const uint32_t rows = std::min(kBandRows, reader.Height() - y);
+        HRESULT hr = reader.CopyRows(y, rows, dst + y * stride);
+        if (FAILED(hr)) {
+            return hr;
+        }
+    }
+    return S_OK;
+}
+
+// EXIF orientation from a file's head (1 when absent or unreadable)
+uint16_t ReadOrientation(const uint8_t* data, size_t size)
+{
+    ImageProbeResult probe;
+    if (ProbeImage(data, std::min(size, kProbeMaxBytes), probe) != ProbeStatus::Ok) {
+        return 1;
+    }
+    return probe.orientation;
+}
+
+uint16_t ReadOrientation(const std::filesystem::path& filePath)
+{
+    ImageProbeResult probe;
+    return ProbeFile(filePath, probe) ? probe.orientation : 1;
+}
+
+// Orientations 5-8 turn the image sideways
+void SwapOrientedSize(DecodedImage& image, uint16_t orientation)
+{
+    if (orientation >= 5 && orientation <= 8) {
+        std::swap(image.info.width, image.info.height);
+        std::swap(image.sourceWidth, image.sourceHeight);
+    }
+}
+
+// Decodes leave here upright, so caches and the renderer never deal with
+// EXIF orientation
+void OrientImage(DecodedImage& image, uint16_t orientation)
+{
+    if (orientation < 2 || orientation > 8 || !image.data) {
+        return;
+    }
+    const uint32_t width = image.info.width, height = image.info.height;
+    auto upright = std::make_unique_for_overwrite<uint8_t[]>(static_cast<size_t>(width) * height * 4);
+    Simd::OrientBGRA(image.data.get(), static_cast<size_t>(width) * 4, width, height, orientation, upright.get());
+    image.data = std::move(upright);
+    SwapOrientedSize(image, orientation);
+}
+
+// A native codec's output as a DecodedImage: fit into maxDimension (0 = full
+// size) and turned upright
+std::unique_ptr<DecodedImage> FromCodecImage(const std::filesystem::path& filePath, CodecImage& decoded,
+                                             uint32_t maxDimension, uint16_t orientation)
+{
+    auto image = std::make_unique<DecodedImage>();
+    image->sourcePath = filePath;
+    image->sourceWidth = decoded.sourceWidth;
+    image->sourceHeight = decoded.sourceHeight;
+    image->info.pixelFormat = GUID_WICPixelFormat32bppPBGRA;
+    image->info.bitsPerPixel = 32;
+    image->info.hasAlpha = true;
+    image->info.isHDR = false;
+
+    // Fit the source frame (not a codec's reduced-size output) into the box
+    uint32_t fitWidth = decoded.width, fitHeight = decoded.height;
+    if (maxDimension > 0) {
+        FitWithin(decoded.sourceWidth, decoded.sourceHeight, maxDimension, fitWidth, fitHeight);
+    }
+    if (fitWidth < decoded.width || fitHeight < decoded.height) {
+        fitWidth = std::min(fitWidth, decoded.width);
+        fitHeight = std::min(fitHeight, decoded.height);
+        image->data = std::make_unique<uint8_t[]>(static_cast<size_t>(fitWidth) * fitHeight * 4);
+        ResampleBGRA(decoded.pixels.get(), decoded.width, decoded.height,
+                     image->data.get(), fitWidth, fitHeight);
+    } else {
+        fitWidth = decoded.width;
+        fitHeight = decoded.height;
+        image->data = std::move(decoded.pixels);
+    }
+
+    image->info.width = fitWidth;
+    image->info.height = fitHeight;
+    image->info.dataSize = static_cast<size_t>(fitWidth) * fitHeight * 4;
+    OrientImage(*image, orientation);
+    return image;
+}
+
+// Where a file sits on disk, for DecodeBatch's read order
+struct DiskLocation {
+    uint32_t volume = 0;
+    uint8_t tier = 2;        // 0 = first cluster, 1 = file ID, 2 = directory order only
+    uint64_t key = 0;
+};
+
+bool IsRemotePath(const std::filesystem::path& filePath, std::unordered_map<std::wstring, bool>& remoteRoots)
+{
+    std::wstring root = filePath.root_path().wstring();
+    auto it = remoteRoots.find(root);
+    if (it != remoteRoots.end()) {
+        return it->second;
+    }
+    // UNC shares, and drive letters mapped to them
+    bool remote = (root.size() >= 2 && root[0] == L'\\' && root[1] == L'\\' && root.rfind(L"\\\\?\\", 0) != 0) ||
+                  GetDriveTypeW(root.c_str()) == DRIVE_REMOTE;
+    remoteRoots.emplace(std::move(root), remote);
+    return remote;
+}
+
+DiskLocation QueryDiskLocation(const std::filesystem::path& filePath)
+{
+    DiskLocation location;
+    HANDLE file = CreateFileW(filePath.c_str(), FILE_READ_ATTRIBUTES,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, 0, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return location;
+    }
+
+    BY_HANDLE_FILE_INFORMATION info = {};
+    if (GetFileInformationByHandle(file, &info)) {
+        location.volume = info.dwVolumeSerialNumber;
+        location.tier = 1;
+        location.key = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    }
+
+    // Only the first extent matters; fragmented files report ERROR_MORE_DATA
+    // with it filled in. Resident and sparse files have no cluster (Lcn -1).
+    STARTING_VCN_INPUT_BUFFER input = {};
+    RETRIEVAL_POINTERS_BUFFER extents = {};
+    DWORD returned = 0;
+    if ((DeviceIoControl(file, FSCTL_GET_RETRIEVAL_POINTERS, &input, sizeof(input),
+                         &extents, sizeof(extents), &returned, nullptr) ||
+         GetLastError() == ERROR_MORE_DATA) &&
+        extents.ExtentCount > 0 && extents.Extents[0].Lcn.QuadPart >= 0) {
+        location.tier = 0;
+        location.key = static_cast<uint64_t>(extents.Extents[0].Lcn.QuadPart);
+    }
+    CloseHandle(file);
+    return location;
+}
+
+// ICONDIR: reserved 0, type 1 (icon) or 2 (cursor), then the image count,
+// little-endian, followed by one 16-byte entry per image
+uint32_t CountIconImages(const uint8_t* data, size_t size)
+{
+    if (size < 6 || data[0] || data[1] || data[3] || (data[2] != 1 && data[2] != 2)) {
+        return 0;
+    }
+    uint32_t count = data[4] | (static_cast<uint32_t>(data[5]) << 8);
+    return 6 + static_cast<size_t>(count) * 16 <= size ? count : 0;
+}
+
+} // namespace
+
+// DecodeAsync bookkeeping. A task counts as in flight from submission until
+// its closure is destroyed, whether it ran or the pool purged it.
+struct ImageDecoder::AsyncState {
+    std::mutex mutex;
+    std::condition_variable drained;
+    uint32_t inFlight = 0;
+    bool closing = false;
+};
+
+// Held by the task closure; copies share one count
+struct ImageDecoder::AsyncTicket {
+    explicit AsyncTicket(std::shared_ptr<AsyncState> s) : state(std::move(s))
+    {
+        std::lock_guard lock(state->mutex);
+        ++state->inFlight;
+    }
+    ~AsyncTicket()
+    {
+        std::lock_guard lock(state->mutex);
+        if (--state->inFlight == 0) state->drained.notify_all();
+    }
+    AsyncTicket(const AsyncTicket&) = delete;
+    AsyncTicket& operator=(const AsyncTicket&) = delete;
+
+    std::shared_ptr<AsyncState> state;
+};
+
 ImageDecoder::ImageDecoder()
+    : async_(std::make_shared<AsyncState>())
 {
     // Initialize WIC factory
     HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory2, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory_));
@@ -19,34 +423,198 @@ ImageDecoder::ImageDecoder()
     }
 }
 
-ImageDecoder::~ImageDecoder() = default;
+ImageDecoder::~ImageDecoder()
+{
+    // Queued tasks see closing and skip; running ones finish against a live decoder
+    std::unique_lock lock(async_->mutex);
+    async_->closing = true;
+    async_->drained.wait(lock, [this] { return async_->inFlight == 0; });
+}
 
-std::unique_ptr<DecodedImage> ImageDecoder::Decode(const std::filesystem::path& filePath, DecoderFlags flags)
+std::unique_ptr<DecodedImage> ImageDecoder::Decode(const std::filesystem::path& filePath, DecoderFlags flags,
+                                                   const RowBandCallback& onBand)
 {
     if (!IsSupportedFormat(filePath)) {
         return nullptr;
     }
 
-    // Check if we should use memory mapping for large files
+    if (IsRawFormat(filePath)) {
+        return DecodeRAW(filePath, 0);
+    }
+
+    if (HasFlag(flags, DecoderFlags::HighBitDepth)) {
+        if (auto image = DecodeHighBitDepth(filePath)) {
+            return image;
+        }
+    }
+
+    // Large files: map instead of reading (covers the native codecs too)
     if (HasFlag(flags, DecoderFlags::MemoryMapped)) {
-        uintmax_t fileSize = std::filesystem::file_size(filePath);
-        if (fileSize > 50 * 1024 * 1024) { // 50MB threshold
-            return DecodeMemoryMapped(filePath, flags);
+        std::error_code ec;
+        uintmax_t fileSize = std::filesystem::file_size(filePath, ec);
+        if (!ec && fileSize > kMemoryMappedThreshold) {
+            return DecodeMemoryMapped(filePath, flags, onBand);
+        }
+    }
+
+    if (UseNative(filePath)) {
+        auto image = DecodeNative(filePath, 0);
+        if (image || backend_ == DecodeBackend::Native) {
+            return image;
         }
     }
 
     return DecodeWithWIC(filePath, flags);
 }
 
-void ImageDecoder::DecodeAsync(const std::filesystem::path& filePath,
+void ImageDecoder::DecodeAsync(ThreadPool& pool,
+                               const std::filesystem::path& filePath,
                                std::function<void(std::unique_ptr<DecodedImage>)> callback,
+                               TaskPriority priority,
+                               std::stop_token cancel,
                                DecoderFlags flags)
 {
-    // Launch async decoding in background thread
-    std::thread([this, filePath, callback, flags]() {
-        auto image = this->Decode(filePath, flags);
-        callback(std::move(image));
-    }).detach();
+    auto ticket = std::make_shared<AsyncTicket>(async_);
+    pool.Submit([this, ticket, filePath, cb = std::move(callback), cancel, flags]() {
+        {
+            std::lock_guard lock(ticket->state->mutex);
+            if (ticket->state->closing) return;
+        }
+        if (cancel.stop_requested()) return;
+
+        auto image = Decode(filePath, flags);
+        if (cancel.stop_requested()) return;
+        if (cb) cb(std::move(image));
+    }, priority);
+}
+
+std::vector<size_t> ImageDecoder::DiskOrder(const std::vector<std::filesystem::path>& paths)
+{
+    std::vector<DiskLocation> locations(paths.size());
+    std::unordered_map<std::wstring, bool> remoteRoots;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        // Network volumes don't expose their layout; a query is a round trip
+        if (!IsRemotePath(paths[i], remoteRoots)) {
+            locations[i] = QueryDiskLocation(paths[i]);
+        }
+    }
+
+    std::vector<size_t> order(paths.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const DiskLocation& la = locations[a];
+        const DiskLocation& lb = locations[b];
+        if (la.volume != lb.volume) return la.volume < lb.volume;
+        if (la.tier != lb.tier) return la.tier < lb.tier;
+        if (la.key != lb.key) return la.key < lb.key;
+        if (paths[a] != paths[b]) return paths[a] < paths[b];
+        return a < b;
+    });
+    return order;
+}
+
+void ImageDecoder::DecodeBatch(ThreadPool& pool,
+                               const std::vector<std::filesystem::path>& paths,
+                               const BatchSink& sink,
+                               uint32_t maxDimension,
+                               TaskPriority priority,
+                               std::stop_token cancel)
+{
+    // Read-ahead accounting; a file is released when its task closure dies,
+    // so tasks the pool purges unrun don't stall the reader
+    struct BatchState {
+        std::mutex mutex;
+        std::condition_variable released;
+        size_t bytesInFlight = 0;
+        uint32_t filesInFlight = 0;
+    };
+    struct BatchTicket {
+        BatchTicket(std::shared_ptr<BatchState> s, size_t b) : state(std::move(s)), bytes(b) {}
+        ~BatchTicket()
+        {
+            std::lock_guard lock(state->mutex);
+            state->bytesInFlight -= bytes;
+            --state->filesInFlight;
+            state->released.notify_all();
+        }
+        BatchTicket(const BatchTicket&) = delete;
+        BatchTicket& operator=(const BatchTicket&) = delete;
+
+        std::shared_ptr<BatchState> state;
+        size_t bytes;
+    };
+
+    auto state = std::make_shared<BatchState>();
+    for (size_t index : DiskOrder(paths)) {
+        if (cancel.stop_requested()) break;
+        const std::filesystem::path& filePath = paths[index];
+
+        {
+            std::unique_lock lock(state->mutex);
+            state->released.wait(lock, [&] {
+                return state->filesInFlight == 0 || state->bytesInFlight < kBatchReadAheadBytes;
+            });
+        }
+
+        // RAW files only need their preview, which the decoder maps in
+        // itself; a failed read is retried by path on the worker
+        auto bytes = std::make_shared<std::vector<uint8_t>>();
+        if (!IsRawFormat(filePath) && IsSupportedFormat(filePath) && !ReadWholeFile(filePath, *bytes)) {
+            bytes->clear();
+        }
+
+        auto ticket = std::make_shared<BatchTicket>(state, bytes->size());
+        {
+            std::lock_guard lock(state->mutex);
+            state->bytesInFlight += bytes->size();
+            ++state->filesInFlight;
+        }
+
+        auto asyncTicket = std::make_shared<AsyncTicket>(async_);
+        pool.Submit([this, asyncTicket, ticket, bytes, &filePath, &sink, index, maxDimension, cancel]() {
+            {
+                std::lock_guard lock(asyncTicket->state->mutex);
+                if (asyncTicket->state->closing) return;
+            }
+            if (cancel.stop_requested()) return;
+
+            std::unique_ptr<DecodedImage> image;
+            if (!bytes->empty()) {
+                image = DecodeBuffer(filePath, *bytes, maxDimension);
+            } else if (maxDimension > 0) {
+                image = GenerateThumbnail(filePath, maxDimension);
+            } else {
+                image = Decode(filePath);
+            }
+            if (sink) sink(index, std::move(image));
+        }, priority);
+    }
+
+    // paths and sink are borrowed by the queued tasks
+    std::unique_lock lock(state->mutex);
+    state->released.wait(lock, [&] { return state->filesInFlight == 0; });
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeBuffer(const std::filesystem::path& filePath,
+                                                         std::vector<uint8_t>& bytes,
+                                                         uint32_t maxDimension)
+{
+    if (UseNative(filePath)) {
+        auto image = DecodeNativeBytes(filePath, bytes, maxDimension);
+        if (image || backend_ == DecodeBackend::Native) {
+            return image;
+        }
+    }
+
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    if (FAILED(wicFactory_->CreateStream(&stream)) ||
+        FAILED(stream->InitializeFromMemory(bytes.data(), static_cast<DWORD>(bytes.size()))) ||
+        FAILED(wicFactory_->CreateDecoderFromStream(stream.Get(), nullptr,
+                                                    WICDecodeMetadataCacheOnDemand, &decoder))) {
+        return nullptr;
+    }
+    return DecodeWicFrame(decoder.Get(), filePath, maxDimension, ReadOrientation(bytes.data(), bytes.size()));
 }
 
 std::optional<ImageInfo> ImageDecoder::GetImageInfo(const std::filesystem::path& filePath)
@@ -55,6 +623,39 @@ std::optional<ImageInfo> ImageDecoder::GetImageInfo(const std::filesystem::path&
         return std::nullopt;
     }
 
+    if (IsRawFormat(filePath)) {
+        MemoryMappedFile file(filePath);
+        RawPreview preview;
+        if (!file.Map() || !FindRawPreview(file.GetData(), file.GetSize(), preview)) {
+            return std::nullopt;
+        }
+        ImageInfo info = {};
+        info.width = preview.width;
+        info.height = preview.height;
+        if (preview.orientation >= 5 && preview.orientation <= 8) {
+            std::swap(info.width, info.height);
+        }
+        info.bitsPerPixel = 24;
+        info.pixelFormat = GUID_WICPixelFormatDontCare;
+        return info;
+    }
+
+    // Header probe first: a few KB read, no WIC decoder construction
+    ImageProbeResult probe;
+    if (ProbeFile(filePath, probe)) {
+        ImageInfo info = {};
+        info.width = probe.width;
+        info.height = probe.height;
+        if (probe.orientation >= 5 && probe.orientation <= 8) {
+            std::swap(info.width, info.height);
+        }
+        info.bitsPerPixel = static_cast<uint32_t>(probe.bitDepth) * probe.channels;
+        info.pixelFormat = GUID_WICPixelFormatDontCare;
+        info.hasAlpha = probe.channels == 2 || probe.channels == 4;
+        info.isHDR = probe.bitDepth > 8;
+        return info;
+    }
+
     Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
     HRESULT hr = wicFactory_->CreateDecoderFromFilename(
         filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
@@ -73,20 +674,31 @@ std::optional<ImageInfo> ImageDecoder::GetImageInfo(const std::filesystem::path&
     frame->GetSize(&info.width, &info.height);
     frame->GetPixelFormat(&info.pixelFormat);
 
-    // Get bits per pixel
+    // Get bits per pixel (probe callers only need the size, so tolerate failure)
     Microsoft::WRL::ComPtr<IWICComponentInfo> componentInfo;
-    wicFactory_->CreateComponentInfo(info.pixelFormat, &componentInfo);
-
     Microsoft::WRL::ComPtr<IWICPixelFormatInfo2> formatInfo;
-    componentInfo->QueryInterface(IID_PPV_ARGS(&formatInfo));
-
-    formatInfo->GetBitsPerPixel(&info.bitsPerPixel);
+    if (SUCCEEDED(wicFactory_->CreateComponentInfo(info.pixelFormat, &componentInfo)) &&
+        SUCCEEDED(componentInfo->QueryInterface(IID_PPV_ARGS(&formatInfo)))) {
+        formatInfo->GetBitsPerPixel(&info.bitsPerPixel);
+    }
+    info.isHDR = QueryFormatDepth(wicFactory_.Get(), info.pixelFormat).deep;
 
     return info;
 }
 
 std::unique_ptr<DecodedImage> ImageDecoder::GenerateThumbnail(const std::filesystem::path& filePath, uint32_t maxSize)
 {
+    if (IsRawFormat(filePath)) {
+        return DecodeRAW(filePath, maxSize);
+    }
+
+    if (UseNative(filePath)) {
+        auto image = DecodeNative(filePath, maxSize);
+        if (image || backend_ == DecodeBackend::Native) {
+            return image;
+        }
+    }
+
     Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
     HRESULT hr = wicFactory_->CreateDecoderFromFilename(
         filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
@@ -95,8 +707,17 @@ std::unique_ptr<DecodedImage> ImageDecoder::GenerateThumbnail(const std::filesys
         return nullptr;
     }
 
+    return DecodeWicFrame(decoder.Get(), filePath, maxSize, ReadOrientation(filePath));
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeWicFrame(IWICBitmapDecoder* decoder,
+                                                           const std::filesystem::path& filePath,
+                                                           uint32_t maxDimension,
+                                                           uint16_t orientation,
+                                                           uint32_t frameIndex)
+{
     Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame(0, &frame);
+    HRESULT hr = decoder->GetFrame(frameIndex, &frame);
     if (FAILED(hr)) {
         return nullptr;
     }
@@ -105,32 +726,43 @@ std::unique_ptr<DecodedImage> ImageDecoder::GenerateThumbnail(const std::filesys
     uint32_t width, height;
     frame->GetSize(&width, &height);
 
-    // Calculate thumbnail size maintaining aspect ratio
-    uint32_t thumbWidth, thumbHeight;
-    if (width > height) {
-        thumbWidth = maxSize;
-        thumbHeight = static_cast<uint32_t>((static_cast<float>(height) / width) * maxSize);
-    } else {
-        thumbHeight = maxSize;
-        thumbWidth = static_cast<uint32_t>((static_cast<float>(width) / height) * maxSize);
+    if (width == 0 || height == 0) {
+        return nullptr;
     }
 
-    // Create thumbnail
-    Microsoft::WRL::ComPtr<IWICBitmapScaler> scaler;
-    wicFactory_->CreateBitmapScaler(&scaler);
+    uint32_t thumbWidth = width, thumbHeight = height;
+    if (maxDimension > 0) {
+        FitWithin(width, height, maxDimension, thumbWidth, thumbHeight);
+    }
 
-    scaler->Initialize(frame.Get(), thumbWidth, thumbHeight, WICBitmapInterpolationModeFant);
+    // Fant does the bulk of a big reduction (codecs can shortcut it, e.g.
+    // JPEG DCT scaling); the last 2x or less goes through the linear-light
+    // resampler, which keeps thumbnail highlights and texture intact
+    uint32_t stageWidth = width, stageHeight = height;
+    if (width > thumbWidth * 2 || height > thumbHeight * 2) {
+        stageWidth = std::min(width, thumbWidth * 2);
+        stageHeight = std::min(height, thumbHeight * 2);
+    }
 
-    // Convert to 32-bit BGRA
-    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-    wicFactory_->CreateFormatConverter(&converter);
+    Microsoft::WRL::ComPtr<IWICBitmapSource> source = frame;
+    if (stageWidth != width || stageHeight != height) {
+        Microsoft::WRL::ComPtr<IWICBitmapScaler> scaler;
+        wicFactory_->CreateBitmapScaler(&scaler);
+        scaler->Initialize(frame.Get(), stageWidth, stageHeight, WICBitmapInterpolationModeFant);
+        source = scaler;
+    }
 
-    converter->Initialize(
-        scaler.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    // Convert to 32-bit premultiplied BGRA
+    PBGRAReader reader;
+    if (!reader.Initialize(wicFactory_.Get(), source.Get())) {
+        return nullptr;
+    }
 
     // Allocate buffer
     auto image = std::make_unique<DecodedImage>();
     image->sourcePath = filePath;
+    image->sourceWidth = width;
+    image->sourceHeight = height;
     image->info.width = thumbWidth;
     image->info.height = thumbHeight;
     image->info.pixelFormat = GUID_WICPixelFormat32bppPBGRA;
@@ -141,16 +773,265 @@ std::unique_ptr<DecodedImage> ImageDecoder::GenerateThumbnail(const std::filesys
     }
     image->data = std::make_unique<uint8_t[]>(image->info.dataSize);
 
-    // Copy pixels
-    hr = converter->CopyPixels(nullptr, thumbWidth * 4, static_cast<UINT>(image->info.dataSize), image->data.get());
+    bool oriented = false;
+    if (stageWidth == thumbWidth && stageHeight == thumbHeight && orientation >= 2 && orientation <= 8 &&
+        reader.CanCopyOriented()) {
+        // Convert and orient the raw rows in one pass instead of converting
+        // here and orienting in a second full pass
+        hr = reader.CopyOriented(orientation, image->data.get());
+        SwapOrientedSize(*image, orientation);
+        oriented = true;
+    } else if (stageWidth == thumbWidth && stageHeight == thumbHeight) {
+        hr = CopyAllRows(reader, image->data.get());
+    } else {
+        auto stage = std::make_unique_for_overwrite<uint8_t[]>(static_cast<size_t>(stageWidth) * stageHeight * 4);
+        hr = CopyAllRows(reader, stage.get());
+        if (SUCCEEDED(hr)) {
+            ResampleBGRA(stage.get(), stageWidth, stageHeight, image->data.get(), thumbWidth, thumbHeight);
+        }
+    }
 
     if (FAILED(hr)) {
         return nullptr;
     }
 
+    if (!oriented) {
+        OrientImage(*image, orientation);
+    }
     return image;
 }
 
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeExifThumbnail(const std::filesystem::path& filePath,
+                                                                uint16_t& orientation)
+{
+    orientation = 1;
+
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    if (ext != L".jpg" && ext != L".jpeg") {
+        return nullptr;
+    }
+
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::file_size(filePath, ec);
+    if (ec || fileSize == 0) {
+        return nullptr;
+    }
+
+    MemoryMappedFile head(filePath);
+    if (!head.MapRegion(0, static_cast<size_t>(std::min<uintmax_t>(fileSize, kExifWindowBytes)))) {
+        return nullptr;
+    }
+
+    ExifInfo exif;
+    if (!ReadExif(head.GetData(), head.GetSize(), exif)) {
+        return nullptr;
+    }
+    orientation = exif.orientation;
+    if (exif.thumbnailLength == 0) {
+        return nullptr;
+    }
+
+    JpegCodec jpeg;
+    CodecImage thumb;
+    if (!jpeg.Decode(head.GetData() + exif.thumbnailOffset, exif.thumbnailLength, 0, thumb)) {
+        return nullptr;
+    }
+
+    // Cameras letterbox the fixed 160x120 thumbnail for 3:2 and 16:9 frames:
+    // crop the bars using the main frame's aspect when its header is in view
+    uint32_t mainWidth = 0, mainHeight = 0;
+    uint32_t cropX = 0, cropY = 0, cropW = thumb.width, cropH = thumb.height;
+    if (jpeg.ReadSize(head.GetData(), head.GetSize(), mainWidth, mainHeight)) {
+        uint64_t thumbCross = static_cast<uint64_t>(thumb.width) * mainHeight;
+        uint64_t mainCross = static_cast<uint64_t>(mainWidth) * thumb.height;
+        if (thumbCross > mainCross + mainHeight) {
+            cropW = std::max(1u, static_cast<uint32_t>((static_cast<uint64_t>(thumb.height) * mainWidth + mainHeight / 2) / mainHeight));
+            cropX = (thumb.width - cropW) / 2;
+        } else if (mainCross > thumbCross + mainWidth) {
+            cropH = std::max(1u, static_cast<uint32_t>((static_cast<uint64_t>(thumb.width) * mainHeight + mainWidth / 2) / mainWidth));
+            cropY = (thumb.height - cropH) / 2;
+        }
+    } else {
+        mainWidth = thumb.width;
+        mainHeight = thumb.height;
+    }
+
+    // Crop and orientation in a single pass: the crop is just where the
+    // source rows start
+    std::unique_ptr<uint8_t[]> pixels;
+    uint32_t width = cropW, height = cropH;
+    if (cropW == thumb.width && cropH == thumb.height && (orientation < 2 || orientation > 8)) {
+        pixels = std::move(thumb.pixels);
+    } else {
+        pixels = std::make_unique_for_overwrite<uint8_t[]>(static_cast<size_t>(cropW) * cropH * 4);
+        const uint8_t* origin = thumb.pixels.get() + (static_cast<size_t>(cropY) * thumb.width + cropX) * 4;
+        ConvertOriented(Simd::PixelLayout::PBGRA32, origin, static_cast<size_t>(thumb.width) * 4,
+                        cropW, cropH, orientation, pixels.get());
+        if (orientation >= 5 && orientation <= 8) {
+            std::swap(width, height);
+            std::swap(mainWidth, mainHeight);
+        }
+    }
+
+    auto image = std::make_unique<DecodedImage>();
+    image->data = std::move(pixels);
+    image->sourcePath = filePath;
+    image->sourceWidth = mainWidth;
+    image->sourceHeight = mainHeight;
+    image->info.width = width;
+    image->info.height = height;
+    image->info.pixelFormat = GUID_WICPixelFormat32bppPBGRA;
+    image->info.bitsPerPixel = 32;
+    image->info.dataSize = static_cast<size_t>(width) * height * 4;
+    image->info.hasAlpha = true;
+    image->info.isHDR = false;
+    return image;
+}
+
+std::shared_ptr<TiledImageSource> ImageDecoder::OpenTiled(const std::filesystem::path& filePath)
+{
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    uint16_t orientation = 1;
+    HRESULT hr = S_OK;
+    if (IsRawFormat(filePath)) {
+        // Tiles come from the embedded preview: a stream over just its bytes
+        RawPreview preview;
+        {
+            MemoryMappedFile file(filePath);
+            if (!file.Map() || !FindRawPreview(file.GetData(), file.GetSize(), preview)) {
+                return nullptr;
+            }
+        }
+        ULARGE_INTEGER offset = {}, length = {};
+        offset.QuadPart = preview.offset;
+        length.QuadPart = preview.length;
+        Microsoft::WRL::ComPtr<IWICStream> fileStream, previewStream;
+        if (FAILED(wicFactory_->CreateStream(&fileStream)) ||
+            FAILED(fileStream->InitializeFromFilename(filePath.c_str(), GENERIC_READ)) ||
+            FAILED(wicFactory_->CreateStream(&previewStream)) ||
+            FAILED(previewStream->InitializeFromIStreamRegion(fileStream.Get(), offset, length))) {
+            return nullptr;
+        }
+        hr = wicFactory_->CreateDecoderFromStream(previewStream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder);
+        orientation = preview.orientation;
+    } else {
+        hr = wicFactory_->CreateDecoderFromFilename(
+            filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+        orientation = ReadOrientation(filePath);
+    }
+    if (FAILED(hr)) {
+        return nullptr;
+    }
+
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr)) {
+        return nullptr;
+    }
+
+    uint32_t width = 0, height = 0;
+    frame->GetSize(&width, &height);
+    if (width == 0 || height == 0) {
+        return nullptr;
+    }
+
+    return std::make_shared<TiledImageSource>(wicFactory_, std::move(decoder), std::move(frame), width, height,
+                                              orientation);
+}
+
+std::unique_ptr<AnimationDecoder> ImageDecoder::OpenAnimation(const std::filesystem::path& filePath,
+                                                              uint32_t maxDimension)
+{
+    if (!IsAnimatedFormat(filePath)) return nullptr;
+    return AnimationDecoder::Open(wicFactory_.Get(), filePath, maxDimension);
+}
+
+uint32_t ImageDecoder::GetPageCount(const std::filesystem::path& filePath)
+{
+    if (!IsMultiPageFormat(filePath)) return 1;
+
+    // The view is only touched where the headers are: ICONDIR, or the TIFF
+    // header and each page's IFD
+    MemoryMappedFile file(filePath);
+    if (!file.Map()) return 1;
+
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    uint32_t count = ext == L".ico" ? CountIconImages(file.GetData(), file.GetSize())
+                                    : CountTiffPages(file.GetData(), file.GetSize());
+    return std::max(count, 1u);
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodePage(const std::filesystem::path& filePath,
+                                                       uint32_t page, uint32_t maxDimension)
+{
+    if (page == 0) {
+        return maxDimension > 0 ? GenerateThumbnail(filePath, maxDimension) : Decode(filePath);
+    }
+
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    UINT frameCount = 0;
+    if (FAILED(wicFactory_->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ,
+                                                      WICDecodeMetadataCacheOnDemand, &decoder)) ||
+        FAILED(decoder->GetFrameCount(&frameCount)) || page >= frameCount) {
+        return nullptr;
+    }
+
+    // Each TIFF page carries its own orientation tag; icons have none
+    uint16_t orientation = 1;
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    if (ext != L".ico") {
+        MemoryMappedFile file(filePath);
+        if (file.Map()) {
+            orientation = TiffPageOrientation(file.GetData(), file.GetSize(), page);
+        }
+    }
+    return DecodeWicFrame(decoder.Get(), filePath, maxDimension, orientation, page);
+}
+
+bool ImageDecoder::UseNative(const std::filesystem::path& filePath) const
+{
+    if (backend_ == DecodeBackend::WIC) {
+        return false;
+    }
+
+    // Extension gate so PNG/WebP/... aren't read into memory just to be sniffed
+    static const std::vector<std::wstring> extensions = {L".jpg", L".jpeg", L".bmp", L".tif", L".tiff"};
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeNative(const std::filesystem::path& filePath, uint32_t maxDimension)
+{
+    std::vector<uint8_t> bytes;
+    if (!ReadWholeFile(filePath, bytes)) {
+        return nullptr;
+    }
+    return DecodeNativeBytes(filePath, bytes, maxDimension);
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeNativeBytes(const std::filesystem::path& filePath,
+                                                              std::vector<uint8_t>& bytes,
+                                                              uint32_t maxDimension)
+{
+    const ImageCodec* codec = codecs_.Find(bytes.data(), bytes.size());
+    if (!codec) {
+        return nullptr;
+    }
+
+    CodecImage decoded;
+    if (!codec->Decode(bytes.data(), bytes.size(), maxDimension, decoded)) {
+        return nullptr;
+    }
+    const uint16_t orientation = ReadOrientation(bytes.data(), bytes.size());
+    std::vector<uint8_t>().swap(bytes);
+
+    return FromCodecImage(filePath, decoded, maxDimension, orientation);
+}
+
 bool ImageDecoder::IsSupportedFormat(const std::filesystem::path& filePath)
 {
     static const std::vector<std::wstring> extensions = {
@@ -159,12 +1040,38 @@ bool ImageDecoder::IsSupportedFormat(const std::filesystem::path& filePath)
     std::wstring ext = filePath.extension().wstring();
     Simd::ToLowerInPlace(ext);
 
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end() || IsRawFormat(filePath);
+}
+
+bool ImageDecoder::IsRawFormat(const std::filesystem::path& filePath)
+{
+    static const std::vector<std::wstring> extensions = {
+        L".cr2", L".nef", L".nrw", L".arw", L".dng", L".pef", L".srw"};
+
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+
     return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
 }
 
+bool ImageDecoder::IsAnimatedFormat(const std::filesystem::path& filePath)
+{
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    return ext == L".gif" || ext == L".webp";
+}
+
+bool ImageDecoder::IsMultiPageFormat(const std::filesystem::path& filePath)
+{
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    return ext == L".tif" || ext == L".tiff" || ext == L".ico";
+}
+
 std::vector<std::wstring> ImageDecoder::GetSupportedExtensions()
 {
-    return {L"*.jpg", L"*.jpeg", L"*.png", L"*.bmp", L"*.gif", L"*.tiff", L"*.tif", L"*.webp", L"*.ico", L"*.jxr"};
+    return {L"*.jpg", L"*.jpeg", L"*.png", L"*.bmp", L"*.gif", L"*.tiff", L"*.tif", L"*.webp", L"*.ico", L"*.jxr",
+            L"*.cr2", L"*.nef", L"*.nrw", L"*.arw", L"*.dng", L"*.pef", L"*.srw"};
 }
 
 std::unique_ptr<DecodedImage> ImageDecoder::DecodeWithWIC(const std::filesystem::path& filePath, DecoderFlags flags)
@@ -190,18 +1097,12 @@ std::unique_ptr<DecodedImage> ImageDecoder::DecodeWithWIC(const std::filesystem:
 
     frame->GetSize(&image->info.width, &image->info.height);
     frame->GetPixelFormat(&image->info.pixelFormat);
+    image->sourceWidth = image->info.width;
+    image->sourceHeight = image->info.height;
 
-    // Check if format conversion is needed
-    WICPixelFormatGUID targetFormat = GUID_WICPixelFormat32bppPBGRA;
-
-    // Convert to 32-bit BGRA for GPU compatibility
-    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-    wicFactory_->CreateFormatConverter(&converter);
-
-    hr = converter->Initialize(
-        frame.Get(), targetFormat, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
-
-    if (FAILED(hr)) {
+    // Convert to 32-bit premultiplied BGRA for GPU compatibility
+    PBGRAReader reader;
+    if (!reader.Initialize(wicFactory_.Get(), frame.Get())) {
         return nullptr;
     }
 
@@ -212,11 +1113,8 @@ std::unique_ptr<DecodedImage> ImageDecoder::DecodeWithWIC(const std::filesystem:
     }
     image->data = std::make_unique<uint8_t[]>(image->info.dataSize);
 
-    const UINT stride = image->info.width * 4;
-    const UINT bufferSize = static_cast<UINT>(image->info.dataSize);
-
     // Copy pixels
-    hr = converter->CopyPixels(nullptr, stride, bufferSize, image->data.get());
+    hr = CopyAllRows(reader, image->data.get());
 
     if (FAILED(hr)) {
         return nullptr;
@@ -226,26 +1124,211 @@ std::unique_ptr<DecodedImage> ImageDecoder::DecodeWithWIC(const std::filesystem:
     image->info.hasAlpha = true;
     image->info.isHDR = false;
 
+    OrientImage(*image, ReadOrientation(filePath));
     return image;
 }
 
-std::unique_ptr<DecodedImage> ImageDecoder::DecodeRAW(const std::filesystem::path& filePath, DecoderFlags flags)
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeHighBitDepth(const std::filesystem::path& filePath)
 {
-    // TODO: Implement RAW decoding with libraw
-    return nullptr;
+    // The formats WIC decodes at over 8 bits per channel
+    static const std::vector<std::wstring> extensions = {L".png", L".tif", L".tiff", L".jxr"};
+    std::wstring ext = filePath.extension().wstring();
+    Simd::ToLowerInPlace(ext);
+    if (std::find(extensions.begin(), extensions.end(), ext) == extensions.end()) {
+        return nullptr;
+    }
+
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    WICPixelFormatGUID format = {};
+    if (FAILED(wicFactory_->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ,
+                                                      WICDecodeMetadataCacheOnDemand, &decoder)) ||
+        FAILED(decoder->GetFrame(0, &frame)) ||
+        FAILED(frame->GetPixelFormat(&format)) ||
+        !QueryFormatDepth(wicFactory_.Get(), format).deep) {
+        return nullptr;
+    }
+
+    uint32_t width = 0, height = 0;
+    frame->GetSize(&width, &height);
+    const size_t dataSize = static_cast<size_t>(width) * height * 8;
+    if (dataSize == 0 || dataSize > std::numeric_limits<UINT>::max()) {
+        return nullptr;
+    }
+
+    // OrientBGRA only moves 32-bit pixels; WIC turns these while converting
+    Microsoft::WRL::ComPtr<IWICBitmapSource> source = frame;
+    const uint16_t orientation = ReadOrientation(filePath);
+    if (orientation >= 2 && orientation <= 8) {
+        Microsoft::WRL::ComPtr<IWICBitmapFlipRotator> rotator;
+        if (FAILED(wicFactory_->CreateBitmapFlipRotator(&rotator)) ||
+            FAILED(rotator->Initialize(frame.Get(), OrientationTransform(orientation)))) {
+            return nullptr;
+        }
+        source = rotator;
+    }
+
+    // Integer sources are linearized from sRGB on the way to half floats
+    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+    if (FAILED(wicFactory_->CreateFormatConverter(&converter)) ||
+        FAILED(converter->Initialize(source.Get(), GUID_WICPixelFormat64bppPRGBAHalf, WICBitmapDitherTypeNone,
+                                     nullptr, 0.0, WICBitmapPaletteTypeCustom))) {
+        return nullptr;
+    }
+
+    auto image = std::make_unique<DecodedImage>();
+    image->sourcePath = filePath;
+    converter->GetSize(&image->info.width, &image->info.height);
+    image->sourceWidth = image->info.width;
+    image->sourceHeight = image->info.height;
+    image->info.pixelFormat = GUID_WICPixelFormat64bppPRGBAHalf;
+    image->info.bitsPerPixel = 64;
+    image->info.dataSize = dataSize;
+    image->info.hasAlpha = true;
+    image->info.isHDR = true;
+    image->data = std::make_unique_for_overwrite<uint8_t[]>(dataSize);
+
+    // One call: a rotating source would otherwise decode the frame per band
+    if (FAILED(converter->CopyPixels(nullptr, image->info.width * 8, static_cast<UINT>(dataSize),
+                                     image->data.get()))) {
+        return nullptr;
+    }
+    return image;
+}
+
+std::unique_ptr<DecodedImage> ImageDecoder::DecodeRAW(const std::filesystem::path& filePath, uint32_t maxDimension)
+{
+    MemoryMappedFile file(filePath);
+    if (!file.Map() || file.GetSize() == 0) {
+        return nullptr;
+    }
+
+    RawPreview preview;
+    if (!FindRawPreview(file.GetData(), file.GetSize(), preview)) {
+        return nullptr;
+    }
+
+    // Previews are plain baseline/progressive JPEGs: the native codec takes
+    // them whatever the backend, with DCT scaling for thumbnails
+    JpegCodec jpeg;
+    CodecImage decoded;
+    if (!jpeg.Decode(file.GetData() + preview.offset, preview.length, maxDimension, decoded)) {
+        return nullptr;
+    }
+    return FromCodecImage(filePath, decoded, maxDimension, preview.orientation);
 }
 
 std::unique_ptr<DecodedImage> ImageDecoder::DecodeMemoryMapped(const std::filesystem::path& filePath,
-                                                               DecoderFlags flags)
+                                                               DecoderFlags flags,
+                                                               const RowBandCallback& onBand)
 {
-    // TODO: Implement memory-mapped file decoding
-    // This requires:
-    // 1. CreateFileMapping with PAGE_READONLY
-    // 2. MapViewOfFile with proper alignment
-    // 3. Parse image format directly from mapped memory
-    // 4. Return DecodedImage with pointer to mapped view
+    MemoryMappedFile file(filePath);
+    if (!file.Map() || file.GetSize() == 0) {
+        return nullptr;
+    }
+
+    // Decoders walk the file front to back: queue read-ahead for the whole
+    // view so page faults hit the cache instead of the disk
+    WIN32_MEMORY_RANGE_ENTRY range = {};
+    range.VirtualAddress = const_cast<uint8_t*>(file.GetData());
+    range.NumberOfBytes = file.GetSize();
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+
+    // A sideways image only exists upright once it's whole: bands are then
+    // reported as one, after turning
+    const uint16_t orientation = ReadOrientation(file.GetData(), file.GetSize());
+    const bool upright = orientation < 2 || orientation > 8;
 
-    return nullptr;
+    auto image = std::make_unique<DecodedImage>();
+    image->sourcePath = filePath;
+    image->info.pixelFormat = GUID_WICPixelFormat32bppPBGRA;
+    image->info.bitsPerPixel = 32;
+    image->info.hasAlpha = true;
+    image->info.isHDR = false;
+
+    if (UseNative(filePath)) {
+        if (const ImageCodec* codec = codecs_.Find(file.GetData(), file.GetSize())) {
+            CodecImage decoded;
+            if (codec->Decode(file.GetData(), file.GetSize(), 0, decoded)) {
+                image->data = std::move(decoded.pixels);
+                image->info.width = decoded.width;
+                image->info.height = decoded.height;
+                image->info.dataSize = static_cast<size_t>(decoded.width) * decoded.height * 4;
+                image->sourceWidth = decoded.sourceWidth;
+                image->sourceHeight = decoded.sourceHeight;
+                OrientImage(*image, orientation);
+                if (onBand) {
+                    onBand(*image, 0, image->info.height);
+                }
+                return image;
+            }
+        }
+        if (backend_ == DecodeBackend::Native) {
+            return nullptr;
+        }
+    }
+
+    // IWICStream over the view: WIC reads the mapped pages in place
+    if (file.GetSize() > MAXDWORD) {
+        return DecodeWithWIC(filePath, flags);
+    }
+
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    if (FAILED(wicFactory_->CreateStream(&stream)) ||
+        FAILED(stream->InitializeFromMemory(const_cast<BYTE*>(file.GetData()), static_cast<DWORD>(file.GetSize())))) {
+        return nullptr;
+    }
+
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    if (FAILED(wicFactory_->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder))) {
+        return nullptr;
+    }
+
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    if (FAILED(decoder->GetFrame(0, &frame))) {
+        return nullptr;
+    }
+
+    PBGRAReader reader;
+    if (!reader.Initialize(wicFactory_.Get(), frame.Get())) {
+        return nullptr;
+    }
+
+    const uint32_t width = reader.Width(), height = reader.Height();
+    if (width == 0 || height == 0) {
+        return nullptr;
+    }
+
+    const UINT stride = width * 4;
+    image->info.width = width;
+    image->info.height = height;
+    image->info.dataSize = static_cast<size_t>(stride) * height;
+    image->sourceWidth = width;
+    image->sourceHeight = height;
+    if (image->info.dataSize > std::numeric_limits<UINT>::max()) {
+        return nullptr;
+    }
+
+    // Every byte is written by the reader: skip the zero fill
+    image->data = std::make_unique_for_overwrite<uint8_t[]>(image->info.dataSize);
+
+    for (uint32_t y = 0; y < height; y += kBandRows) {
+        const uint32_t rows = std::min(kBandRows, height - y);
+        if (FAILED(reader.CopyRows(y, rows, image->data.get() + static_cast<size_t>(y) * stride))) {
+            return nullptr;
+        }
+        if (onBand && upright) {
+            onBand(*image, y, rows);
+        }
+    }
+
+    if (!upright) {
+        OrientImage(*image, orientation);
+        if (onBand) {
+            onBand(*image, 0, image->info.height);
+        }
+    }
+    return image;
 }
 
 } // namespace Core
@@ -1,5 +1,8 @@
 #include "core/ImagePipeline.hpp"
 #include "core/SimdUtils.hpp"
+#include "core/ExifReader.hpp"
+#include "core/ImageProbe.hpp"
+#include "core/Resampler.hpp"
 #include "ui/Theme.hpp"
 #include <algorithm>
 #include <set>
@@ -13,6 +16,98 @@
 namespace UltraImageViewer {
 namespace Core {
 
+static_assert(UI::Theme::ThumbnailMaxPx == kThumbnailLevelPx[kThumbnailLevelCount - 1],
+              "ThumbnailMaxPx must be the top thumbnail level");
+
+// Composited frames decoded ahead of playback, per animation
+static constexpr size_t kAnimationRingFrames = 3;
+
+// Animations resident at once (the viewer's plus visible gallery cells);
+// the least recently drawn one is released past this
+static constexpr size_t kMaxAnimations = 12;
+
+// Pages resident either side of the viewer's document page
+static constexpr uint32_t kDocPageRadius = 1;
+
+static uint64_t DocPageKey(uint32_t page, bool thumbnail)
+{
+    return (static_cast<uint64_t>(page) << 1) | (thumbnail ? 1 : 0);
+}
+
+// Texture format for decoded pixels: half floats from DecoderFlags::HighBitDepth
+static DXGI_FORMAT BitmapFormat(const DecodedImage& image)
+{
+    return image.info.bitsPerPixel == 64 ? DXGI_FORMAT_R16G16B16A16_FLOAT : DXGI_FORMAT_B8G8R8A8_UNORM;
+}
+
+// What a cached bitmap occupies, at its real depth
+static size_t BitmapBytes(ID2D1Bitmap* bitmap)
+{
+    auto sz = bitmap->GetPixelSize();
+    size_t bytesPerPixel = bitmap->GetPixelFormat().format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 8 : 4;
+    return static_cast<size_t>(sz.width) * sz.height * bytesPerPixel;
+}
+
+// Releases a decode reservation unless it was handed on (bytes zeroed)
+struct AdmissionGuard {
+    DecodeAdmission& admission;
+    size_t bytes;
+    ~AdmissionGuard() { admission.Release(bytes); }
+};
+
+// Content fingerprints: CRC-32C in the high half, the size's low 31 bits
+// below, and kWholeFileId set when every byte was hashed. Sampled IDs only
+// pick candidates; only whole-file IDs are trusted to mean "same content".
+static constexpr uint64_t kWholeFileId = 1ull << 31;
+
+static bool IsWholeFileId(uint64_t id) { return (id & kWholeFileId) != 0; }
+
+// Sampled: four 16 KB windows (head, thirds, tail), cheap enough for every
+// file whose size repeats. The head covers the EXIF block, the tail the end
+// of the entropy-coded data. Whole: the entire file, for sampled matches
+// (uncompressed formats can differ only between the windows).
+static uint64_t ComputeContentId(const std::filesystem::path& path, uint64_t fileSize, bool wholeFile)
+{
+    constexpr size_t kSampleBytes = 16 * 1024;
+    constexpr size_t kChunkBytes = 1024 * 1024;
+
+    HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               wholeFile ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) return 0;
+
+    uint32_t crc = 0;
+    bool ok = true;
+    if (wholeFile) {
+        std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(kChunkBytes);
+        for (uint64_t done = 0; ok && done < fileSize; ) {
+            DWORD want = static_cast<DWORD>(std::min<uint64_t>(kChunkBytes, fileSize - done));
+            DWORD read = 0;
+            ok = ReadFile(hFile, buffer.get(), want, &read, nullptr) && read == want;
+            if (ok) crc = Simd::Crc32c(buffer.get(), read, crc);
+            done += want;
+        }
+    } else {
+        std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(kSampleBytes);
+        uint64_t window = std::min<uint64_t>(kSampleBytes, fileSize);
+        uint64_t offsets[4] = {0, fileSize / 3, fileSize / 3 * 2, fileSize - window};
+        for (uint64_t offset : offsets) {
+            LARGE_INTEGER pos;
+            pos.QuadPart = static_cast<LONGLONG>(std::min(offset, fileSize - window));
+            DWORD read = 0;
+            ok = SetFilePointerEx(hFile, pos, nullptr, FILE_BEGIN) &&
+                 ReadFile(hFile, buffer.get(), static_cast<DWORD>(window), &read, nullptr) && read == window;
+            if (!ok) break;
+            crc = Simd::Crc32c(buffer.get(), read, crc);
+        }
+    }
+    CloseHandle(hFile);
+    if (!ok) return 0;
+
+    uint64_t id = (static_cast<uint64_t>(crc) << 32) | (fileSize & (kWholeFileId - 1)) |
+                  (wholeFile ? kWholeFileId : 0);
+    return id ? id : 1;  // 0 means "not fingerprinted"
+}
+
 ImagePipeline::ImagePipeline() = default;
 
 ImagePipeline::~ImagePipeline()
@@ -21,30 +116,54 @@ ImagePipeline::~ImagePipeline()
 }
 
 void ImagePipeline::Initialize(ImageDecoder* decoder, CacheManager* cache,
-                               Rendering::Direct2DRenderer* renderer)
+                               Rendering::TextureFactory* renderer)
 {
     decoder_ = decoder;
     cache_ = cache;
     renderer_ = renderer;
 
     shutdownRequested_ = false;
+    admission_.SetCapacity(2 * governor_.GetBudget(MemoryTier::FullImage));
     threadPool_ = std::make_unique<ThreadPool>();  // auto thread count
 }
 
 void ImagePipeline::Shutdown()
 {
     shutdownRequested_ = true;
+    admission_.Shutdown();  // wake workers blocked waiting for decode memory
 
     if (threadPool_) {
         threadPool_->PurgeAll();
     }
     threadPool_.reset();  // destructor joins all workers
+    ClearAnimations();
+    ReleaseDocPages();
+    docPageCounts_.clear();
+    {
+        std::lock_guard plock(docPagesMutex_);
+        readyDocPages_.clear();
+    }
+
+    {
+        std::lock_guard slock(schedMutex_);
+        schedQueue_.clear();
+        schedUpdates_.clear();
+    }
 
     ClosePersistentMapping();
 
+    {
+        std::lock_guard tlock(tiledMutex_);
+        tiledSource_.reset();
+        tiledSourcePath_.clear();
+        readyTiles_.clear();
+        tileQueue_.clear();
+    }
+
     {
         std::lock_guard lock(thumbSaveMutex_);
         thumbSaveBuffer_.clear();
+        thumbSaveBytes_ = 0;
     }
 
     std::lock_guard lock(cacheMutex_);
@@ -54,76 +173,718 @@ void ImagePipeline::Shutdown()
     tier2Bytes_ = 0;
     fullImageCache_.clear();
     fullImageCacheBytes_ = 0;
+    previewCache_.clear();
+    previewCacheBytes_ = 0;
+    sourceSizes_.clear();
+    tileCache_.clear();
+    tileCacheBytes_ = 0;
+    pendingTiles_.clear();
     pendingRequests_.clear();
     pendingFullRequests_.clear();
+    pendingPreviews_.clear();
     {
         std::lock_guard readyLock(readyBitmapMutex_);
         readyBitmapQueue_.clear();
     }
 }
 
-Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetBitmap(const std::filesystem::path& path)
+void ImagePipeline::GetBitmapAsync(const std::filesystem::path& path, BitmapCallback callback)
 {
+    if (!threadPool_) return;
+
+    // Check cache first; like GetPreviewAsync, call back outside the lock
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> cached;
     {
         std::lock_guard lock(cacheMutex_);
         auto it = fullImageCache_.find(path);
         if (it != fullImageCache_.end()) {
-            return it->second;
+            governor_.RecordHit(MemoryTier::FullImage);
+            cached = it->second;
+        } else {
+            governor_.RecordMiss(MemoryTier::FullImage);
+            if (pendingFullRequests_.contains(path)) {
+                return;
+            }
+            pendingFullRequests_[path] = true;
         }
     }
+    if (cached) {
+        if (callback) callback(cached);
+        return;
+    }
 
-    auto bitmap = DecodeAndCreateBitmap(path);
-    if (bitmap) {
-        auto sz = bitmap->GetPixelSize();
-        size_t bytes = static_cast<size_t>(sz.width) * sz.height * 4;
+    auto pathCopy = path;
+    threadPool_->Submit([this, pathCopy, cb = std::move(callback)]() mutable {
+        ReadyBitmap ready;
+        ready.path = pathCopy;
+        ready.callback = std::move(cb);
 
-        std::lock_guard lock(cacheMutex_);
-        fullImageCache_[path] = bitmap;
-        fullImageCacheBytes_ += bytes;
-        EvictFullImagesIfNeeded();
-    }
-    return bitmap;
+        // Callers wait on the callback, so this counts as user-initiated and
+        // waits for decode memory rather than giving up.
+        if (!shutdownRequested_.load(std::memory_order_acquire) && decoder_) {
+            AdmissionGuard reservation{admission_, ExpectedDecodeBytes(pathCopy, 0)};
+            if (!admission_.Acquire(reservation.bytes)) {
+                reservation.bytes = 0;
+            } else {
+                auto image = decoder_->Decode(pathCopy, DecoderFlags::ZeroCopy | DecoderFlags::MemoryMapped |
+                                                            DecoderFlags::HighBitDepth);
+                if (image && image->data) {
+                    ready.width = image->info.width;
+                    ready.height = image->info.height;
+                    ready.format = BitmapFormat(*image);
+                    ready.pixels = std::move(image->data);
+                    ready.reservedBytes = reservation.bytes;
+                    reservation.bytes = 0;
+                }
+            }
+        }
+
+        {
+            std::lock_guard lock(readyBitmapMutex_);
+            readyBitmapQueue_.push_back(std::move(ready));
+        }
+    }, TaskPriority::Normal);
 }
 
-void ImagePipeline::GetBitmapAsync(const std::filesystem::path& path, BitmapCallback callback)
+void ImagePipeline::GetPreviewAsync(const std::filesystem::path& path, uint32_t maxDimension,
+                                    PreviewCallback callback, TaskPriority priority)
 {
     if (!threadPool_) return;
 
-    // Check cache first
+    // A cached full image satisfies every stage; a cached preview only the
+    // screen-resolution one. The callback runs after the lock is dropped:
+    // callers re-enter the pipeline (GetSourceSize) from it.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> cached;
+    bool cachedIsFull = false;
+    uint64_t openGen = openGeneration_.load(std::memory_order_acquire);
+    PreviewKey key{path, maxDimension};
+    uint64_t ticket = 0;
     {
         std::lock_guard lock(cacheMutex_);
-        auto it = fullImageCache_.find(path);
-        if (it != fullImageCache_.end()) {
-            if (callback) callback(it->second);
+        auto full = fullImageCache_.find(path);
+        if (full != fullImageCache_.end()) {
+            governor_.RecordHit(MemoryTier::FullImage);
+            cached = full->second;
+            cachedIsFull = true;
+        } else if (maxDimension == 0) {
+            governor_.RecordMiss(MemoryTier::FullImage);
+        } else {
+            auto preview = previewCache_.find(path);
+            if (preview != previewCache_.end()) {
+                auto sz = preview->second->GetPixelSize();
+                if (std::max(sz.width, sz.height) >= maxDimension) {
+                    governor_.RecordHit(MemoryTier::Preview);
+                    cached = preview->second;
+                }
+            }
+            if (!cached) governor_.RecordMiss(MemoryTier::Preview);
+        }
+
+        if (!cached) {
+            // The same decode already queued or running (typically a
+            // neighbour prefetch, then paged to): take it over instead of
+            // decoding twice. Only a queued lower-priority one is replaced,
+            // so the current page doesn't wait behind prefetch.
+            auto& pending = pendingPreviews_[key];
+            bool adopt = pending.ticket != 0 && (pending.started || pending.priority <= priority);
+            pending.openGeneration = openGen;
+            pending.callback = std::move(callback);
+            if (adopt) return;
+            pending.ticket = ticket = ++nextPreviewTicket_;
+            pending.priority = priority;
+            pending.started = false;
+        }
+    }
+    if (cached) {
+        if (callback) callback(cached, cachedIsFull);
+        return;
+    }
+
+    threadPool_->Submit([this, key, ticket]() {
+        // Paged away before this decode started, or superseded: skip it
+        TaskPriority priority = TaskPriority::Normal;
+        {
+            std::lock_guard lock(cacheMutex_);
+            auto it = pendingPreviews_.find(key);
+            if (it == pendingPreviews_.end() || it->second.ticket != ticket) return;
+            if (shutdownRequested_.load(std::memory_order_acquire) || !decoder_ ||
+                it->second.openGeneration != openGeneration_.load(std::memory_order_acquire)) {
+                pendingPreviews_.erase(it);
+                return;
+            }
+            it->second.started = true;
+            priority = it->second.priority;
+        }
+        auto forget = [&] {
+            std::lock_guard lock(cacheMutex_);
+            auto it = pendingPreviews_.find(key);
+            if (it != pendingPreviews_.end() && it->second.ticket == ticket) pendingPreviews_.erase(it);
+        };
+
+        // User-visible stages wait for decode memory; neighbour prefetch
+        // yields instead and is simply re-requested when paged to.
+        AdmissionGuard reservation{admission_, ExpectedDecodeBytes(key.path, key.maxDimension)};
+        bool admitted = priority == TaskPriority::High ? admission_.Acquire(reservation.bytes)
+                                                       : admission_.TryAcquire(reservation.bytes);
+        if (!admitted) {
+            reservation.bytes = 0;
+            forget();
             return;
         }
 
-        if (pendingFullRequests_.contains(path)) {
+        ReadyBitmap ready;
+        ready.path = key.path;
+        ready.isPreview = true;
+        ready.previewMaxDimension = key.maxDimension;
+        ready.previewTicket = ticket;
+
+        std::unique_ptr<DecodedImage> image;
+        if (key.maxDimension == 0) {
+            image = decoder_->Decode(key.path, DecoderFlags::ZeroCopy | DecoderFlags::MemoryMapped |
+                                                   DecoderFlags::HighBitDepth);
+        } else {
+            image = decoder_->GenerateThumbnail(key.path, key.maxDimension);
+        }
+        if (!image || !image->data) {
+            forget();
             return;
         }
-        pendingFullRequests_[path] = true;
+
+        ready.width = image->info.width;
+        ready.height = image->info.height;
+        ready.format = BitmapFormat(*image);
+        ready.pixels = std::move(image->data);
+        ready.sourceWidth = image->sourceWidth;
+        ready.sourceHeight = image->sourceHeight;
+        ready.isFullResolution = key.maxDimension == 0 ||
+                                 (ready.width == ready.sourceWidth && ready.height == ready.sourceHeight);
+        ready.reservedBytes = reservation.bytes;
+        reservation.bytes = 0;
+
+        {
+            std::lock_guard lock(readyBitmapMutex_);
+            readyBitmapQueue_.push_back(std::move(ready));
+        }
+    }, priority);
+}
+
+void ImagePipeline::CancelOpenRequests()
+{
+    openGeneration_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool ImagePipeline::GetSourceSize(const std::filesystem::path& path, uint32_t& width, uint32_t& height) const
+{
+    {
+        std::lock_guard lock(cacheMutex_);
+        auto it = sourceSizes_.find(path);
+        if (it != sourceSizes_.end()) {
+            width = it->second.first;
+            height = it->second.second;
+            return true;
+        }
     }
+    ScannedSize scanned;
+    if (!FindScannedSize(path, scanned)) return false;
+    width = scanned.width;
+    height = scanned.height;
+    return true;
+}
 
-    auto pathCopy = path;
-    threadPool_->Submit([this, pathCopy, cb = std::move(callback)]() mutable {
-        ReadyBitmap ready;
-        ready.path = pathCopy;
-        ready.callback = std::move(cb);
+size_t ImagePipeline::PreviewKeyHash::operator()(const PreviewKey& key) const noexcept
+{
+    size_t h = std::hash<std::filesystem::path>{}(key.path);
+    return h ^ (std::hash<uint32_t>{}(key.maxDimension) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
 
-        if (!shutdownRequested_.load(std::memory_order_acquire) && decoder_) {
-            auto image = decoder_->Decode(pathCopy, DecoderFlags::ZeroCopy);
+size_t ImagePipeline::TileKeyHash::operator()(const TileKey& key) const noexcept
+{
+    size_t h = std::hash<std::filesystem::path>{}(key.path);
+    uint64_t cell = (static_cast<uint64_t>(key.level) << 48) ^
+                    (static_cast<uint64_t>(key.y) << 24) ^ key.x;
+    return h ^ (std::hash<uint64_t>{}(cell) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::RequestTile(const std::filesystem::path& path,
+                                                                 int level, uint32_t tileX, uint32_t tileY)
+{
+    if (!threadPool_) return nullptr;
+
+    TileKey key{path, level, tileX, tileY};
+    {
+        std::lock_guard lock(cacheMutex_);
+        auto it = tileCache_.find(key);
+        if (it != tileCache_.end()) {
+            it->second.lastAccess = std::chrono::steady_clock::now();
+            governor_.RecordHit(MemoryTier::Tiles);
+            return it->second.bitmap;
+        }
+        if (pendingTiles_.contains(key)) return nullptr;
+        pendingTiles_[key] = true;
+        governor_.RecordMiss(MemoryTier::Tiles);
+    }
+
+    uint64_t openGen = openGeneration_.load(std::memory_order_acquire);
+    bool startDrainer = false;
+    {
+        std::lock_guard lock(tiledMutex_);
+        tileQueue_.emplace_back(std::move(key), openGen);
+        startDrainer = !tileDrainerActive_;
+        tileDrainerActive_ = true;
+    }
+    if (startDrainer) {
+        threadPool_->Submit([this] { DrainTileQueue(); }, TaskPriority::High);
+    }
+    return nullptr;
+}
+
+void ImagePipeline::DrainTileQueue()
+{
+    for (;;) {
+        std::pair<TileKey, uint64_t> next;
+        {
+            std::lock_guard lock(tiledMutex_);
+            if (tileQueue_.empty()) {
+                tileDrainerActive_ = false;
+                return;
+            }
+            next = std::move(tileQueue_.front());
+            tileQueue_.pop_front();
+        }
+        TileDecodeTask(next.first, next.second);
+    }
+}
+
+void ImagePipeline::TileDecodeTask(const TileKey& key, uint64_t openGeneration)
+{
+    ReadyTile ready;
+    ready.key = key;
+
+    if (!shutdownRequested_.load(std::memory_order_acquire) && decoder_ &&
+        openGeneration == openGeneration_.load(std::memory_order_acquire)) {
+        std::shared_ptr<TiledImageSource> source;
+        bool open = false;
+        {
+            std::lock_guard lock(tiledMutex_);
+            open = tiledSourcePath_ == key.path;
+            if (open) source = tiledSource_;
+        }
+        if (!open) {
+            // Opening reads the file: keep FlushReadyTiles (UI thread) off
+            // the lock meanwhile, then publish
+            source = decoder_->OpenTiled(key.path);
+            std::lock_guard lock(tiledMutex_);
+            tiledSource_ = source;
+            tiledSourcePath_ = key.path;
+        }
+        if (source && !source->ReadTile(key.level, key.x, key.y, ready.pixels, ready.width, ready.height)) {
+            ready.pixels.reset();
+        }
+    }
+
+    // Always report back (even empty) so the pending marker gets cleared
+    std::lock_guard lock(tiledMutex_);
+    readyTiles_.push_back(std::move(ready));
+}
+
+int ImagePipeline::FlushReadyTiles(int maxCount)
+{
+    std::vector<ReadyTile> batch;
+    {
+        std::lock_guard lock(tiledMutex_);
+        int count = std::min(maxCount, static_cast<int>(readyTiles_.size()));
+        if (count == 0) return 0;
+
+        batch.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            batch.push_back(std::move(readyTiles_.front()));
+            readyTiles_.pop_front();
+        }
+    }
+
+    int created = 0;
+    for (auto& ready : batch) {
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+        if (ready.pixels && renderer_ && ready.width > 0 && ready.height > 0) {
+            bitmap = renderer_->CreateBitmap(ready.width, ready.height, ready.pixels.get());
+        }
+
+        std::lock_guard lock(cacheMutex_);
+        pendingTiles_.erase(ready.key);
+        if (!bitmap) continue;
+
+        TileEntry entry;
+        entry.bitmap = bitmap;
+        entry.bytes = static_cast<size_t>(ready.width) * ready.height * 4;
+        entry.lastAccess = std::chrono::steady_clock::now();
+        tileCacheBytes_ += entry.bytes;
+        tileCache_[ready.key] = std::move(entry);
+        EvictTilesIfNeeded();
+        ++created;
+    }
+    return created;
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::RequestAnimationFrame(const std::filesystem::path& path,
+                                                                           uint32_t maxDimension)
+{
+    if (!threadPool_ || !ImageDecoder::IsAnimatedFormat(path) || stillImages_.contains(path)) {
+        return nullptr;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto it = animations_.find(path);
+    if (it != animations_.end() && maxDimension > it->second->maxDimension) {
+        // Opened for a gallery cell, now wanted larger: reopen unless the
+        // canvas already fit the smaller box
+        uint32_t canvasEdge;
+        {
+            std::lock_guard lock(it->second->mutex);
+            canvasEdge = it->second->canvasEdge;
+        }
+        if (canvasEdge == 0 || canvasEdge > it->second->maxDimension) {
+            it->second->cancelled = true;
+            animations_.erase(it);
+            it = animations_.end();
+        }
+    }
+
+    if (it != animations_.end()) {
+        auto& state = *it->second;
+        state.requested = true;
+        state.lastRequest = now;
+        return state.bitmap;
+    }
+
+    if (animations_.size() >= kMaxAnimations) {
+        auto oldest = std::min_element(animations_.begin(), animations_.end(),
+            [](const auto& a, const auto& b) { return a.second->lastRequest < b.second->lastRequest; });
+        oldest->second->cancelled = true;
+        animations_.erase(oldest);
+    }
+
+    auto state = std::make_shared<AnimationState>();
+    state->maxDimension = maxDimension;
+    state->decoding = true;
+    state->lastRequest = now;
+    animations_.emplace(path, state);
+    threadPool_->Submit([this, state, path] {
+        AnimationDecodeTask(state, path);
+    }, TaskPriority::Normal);
+    return nullptr;
+}
+
+void ImagePipeline::AnimationDecodeTask(const std::shared_ptr<AnimationState>& state,
+                                        const std::filesystem::path& path)
+{
+    if (!state->decoder && !shutdownRequested_.load(std::memory_order_acquire) && !state->cancelled) {
+        auto decoder = decoder_ ? decoder_->OpenAnimation(path, state->maxDimension) : nullptr;
+        std::lock_guard lock(state->mutex);
+        if (!decoder) {
+            state->still = true;
+            state->decoding = false;
+            return;
+        }
+        state->canvasEdge = std::max(decoder->GetCanvasWidth(), decoder->GetCanvasHeight());
+        state->decoder = std::move(decoder);
+    }
+
+    // Top up the ring; the UI thread takes frames off the front meanwhile
+    while (state->decoder && !shutdownRequested_.load(std::memory_order_acquire) && !state->cancelled) {
+        {
+            std::lock_guard lock(state->mutex);
+            if (state->ring.size() >= kAnimationRingFrames) break;
+        }
+        AnimationFrame frame;
+        bool ok = state->decoder->DecodeNext(frame);
+        std::lock_guard lock(state->mutex);
+        if (!ok) {
+            state->ended = true;
+            state->decoder.reset();  // the canvas isn't needed any more
+            break;
+        }
+        state->ring.push_back(std::move(frame));
+    }
+
+    std::lock_guard lock(state->mutex);
+    state->decoding = false;
+}
+
+bool ImagePipeline::AdvanceAnimations(float deltaTime)
+{
+    bool changed = false;
+    for (auto it = animations_.begin(); it != animations_.end(); ) {
+        auto& state = *it->second;
+        state.elapsedMs += deltaTime * 1000.0f;
+        const bool due = !state.bitmap || state.elapsedMs >= static_cast<float>(state.delayMs);
+        if (due && state.bitmap && !state.requested) {
+            // Nothing drew the frame on screen: the poster takes over
+            state.cancelled = true;
+            it = animations_.erase(it);
+            continue;
+        }
+
+        AnimationFrame frame;
+        bool still = false;
+        bool submit = false;
+        {
+            std::lock_guard lock(state.mutex);
+            still = state.still;
+            if (due && !state.ring.empty()) {
+                frame = std::move(state.ring.front());
+                state.ring.pop_front();
+            }
+            if (!state.decoding && !state.ended && !still && state.ring.size() < kAnimationRingFrames) {
+                state.decoding = submit = true;
+            }
+        }
+        if (still) {
+            stillImages_.insert(it->first);
+            it = animations_.erase(it);
+            continue;
+        }
+
+        if (frame.pixels && renderer_) {
+            // One texture per animation, rewritten in place frame after frame
+            bool reuse = false;
+            if (state.bitmap) {
+                auto size = state.bitmap->GetPixelSize();
+                reuse = size.width == frame.width && size.height == frame.height &&
+                        SUCCEEDED(state.bitmap->CopyFromMemory(nullptr, frame.pixels.get(), frame.width * 4));
+            }
+            if (!reuse) {
+                state.bitmap = renderer_->CreateBitmap(frame.width, frame.height, frame.pixels.get());
+            }
+            // Carry a late frame's overshoot into the next delay so the loop
+            // keeps its length, but never enough to skip a frame
+            float overshoot = state.delayMs ? state.elapsedMs - static_cast<float>(state.delayMs) : 0.0f;
+            state.elapsedMs = std::clamp(overshoot, 0.0f, static_cast<float>(frame.delayMs));
+            state.delayMs = frame.delayMs;
+            state.requested = false;
+            changed = true;
+        }
+
+        if (submit && threadPool_) {
+            auto shared = it->second;
+            threadPool_->Submit([this, shared, path = it->first] {
+                AnimationDecodeTask(shared, path);
+            }, TaskPriority::Normal);
+        }
+        ++it;
+    }
+    return changed;
+}
+
+void ImagePipeline::ClearAnimations()
+{
+    for (auto& [path, state] : animations_) {
+        state->cancelled = true;
+    }
+    animations_.clear();
+}
+
+uint32_t ImagePipeline::GetDocPageCount(const std::filesystem::path& path)
+{
+    if (!decoder_ || !ImageDecoder::IsMultiPageFormat(path)) return 1;
+
+    auto it = docPageCounts_.find(path);
+    if (it != docPageCounts_.end()) return it->second;
+    uint32_t count = decoder_->GetPageCount(path);
+    docPageCounts_.emplace(path, count);
+    return count;
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::RequestDocPage(const std::filesystem::path& path,
+                                                                    uint32_t page, uint32_t maxDimension)
+{
+    if (!threadPool_ || maxDimension == 0) return nullptr;
+    FocusDocPage(path, page);
+
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+    if (page > 0) {
+        bitmap = LookupDocPage(page, false, maxDimension, TaskPriority::High);
+    }
+    // Queued behind the page itself, so paging on is usually instant
+    if (page + 1 < GetDocPageCount(path)) {
+        LookupDocPage(page + 1, false, maxDimension, TaskPriority::Normal);
+    }
+    if (page > 1) {
+        LookupDocPage(page - 1, false, maxDimension, TaskPriority::Normal);
+    }
+    return bitmap;
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::RequestDocPageThumbnail(const std::filesystem::path& path,
+                                                                             uint32_t page, uint32_t maxDimension)
+{
+    if (!threadPool_ || maxDimension == 0 || path != docPagesPath_) return nullptr;
+    uint32_t cursor = docPageCursor_.load(std::memory_order_relaxed);
+    if ((page > cursor ? page - cursor : cursor - page) > UI::Theme::DocPageStripRadius) return nullptr;
+    return LookupDocPage(page, true, maxDimension, TaskPriority::Normal);
+}
+
+void ImagePipeline::FocusDocPage(const std::filesystem::path& path, uint32_t page)
+{
+    if (path != docPagesPath_) {
+        ReleaseDocPages();
+        docPagesPath_ = path;
+    }
+    docPageCursor_.store(page, std::memory_order_relaxed);
+
+    for (auto it = docPages_.begin(); it != docPages_.end(); ) {
+        uint32_t entryPage = static_cast<uint32_t>(it->first >> 1);
+        uint32_t radius = (it->first & 1) ? UI::Theme::DocPageStripRadius : kDocPageRadius;
+        if ((entryPage > page ? entryPage - page : page - entryPage) > radius) {
+            docPageBytes_ -= std::min(docPageBytes_, it->second.bytes);
+            it = docPages_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::LookupDocPage(uint32_t page, bool thumbnail,
+                                                                   uint32_t maxDimension, TaskPriority priority)
+{
+    auto& entry = docPages_[DocPageKey(page, thumbnail)];
+    if (entry.bitmap) {
+        governor_.RecordHit(MemoryTier::Preview);
+    }
+    if ((entry.bitmap && entry.maxDimension >= maxDimension) || entry.pending || entry.failed) {
+        return entry.bitmap;
+    }
+    governor_.RecordMiss(MemoryTier::Preview);
+
+    entry.pending = true;
+    uint64_t generation = docPagesGeneration_.load(std::memory_order_acquire);
+    threadPool_->Submit([this, path = docPagesPath_, page, thumbnail, maxDimension, generation, priority] {
+        DocPageDecodeTask(path, page, thumbnail, maxDimension, generation, priority);
+    }, priority);
+    return entry.bitmap;  // smaller decode (or nothing) until the new one lands
+}
+
+void ImagePipeline::DocPageDecodeTask(const std::filesystem::path& path, uint32_t page, bool thumbnail,
+                                      uint32_t maxDimension, uint64_t generation, TaskPriority priority)
+{
+    ReadyDocPage ready;
+    ready.page = page;
+    ready.thumbnail = thumbnail;
+    ready.maxDimension = maxDimension;
+    ready.generation = generation;
+
+    // Paged past before the decode started: skip it, the request comes back
+    // if the page does
+    uint32_t cursor = docPageCursor_.load(std::memory_order_relaxed);
+    uint32_t radius = thumbnail ? UI::Theme::DocPageStripRadius : kDocPageRadius;
+    bool wanted = !shutdownRequested_.load(std::memory_order_acquire) && decoder_ &&
+                  generation == docPagesGeneration_.load(std::memory_order_acquire) &&
+                  (page > cursor ? page - cursor : cursor - page) <= radius;
+
+    if (wanted) {
+        // Pages reserve decode memory like previews (strip thumbnails are
+        // too small to bother); neighbours yield instead of waiting
+        AdmissionGuard reservation{admission_, thumbnail ? 0 : static_cast<size_t>(maxDimension) * maxDimension * 4};
+        bool admitted = reservation.bytes == 0 ||
+                        (priority == TaskPriority::High ? admission_.Acquire(reservation.bytes)
+                                                        : admission_.TryAcquire(reservation.bytes));
+        if (!admitted) {
+            reservation.bytes = 0;
+        } else {
+            ready.decoded = true;
+            auto image = decoder_->DecodePage(path, page, maxDimension);
             if (image && image->data) {
                 ready.width = image->info.width;
                 ready.height = image->info.height;
                 ready.pixels = std::move(image->data);
+                ready.reservedBytes = reservation.bytes;
+                reservation.bytes = 0;
             }
         }
+    }
 
-        {
-            std::lock_guard lock(readyBitmapMutex_);
-            readyBitmapQueue_.push_back(std::move(ready));
+    // Always report back (even empty) so the pending marker gets cleared
+    std::lock_guard lock(docPagesMutex_);
+    readyDocPages_.push_back(std::move(ready));
+}
+
+int ImagePipeline::FlushReadyDocPages(int maxCount)
+{
+    std::vector<ReadyDocPage> batch;
+    {
+        std::lock_guard lock(docPagesMutex_);
+        int count = std::min(maxCount, static_cast<int>(readyDocPages_.size()));
+        if (count == 0) return 0;
+
+        batch.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            batch.push_back(std::move(readyDocPages_.front()));
+            readyDocPages_.pop_front();
         }
-    }, TaskPriority::Normal);
+    }
+
+    int created = 0;
+    for (auto& ready : batch) {
+        // Results for a released document or an evicted page are dropped
+        auto it = docPages_.end();
+        if (ready.generation == docPagesGeneration_.load(std::memory_order_acquire)) {
+            it = docPages_.find(DocPageKey(ready.page, ready.thumbnail));
+        }
+
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+        if (it != docPages_.end() && ready.pixels && renderer_ && ready.width > 0 && ready.height > 0) {
+            bitmap = renderer_->CreateBitmap(ready.width, ready.height, ready.pixels.get());
+        }
+        ready.pixels.reset();
+        admission_.Release(ready.reservedBytes);
+        if (it == docPages_.end()) continue;
+
+        auto& entry = it->second;
+        entry.pending = false;
+        if (!bitmap) {
+            entry.failed = ready.decoded;  // skipped decodes are re-queued on request
+            continue;
+        }
+        docPageBytes_ -= std::min(docPageBytes_, entry.bytes);
+        entry.bitmap = bitmap;
+        entry.maxDimension = ready.maxDimension;
+        entry.bytes = static_cast<size_t>(ready.width) * ready.height * 4;
+        docPageBytes_ += entry.bytes;
+        ++created;
+    }
+    return created;
+}
+
+void ImagePipeline::ReleaseDocPages()
+{
+    docPagesGeneration_.fetch_add(1, std::memory_order_acq_rel);
+    docPages_.clear();
+    docPageBytes_ = 0;
+    docPagesPath_.clear();
+    docPageCursor_.store(0, std::memory_order_relaxed);
+}
+
+size_t ImagePipeline::ExpectedDecodeBytes(const std::filesystem::path& path, uint32_t maxDimension)
+{
+    ScannedSize size;
+    if (!FindScannedSize(path, size)) {
+        if (!decoder_) return 0;
+        auto info = decoder_->GetImageInfo(path);
+        if (!info || info->width == 0 || info->height == 0) return 0;
+        size.width = info->width;
+        size.height = info->height;
+        size.deep = info->isHDR;
+    }
+
+    uint64_t w = size.width;
+    uint64_t h = size.height;
+    uint64_t longest = std::max(w, h);
+    if (maxDimension > 0 && longest > maxDimension) {
+        w = std::max<uint64_t>(1, w * maxDimension / longest);
+        h = std::max<uint64_t>(1, h * maxDimension / longest);
+    }
+    // Full-size decodes keep deep sources as half floats
+    uint64_t bytesPerPixel = maxDimension == 0 && size.deep ? 8 : 4;
+    return static_cast<size_t>(w * h * bytesPerPixel);
 }
 
 int ImagePipeline::FlushReadyBitmaps(int maxCount)
@@ -146,7 +907,54 @@ int ImagePipeline::FlushReadyBitmaps(int maxCount)
         Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
 
         if (ready.pixels && renderer_ && ready.width > 0 && ready.height > 0) {
-            bitmap = renderer_->CreateBitmap(ready.width, ready.height, ready.pixels.get());
+            bitmap = renderer_->CreateBitmap(ready.width, ready.height, ready.pixels.get(), ready.format);
+        }
+        // Pixels now live on the GPU (or are dropped); free the reservation
+        ready.pixels.reset();
+        admission_.Release(ready.reservedBytes);
+
+        if (ready.isPreview) {
+            // Whoever holds the request now (it may have been taken over
+            // since the decode started) hears about the result
+            PreviewCallback callback;
+            uint64_t callbackGeneration = 0;
+            {
+                std::lock_guard lock(cacheMutex_);
+                auto pending = pendingPreviews_.find(PreviewKey{ready.path, ready.previewMaxDimension});
+                if (pending != pendingPreviews_.end() && pending->second.ticket == ready.previewTicket) {
+                    callback = std::move(pending->second.callback);
+                    callbackGeneration = pending->second.openGeneration;
+                    pendingPreviews_.erase(pending);
+                }
+            }
+            if (bitmap) {
+                size_t bytes = BitmapBytes(bitmap.Get());
+                std::lock_guard lock(cacheMutex_);
+                if (ready.sourceWidth > 0 && ready.sourceHeight > 0) {
+                    sourceSizes_[ready.path] = {ready.sourceWidth, ready.sourceHeight};
+                }
+                if (ready.isFullResolution) {
+                    if (!fullImageCache_.contains(ready.path)) {
+                        fullImageCache_[ready.path] = bitmap;
+                        fullImageCacheBytes_ += bytes;
+                        EvictFullImagesIfNeeded();
+                    }
+                } else {
+                    auto& slot = previewCache_[ready.path];
+                    if (slot) {
+                        previewCacheBytes_ -= std::min(previewCacheBytes_, BitmapBytes(slot.Get()));
+                    }
+                    slot = bitmap;
+                    previewCacheBytes_ += bytes;
+                    EvictPreviewsIfNeeded();
+                }
+            }
+            // Cached either way; only the current open generation hears about it
+            if (bitmap && callback && callbackGeneration == openGeneration_.load(std::memory_order_acquire)) {
+                callback(bitmap, ready.isFullResolution);
+            }
+            ++completed;
+            continue;
         }
 
         {
@@ -158,7 +966,7 @@ int ImagePipeline::FlushReadyBitmaps(int maxCount)
                 bitmap = existing->second;
             } else if (bitmap) {
                 fullImageCache_[ready.path] = bitmap;
-                fullImageCacheBytes_ += static_cast<size_t>(ready.width) * ready.height * 4;
+                fullImageCacheBytes_ += BitmapBytes(bitmap.Get());
                 EvictFullImagesIfNeeded();
             }
         }
@@ -172,6 +980,44 @@ int ImagePipeline::FlushReadyBitmaps(int maxCount)
     return completed;
 }
 
+void ImagePipeline::UpdateMemoryBudgets()
+{
+    {
+        std::lock_guard lock(cacheMutex_);
+        governor_.ReportUsage(MemoryTier::ThumbnailGpu, thumbnailCacheBytes_);
+        governor_.ReportUsage(MemoryTier::Tier2Compressed, tier2Bytes_);
+        governor_.ReportUsage(MemoryTier::FullImage, fullImageCacheBytes_);
+        governor_.ReportUsage(MemoryTier::Preview, previewCacheBytes_ + docPageBytes_);
+        governor_.ReportUsage(MemoryTier::Tiles, tileCacheBytes_);
+    }
+    {
+        std::lock_guard lock(thumbSaveMutex_);
+        governor_.ReportUsage(MemoryTier::SaveBuffer, thumbSaveBytes_);
+    }
+    if (cache_) {
+        governor_.ReportUsage(MemoryTier::DecodeCache, cache_->GetStats().currentSizeBytes);
+    }
+
+    bool shrank = governor_.Update();
+    admission_.SetCapacity(2 * governor_.GetBudget(MemoryTier::FullImage));
+
+    size_t decodeBudget = governor_.GetBudget(MemoryTier::DecodeCache);
+    if (cache_ && decodeBudget != decodeCacheBudget_) {
+        decodeCacheBudget_ = decodeBudget;
+        cache_->Resize(decodeBudget);
+    }
+    if (!shrank) return;
+
+    {
+        std::lock_guard lock(cacheMutex_);
+        EvictTilesIfNeeded();
+        EvictPreviewsIfNeeded();
+        EvictFullImagesIfNeeded();
+        EvictTier2Locked(0);
+    }
+    EvictThumbnailsIfNeeded();
+}
+
 void ImagePipeline::ReleaseDeviceResources()
 {
     {
@@ -180,14 +1026,23 @@ void ImagePipeline::ReleaseDeviceResources()
         thumbnailCacheBytes_ = 0;
         fullImageCache_.clear();
         fullImageCacheBytes_ = 0;
+        previewCache_.clear();
+        previewCacheBytes_ = 0;
+        tileCache_.clear();
+        tileCacheBytes_ = 0;
     }
+    ClearAnimations();  // reopened (from their first frame) on the next request
+    ReleaseDocPages();
 
     // Decoded CPU buffers are still valid and can be uploaded after recovery.
 }
 
-Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetThumbnail(const std::filesystem::path& path,
+Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetThumbnail(const std::filesystem::path& requestedPath,
                                                                   uint32_t maxSize)
 {
+    std::filesystem::path aliasStorage;
+    const auto& path = ResolveAlias(requestedPath, aliasStorage);
+
     {
         std::lock_guard lock(cacheMutex_);
         auto it = thumbnailCache_.find(path);
@@ -197,17 +1052,19 @@ Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetThumbnail(const std::files
         }
     }
 
-    auto bitmap = DecodeAndCreateThumbnail(path, maxSize);
+    // Cached under the highest level the result covers (256 px is level 1,
+    // not 320 px level 2), so a later request for a larger level refines it
+    uint32_t decodeSize = std::max(maxSize, kThumbnailLevelPx[0]);
+    int level = 0;
+    while (level + 1 < kThumbnailLevelCount && kThumbnailLevelPx[level + 1] <= decodeSize) {
+        ++level;
+    }
+
+    auto bitmap = DecodeAndCreateThumbnail(path, decodeSize);
     if (bitmap) {
         auto bmpSize = bitmap->GetPixelSize();
         std::lock_guard lock(cacheMutex_);
-        ThumbnailCacheEntry entry;
-        entry.bitmap = bitmap;
-        entry.width = bmpSize.width;
-        entry.height = bmpSize.height;
-        entry.lastAccess = std::chrono::steady_clock::now();
-        thumbnailCacheBytes_ += static_cast<size_t>(bmpSize.width) * bmpSize.height * 4;
-        thumbnailCache_[path] = std::move(entry);
+        StoreThumbnailLocked(path, bitmap, bmpSize.width, bmpSize.height, level);
     }
     return bitmap;
 }
@@ -223,7 +1080,8 @@ void ImagePipeline::PrefetchAround(const std::vector<std::filesystem::path>& all
     for (size_t offset = 1; offset <= radius; ++offset) {
         // Forward
         if (currentIndex + offset < allPaths.size()) {
-            auto p = allPaths[currentIndex + offset];
+            std::filesystem::path aliasStorage;
+            auto p = ResolveAlias(allPaths[currentIndex + offset], aliasStorage);
             if (!HasThumbnail(p)) {
                 batch.push_back([this, p, gen] {
                     ThumbnailDecodeTask(p, 256, gen);
@@ -232,7 +1090,8 @@ void ImagePipeline::PrefetchAround(const std::vector<std::filesystem::path>& all
         }
         // Backward
         if (currentIndex >= offset) {
-            auto p = allPaths[currentIndex - offset];
+            std::filesystem::path aliasStorage;
+            auto p = ResolveAlias(allPaths[currentIndex - offset], aliasStorage);
             if (!HasThumbnail(p)) {
                 batch.push_back([this, p, gen] {
                     ThumbnailDecodeTask(p, 256, gen);
@@ -256,7 +1115,8 @@ std::vector<std::filesystem::path> ImagePipeline::ScanDirectory(const std::files
 
     static const std::set<std::wstring> supportedExts = {
         L".jpg", L".jpeg", L".png", L".bmp", L".gif",
-        L".tif", L".tiff", L".webp", L".ico", L".jxr"
+        L".tif", L".tiff", L".webp", L".ico", L".jxr",
+        L".cr2", L".nef", L".nrw", L".arw", L".dng", L".pef", L".srw"
     };
 
     for (const auto& entry : std::filesystem::directory_iterator(dir)) {
@@ -281,7 +1141,8 @@ std::vector<ScannedImage> ImagePipeline::ScanFolders(
     const std::vector<std::filesystem::path>& folders,
     std::atomic<bool>& cancelFlag,
     std::atomic<size_t>& outCount,
-    ScanFlushCallback flushCallback)
+    ScanFlushCallback flushCallback,
+    const std::vector<ScannedImage>* known)
 {
     std::vector<ScannedImage> result;
     std::unordered_set<std::wstring> seen;
@@ -291,7 +1152,8 @@ std::vector<ScannedImage> ImagePipeline::ScanFolders(
     static const std::set<std::wstring> supportedExts = {
         L".jpg", L".jpeg", L".png", L".bmp", L".gif",
         L".tif", L".tiff", L".webp", L".ico", L".jxr",
-        L".heic", L".heif", L".avif"
+        L".heic", L".heif", L".avif",
+        L".cr2", L".nef", L".nrw", L".arw", L".dng", L".pef", L".srw"
     };
 
     // Folder names to skip during recursive scan
@@ -391,7 +1253,7 @@ std::vector<ScannedImage> ImagePipeline::ScanFolders(
                             if (GetFileAttributesExW(img.path.c_str(),
                                                       GetFileExInfoStandard, &fad)) {
                                 // Check file size — skip small files (icons, favicons, etc.)
-                                ULONGLONG fileSize = (static_cast<ULONGLONG>(fad.nFileSizeHigh) << 32) | fad.nFileSizeLow;
+                                uint64_t fileSize = (static_cast<ULONGLONG>(fad.nFileSizeHigh) << 32) | fad.nFileSizeLow;
                                 if (fileSize < kMinImageSize) {
                                     std::error_code iterEc;
                                     it.increment(iterEc);
@@ -402,6 +1264,9 @@ std::vector<ScannedImage> ImagePipeline::ScanFolders(
                                 FileTimeToSystemTime(&fad.ftLastWriteTime, &st);
                                 img.year = st.wYear;
                                 img.month = st.wMonth;
+                                img.fileSize = fileSize;
+                                img.modified = (static_cast<uint64_t>(fad.ftLastWriteTime.dwHighDateTime) << 32) |
+                                               fad.ftLastWriteTime.dwLowDateTime;
                             }
 
                             img.sourceFolder = dir;
@@ -433,6 +1298,136 @@ std::vector<ScannedImage> ImagePipeline::ScanFolders(
 
     if (cancelFlag) return result;
 
+    // Header probe: a few KB per file, in parallel batches (I/O bound, so
+    // more workers than cores is fine). Unchanged files keep what the
+    // previous scan found, content IDs included.
+    std::vector<uint64_t> knownIds(result.size(), 0);
+    {
+        std::unordered_map<std::wstring, const ScannedImage*> previous;
+        if (known) {
+            previous.reserve(known->size());
+            for (const auto& img : *known) {
+                if (img.modified == 0) continue;
+                std::wstring lower = img.path.wstring();
+                Simd::ToLowerInPlace(lower);
+                previous.emplace(std::move(lower), &img);
+            }
+        }
+
+        std::vector<size_t> toProbe;
+        for (size_t i = 0; i < result.size(); ++i) {
+            auto& img = result[i];
+            std::wstring lower = img.path.wstring();
+            Simd::ToLowerInPlace(lower);
+            auto it = previous.empty() ? previous.end() : previous.find(lower);
+            const bool unchanged = it != previous.end() && it->second->fileSize == img.fileSize &&
+                                   it->second->modified == img.modified;
+            if (unchanged) knownIds[i] = it->second->contentId;
+            if (unchanged && it->second->width != 0) {
+                img.width = it->second->width;
+                img.height = it->second->height;
+                img.orientation = it->second->orientation;
+                img.bitDepth = it->second->bitDepth;
+                img.year = it->second->year;
+                img.month = it->second->month;
+            } else {
+                toProbe.push_back(i);
+            }
+        }
+
+        constexpr size_t kProbeBatch = 64;
+        std::atomic<size_t> next{0};
+        auto probeWorker = [&] {
+            for (;;) {
+                size_t begin = next.fetch_add(kProbeBatch);
+                if (begin >= toProbe.size() || cancelFlag) return;
+                size_t end = std::min(begin + kProbeBatch, toProbe.size());
+                for (size_t k = begin; k < end; ++k) {
+                    auto& img = result[toProbe[k]];
+                    ImageProbeResult probe;
+                    if (!ProbeFile(img.path, probe)) continue;
+                    img.width = probe.width;
+                    img.height = probe.height;
+                    img.orientation = probe.orientation;
+                    img.bitDepth = probe.bitDepth;
+                    if (probe.year > 0) {
+                        img.year = probe.year;
+                        img.month = probe.month;
+                    }
+                }
+            }
+        };
+
+        unsigned workerCount = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+        workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, (toProbe.size() + kProbeBatch - 1) / kProbeBatch));
+        {
+            std::vector<std::jthread> workers;
+            for (unsigned w = 1; w < workerCount; ++w) workers.emplace_back(probeWorker);
+            probeWorker();
+        }
+
+        OutputDebugStringW((L"[UIV] Scan probed " + std::to_wstring(toProbe.size()) + L" headers, reused " +
+            std::to_wstring(result.size() - toProbe.size()) + L"\n").c_str());
+    }
+
+    if (cancelFlag) return result;
+
+    // Same photo synced into several folders: only files whose exact size
+    // repeats are sampled, and only sampled matches are read in full, so a
+    // library without copies costs no extra I/O. A size group whose files
+    // are all unchanged keeps its IDs from the previous scan, unless two of
+    // them share a sampled ID (written before matches were confirmed).
+    {
+        std::unordered_map<uint64_t, std::vector<size_t>> bySize;
+        for (size_t i = 0; i < result.size(); ++i) {
+            if (result[i].fileSize > 0) bySize[result[i].fileSize].push_back(i);
+        }
+
+        std::unordered_map<uint64_t, int> copies;
+        for (const auto& [size, indices] : bySize) {
+            if (indices.size() < 2 || cancelFlag) continue;
+
+            bool reuse = true;
+            std::unordered_set<uint64_t> sampledIds;
+            for (size_t i : indices) {
+                uint64_t id = knownIds[i];
+                if (id == 0 || (!IsWholeFileId(id) && !sampledIds.insert(id).second)) {
+                    reuse = false;
+                    break;
+                }
+            }
+            if (reuse) {
+                for (size_t i : indices) result[i].contentId = knownIds[i];
+            } else {
+                std::unordered_map<uint64_t, std::vector<size_t>> bySample;
+                for (size_t i : indices) {
+                    result[i].contentId = ComputeContentId(result[i].path, size, false);
+                    if (result[i].contentId) bySample[result[i].contentId].push_back(i);
+                }
+                for (const auto& [sample, matches] : bySample) {
+                    if (matches.size() < 2) continue;
+                    for (size_t i : matches) {
+                        result[i].contentId = IsWholeFileId(knownIds[i])
+                            ? knownIds[i]
+                            : ComputeContentId(result[i].path, size, true);
+                    }
+                }
+            }
+            for (size_t i : indices) {
+                if (IsWholeFileId(result[i].contentId)) ++copies[result[i].contentId];
+            }
+        }
+
+        size_t duplicates = 0;
+        for (const auto& [id, count] : copies) {
+            if (count > 1) duplicates += count - 1;
+        }
+        if (duplicates > 0) {
+            OutputDebugStringW((L"[UIV] Scan found " + std::to_wstring(duplicates) +
+                L" duplicate copies\n").c_str());
+        }
+    }
+
     // Sort by date descending (newest first)
     std::sort(result.begin(), result.end(),
         [](const ScannedImage& a, const ScannedImage& b) {
@@ -477,8 +1472,11 @@ std::vector<ScannedImage> ImagePipeline::ScanSystemImages(
 }
 
 Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetCachedThumbnail(
-    const std::filesystem::path& path)
+    const std::filesystem::path& requestedPath)
 {
+    std::filesystem::path aliasStorage;
+    const auto& path = ResolveAlias(requestedPath, aliasStorage);
+
     // Check GPU cache first
     {
         std::lock_guard lock(cacheMutex_);
@@ -489,43 +1487,143 @@ Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::GetCachedThumbnail(
         }
     }
 
-    // Fall through to persistent disk cache (even during fast scroll)
-    if (persistSyncBudget_ > 0 && renderer_) {
-        uint16_t w = 0, h = 0;
-        std::unique_ptr<uint8_t[]> pixels;
-        {
-            std::shared_lock plock(persistMutex_);
-            auto it = persistIndex_.find(path);
-            if (it != persistIndex_.end()) {
-                w = it->second.width;
-                h = it->second.height;
-                uint32_t pixelSize = static_cast<uint32_t>(w) * h * 4;
-                pixels = std::make_unique<uint8_t[]>(pixelSize);
-                memcpy(pixels.get(), it->second.pixelData, pixelSize);
-            }
+    // Fall through to persistent disk cache (even during fast scroll).
+    // Level 0 first: smallest upload, refined once scrolling settles.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+    UploadPersistentThumb(path, 0, bitmap);
+    return bitmap;
+}
+
+int ImagePipeline::ThumbnailLevelFor(uint32_t targetSize)
+{
+    for (int level = 0; level < kThumbnailLevelCount; ++level) {
+        if (kThumbnailLevelPx[level] >= targetSize) return level;
+    }
+    return kThumbnailLevelCount - 1;
+}
+
+std::unique_ptr<uint8_t[]> ImagePipeline::ScaleToLevel(const uint8_t* src, uint32_t width, uint32_t height,
+                                                       int level, uint32_t& outWidth, uint32_t& outHeight)
+{
+    uint32_t maxPx = kThumbnailLevelPx[level];
+    uint32_t longest = std::max(width, height);
+    if (longest <= maxPx) {
+        outWidth = width;
+        outHeight = height;
+    } else {
+        outWidth = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(width) * maxPx / longest));
+        outHeight = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(height) * maxPx / longest));
+    }
+
+    size_t outSize = static_cast<size_t>(outWidth) * outHeight * 4;
+    auto out = std::make_unique<uint8_t[]>(outSize);
+    if (outWidth == width && outHeight == height) {
+        memcpy(out.get(), src, outSize);
+    } else {
+        ResampleBGRA(src, width, height, out.get(), outWidth, outHeight);
+    }
+    return out;
+}
+
+int ImagePipeline::UploadPersistentThumb(const std::filesystem::path& path, int wantedLevel,
+                                         Microsoft::WRL::ComPtr<ID2D1Bitmap>& outBitmap)
+{
+    if (persistSyncBudget_ <= 0 || !renderer_) return -1;
+
+    uint16_t w = 0, h = 0;
+    int level = -1;
+    std::unique_ptr<uint8_t[]> pixels;
+    {
+        std::shared_lock plock(persistMutex_);
+        auto it = persistIndex_.find(path);
+        if (it == persistIndex_.end()) return -1;
+
+        // Exact level, else the sharpest lower one (placeholder), else the
+        // smallest higher one. No resampling on the render thread.
+        const auto& levels = it->second.levels;
+        if (levels[wantedLevel].pixelData) {
+            level = wantedLevel;
         }
-        if (pixels && w > 0 && h > 0) {
-            auto bitmap = renderer_->CreateBitmap(w, h, pixels.get());
-            if (bitmap) {
-                --persistSyncBudget_;
-                std::lock_guard lock(cacheMutex_);
-                ThumbnailCacheEntry entry;
-                entry.bitmap = bitmap;
-                entry.width = w;
-                entry.height = h;
-                entry.lastAccess = std::chrono::steady_clock::now();
-                thumbnailCacheBytes_ += static_cast<size_t>(w) * h * 4;
-                thumbnailCache_[path] = std::move(entry);
-                return bitmap;
-            }
+        for (int l = wantedLevel - 1; level < 0 && l >= 0; --l) {
+            if (levels[l].pixelData) level = l;
+        }
+        for (int l = wantedLevel + 1; level < 0 && l < kThumbnailLevelCount; ++l) {
+            if (levels[l].pixelData) level = l;
         }
+        if (level < 0) return -1;
+
+        w = levels[level].width;
+        h = levels[level].height;
+        uint32_t pixelSize = static_cast<uint32_t>(w) * h * 4;
+        pixels = std::make_unique<uint8_t[]>(pixelSize);
+        memcpy(pixels.get(), levels[level].pixelData, pixelSize);
     }
 
-    return nullptr;
+    if (w == 0 || h == 0) return -1;
+    auto bitmap = renderer_->CreateBitmap(w, h, pixels.get());
+    if (!bitmap) return -1;
+
+    --persistSyncBudget_;
+    std::lock_guard lock(cacheMutex_);
+    StoreThumbnailLocked(path, bitmap, w, h, level);
+    outBitmap = thumbnailCache_[path].bitmap;
+    return level;
+}
+
+bool ImagePipeline::ReadPersistentThumb(const std::filesystem::path& path, int level,
+                                        std::unique_ptr<uint8_t[]>& outPixels,
+                                        uint32_t& outWidth, uint32_t& outHeight)
+{
+    std::shared_lock plock(persistMutex_);
+    auto it = persistIndex_.find(path);
+    if (it == persistIndex_.end()) return false;
+
+    for (int l = level; l < kThumbnailLevelCount; ++l) {
+        const auto& info = it->second.levels[l];
+        if (!info.pixelData || info.width == 0 || info.height == 0) continue;
+        // Higher levels are downsampled instead of decoding the source again
+        outPixels = ScaleToLevel(info.pixelData, info.width, info.height, level, outWidth, outHeight);
+        return true;
+    }
+    return false;
+}
+
+void ImagePipeline::StoreThumbnailLocked(const std::filesystem::path& path,
+                                         const Microsoft::WRL::ComPtr<ID2D1Bitmap>& bitmap,
+                                         uint32_t width, uint32_t height, int level)
+{
+    auto it = thumbnailCache_.find(path);
+    if (it != thumbnailCache_.end()) {
+        if (it->second.level > level) {
+            it->second.lastAccess = std::chrono::steady_clock::now();
+            return;
+        }
+        size_t oldBytes = static_cast<size_t>(it->second.width) * it->second.height * 4;
+        thumbnailCacheBytes_ -= std::min(thumbnailCacheBytes_, oldBytes);
+    }
+
+    ThumbnailCacheEntry entry;
+    entry.bitmap = bitmap;
+    entry.width = width;
+    entry.height = height;
+    entry.level = level;
+    entry.lastAccess = std::chrono::steady_clock::now();
+    thumbnailCacheBytes_ += static_cast<size_t>(width) * height * 4;
+    thumbnailCache_[path] = std::move(entry);
 }
 
-bool ImagePipeline::HasThumbnail(const std::filesystem::path& path) const
+void ImagePipeline::ErasePendingLocked(const std::filesystem::path& path, int level)
 {
+    auto it = pendingRequests_.find(path);
+    if (it != pendingRequests_.end() && it->second.level <= level) {
+        pendingRequests_.erase(it);
+    }
+}
+
+bool ImagePipeline::HasThumbnail(const std::filesystem::path& requestedPath) const
+{
+    std::filesystem::path aliasStorage;
+    const auto& path = ResolveAlias(requestedPath, aliasStorage);
     std::lock_guard lock(cacheMutex_);
     auto it = thumbnailCache_.find(path);
     return it != thumbnailCache_.end() && it->second.bitmap;
@@ -537,20 +1635,6 @@ bool ImagePipeline::HasFullImage(const std::filesystem::path& path) const
     return fullImageCache_.contains(path);
 }
 
-Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::DecodeAndCreateBitmap(
-    const std::filesystem::path& path)
-{
-    if (!decoder_ || !renderer_) return nullptr;
-
-    auto image = decoder_->Decode(path, DecoderFlags::ZeroCopy);
-    if (!image || !image->data) return nullptr;
-
-    auto bitmap = renderer_->CreateBitmap(
-        image->info.width, image->info.height, image->data.get());
-
-    return bitmap;
-}
-
 Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::DecodeAndCreateThumbnail(
     const std::filesystem::path& path, uint32_t maxSize)
 {
@@ -572,80 +1656,126 @@ Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::DecodeAndCreateThumbnail(
 // --- Async Thumbnail Pipeline Implementation ---
 
 Microsoft::WRL::ComPtr<ID2D1Bitmap> ImagePipeline::RequestThumbnail(
-    const std::filesystem::path& path, uint32_t targetSize)
+    const std::filesystem::path& requestedPath, uint32_t targetSize, float viewportDistance)
 {
-    // Check in-memory cache + pending dedup under single lock
+    std::filesystem::path aliasStorage;
+    const auto& path = ResolveAlias(requestedPath, aliasStorage);
+    int level = ThumbnailLevelFor(targetSize);
+
+    // A lower level is shown while the requested one decodes
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> cached;
     {
         std::lock_guard lock(cacheMutex_);
         auto it = thumbnailCache_.find(path);
         if (it != thumbnailCache_.end()) {
             it->second.lastAccess = std::chrono::steady_clock::now();
-            return it->second.bitmap;
+            if (it->second.level >= level) {
+                governor_.RecordHit(MemoryTier::ThumbnailGpu);
+                return it->second.bitmap;
+            }
+            cached = it->second.bitmap;
         }
     }
+    governor_.RecordMiss(MemoryTier::ThumbnailGpu);
 
     // Synchronous path: create D2D bitmap directly from persistent cache
     // on the render thread. Zero-frame latency — identical to iOS behavior.
-    if (persistSyncBudget_ > 0 && renderer_) {
-        uint16_t w = 0, h = 0;
-        std::unique_ptr<uint8_t[]> pixels;
-
-        {
-            std::shared_lock plock(persistMutex_);
-            auto it = persistIndex_.find(path);
-            if (it != persistIndex_.end()) {
-                w = it->second.width;
-                h = it->second.height;
-                uint32_t pixelSize = static_cast<uint32_t>(w) * h * 4;
-                pixels = std::make_unique<uint8_t[]>(pixelSize);
-                memcpy(pixels.get(), it->second.pixelData, pixelSize);
-            }
-        }
-
-        if (pixels && w > 0 && h > 0) {
-            auto bitmap = renderer_->CreateBitmap(w, h, pixels.get());
-            if (bitmap) {
-                --persistSyncBudget_;
-                std::lock_guard lock(cacheMutex_);
-                ThumbnailCacheEntry entry;
-                entry.bitmap = bitmap;
-                entry.width = w;
-                entry.height = h;
-                entry.lastAccess = std::chrono::steady_clock::now();
-                thumbnailCacheBytes_ += static_cast<size_t>(w) * h * 4;
-                thumbnailCache_[path] = std::move(entry);
-                return bitmap;
-            }
-        }
+    if (!cached && UploadPersistentThumb(path, level, cached) >= level) {
+        return cached;
     }
 
-    if (!threadPool_) return nullptr;
+    if (!threadPool_) return cached;
 
     // Queue a decode request if not already pending (single mutex path)
     uint64_t gen = generation_.load();
     bool isVis = false;
+    bool alreadyPending = false;
     {
         std::lock_guard lock(cacheMutex_);
         auto pendIt = pendingRequests_.find(path);
-        if (pendIt != pendingRequests_.end() && pendIt->second == gen) {
-            return nullptr;  // already pending
+        if (pendIt != pendingRequests_.end() &&
+            pendIt->second.generation == gen && pendIt->second.level >= level) {
+            alreadyPending = true;
+        } else {
+            isVis = visiblePaths_.contains(path);
+            pendingRequests_[path] = {gen, level};
         }
-        isVis = visiblePaths_.contains(path);
-        pendingRequests_[path] = gen;
     }
 
-    auto pathCopy = path;
+    if (alreadyPending) {
+        // Cell moved since it was queued: re-ranked in bulk by UpdateThumbnailPriorities()
+        std::lock_guard slock(schedMutex_);
+        schedUpdates_[path] = viewportDistance;
+        return cached;
+    }
+
+    {
+        std::lock_guard slock(schedMutex_);
+        ThumbRequest req;
+        req.path = path;
+        req.targetSize = kThumbnailLevelPx[level];
+        req.generation = gen;
+        req.distance = viewportDistance;
+        req.score = ScoreThumbRequest(viewportDistance, schedDirection_);
+        req.trace = trace_.Begin(static_cast<uint8_t>(level));
+        schedQueue_.push_back(std::move(req));
+        std::push_heap(schedQueue_.begin(), schedQueue_.end(), ThumbRequestLater{});
+    }
+
+    // One pool task per request. The lane only decides how soon a worker picks
+    // it up; which request it decodes is decided by the heap at that moment.
     if (isVis) {
-        threadPool_->SubmitFront([this, pathCopy, targetSize, gen] {
-            ThumbnailDecodeTask(pathCopy, targetSize, gen);
-        }, TaskPriority::High);
+        threadPool_->SubmitFront([this] { RunNextThumbnailRequest(); }, TaskPriority::High);
     } else {
-        threadPool_->Submit([this, pathCopy, targetSize, gen] {
-            ThumbnailDecodeTask(pathCopy, targetSize, gen);
-        }, TaskPriority::Normal);
+        threadPool_->Submit([this] { RunNextThumbnailRequest(); }, TaskPriority::Normal);
+    }
+
+    return cached;  // nullptr or a softer level until the decode lands
+}
+
+float ImagePipeline::ScoreThumbRequest(float distance, int scrollDirection)
+{
+    float score = std::abs(distance);
+    // Rows the user is moving away from are needed last
+    if (scrollDirection != 0 && distance * static_cast<float>(scrollDirection) < 0.0f) {
+        score *= UI::Theme::ThumbnailBehindScrollPenalty;
+    }
+    return score;
+}
+
+void ImagePipeline::UpdateThumbnailPriorities(int scrollDirection)
+{
+    std::lock_guard lock(schedMutex_);
+    bool directionChanged = (scrollDirection != schedDirection_);
+    schedDirection_ = scrollDirection;
+    if (schedUpdates_.empty() && !directionChanged) return;
+
+    if (!schedQueue_.empty()) {
+        for (auto& req : schedQueue_) {
+            auto it = schedUpdates_.find(req.path);
+            if (it != schedUpdates_.end()) {
+                req.distance = it->second;
+            }
+            req.score = ScoreThumbRequest(req.distance, scrollDirection);
+        }
+        std::make_heap(schedQueue_.begin(), schedQueue_.end(), ThumbRequestLater{});
+    }
+    schedUpdates_.clear();
+}
+
+void ImagePipeline::RunNextThumbnailRequest()
+{
+    ThumbRequest req;
+    {
+        std::lock_guard lock(schedMutex_);
+        if (schedQueue_.empty()) return;  // dropped by InvalidateRequests()
+        std::pop_heap(schedQueue_.begin(), schedQueue_.end(), ThumbRequestLater{});
+        req = std::move(schedQueue_.back());
+        schedQueue_.pop_back();
     }
 
-    return nullptr;  // Not ready yet
+    trace_.Mark(req.trace, TraceEvent::Started);
+    ThumbnailDecodeTask(req.path, req.targetSize, req.generation, req.trace);
 }
 
 int ImagePipeline::FlushReadyThumbnails(int maxCount)
@@ -668,9 +1798,11 @@ int ImagePipeline::FlushReadyThumbnails(int maxCount)
 
     int created = 0;
     for (auto& ready : batch) {
+        trace_.Mark(ready.trace, TraceEvent::UploadBegin);
         if (!renderer_ || !ready.pixels || ready.width == 0 || ready.height == 0) {
+            trace_.Finish(ready.trace, ready.path, false);
             std::lock_guard lock(cacheMutex_);
-            pendingRequests_.erase(ready.path);
+            ErasePendingLocked(ready.path, ready.level);
             continue;
         }
 
@@ -680,29 +1812,31 @@ int ImagePipeline::FlushReadyThumbnails(int maxCount)
             // Save raw pixels for persistent cache AFTER GPU copy, BEFORE moving
             {
                 std::lock_guard lock(thumbSaveMutex_);
-                if (!thumbSaveBuffer_.contains(ready.path)) {
-                    ThumbSaveEntry save;
+                uint32_t pixelSize = ready.width * ready.height * 4;
+                bool overBudget = ready.level > 0 &&
+                    thumbSaveBytes_ + pixelSize > governor_.GetBudget(MemoryTier::SaveBuffer);
+                auto& save = thumbSaveBuffer_[ready.path].levels[ready.level];
+                if (!save.pixels && !overBudget) {
                     save.width = static_cast<uint16_t>(ready.width);
                     save.height = static_cast<uint16_t>(ready.height);
-                    save.pixelSize = ready.width * ready.height * 4;
+                    save.pixelSize = pixelSize;
                     save.pixels = std::move(ready.pixels);  // zero-copy transfer
-                    thumbSaveBuffer_[ready.path] = std::move(save);
+                    thumbSaveBytes_ += pixelSize;
                 }
             }
 
-            std::lock_guard lock(cacheMutex_);
-            ThumbnailCacheEntry entry;
-            entry.bitmap = bitmap;
-            entry.width = ready.width;
-            entry.height = ready.height;
-            entry.lastAccess = std::chrono::steady_clock::now();
-            thumbnailCacheBytes_ += static_cast<size_t>(ready.width) * ready.height * 4;
-            thumbnailCache_[ready.path] = std::move(entry);
-            pendingRequests_.erase(ready.path);
+            {
+                std::lock_guard lock(cacheMutex_);
+                StoreThumbnailLocked(ready.path, bitmap, ready.width, ready.height, ready.level);
+                ErasePendingLocked(ready.path, ready.level);
+            }
+            trace_.Mark(ready.trace, TraceEvent::Uploaded);
+            trace_.Finish(ready.trace, ready.path, true);
             ++created;
         } else {
+            trace_.Finish(ready.trace, ready.path, false);
             std::lock_guard lock(cacheMutex_);
-            pendingRequests_.erase(ready.path);
+            ErasePendingLocked(ready.path, ready.level);
         }
     }
 
@@ -724,6 +1858,15 @@ void ImagePipeline::InvalidateRequests()
         threadPool_->PurgePriority(TaskPriority::Low);
     }
 
+    {
+        std::lock_guard slock(schedMutex_);
+        for (const auto& req : schedQueue_) {
+            trace_.Finish(req.trace, req.path, false);
+        }
+        schedQueue_.clear();
+        schedUpdates_.clear();
+    }
+
     // Clear pending tracking so new requests can be queued
     std::lock_guard lock(cacheMutex_);
     pendingRequests_.clear();
@@ -731,11 +1874,87 @@ void ImagePipeline::InvalidateRequests()
 
 void ImagePipeline::SetVisibleRange(const std::vector<std::filesystem::path>& paths)
 {
+    std::filesystem::path aliasStorage;
     std::lock_guard lock(cacheMutex_);
     visiblePaths_.clear();
     for (const auto& p : paths) {
-        visiblePaths_[p] = true;
+        visiblePaths_[ResolveAlias(p, aliasStorage)] = true;
+    }
+}
+
+void ImagePipeline::SetContentAliases(const std::vector<ScannedImage>& images)
+{
+    // Group by fingerprint; the lowest lowercase path is canonical so the
+    // choice doesn't depend on scan order (and persisted entries stay valid)
+    struct Group {
+        std::vector<const std::filesystem::path*> paths;
+        std::wstring canonicalLower;
+        const std::filesystem::path* canonical = nullptr;
+    };
+    std::unordered_map<uint64_t, Group> groups;
+    for (const auto& img : images) {
+        if (!IsWholeFileId(img.contentId)) continue;  // sampled IDs never alias
+        auto& group = groups[img.contentId];
+        group.paths.push_back(&img.path);
+
+        std::wstring lower = img.path.wstring();
+        Simd::ToLowerInPlace(lower);
+        if (!group.canonical || lower < group.canonicalLower) {
+            group.canonical = &img.path;
+            group.canonicalLower = std::move(lower);
+        }
+    }
+
+    std::unordered_map<std::filesystem::path, std::filesystem::path> aliases;
+    for (const auto& [id, group] : groups) {
+        if (group.paths.size() < 2) continue;
+        for (const auto* p : group.paths) {
+            if (p != group.canonical) aliases.emplace(*p, *group.canonical);
+        }
+    }
+
+    std::unique_lock lock(aliasMutex_);
+    contentAliases_ = std::move(aliases);
+}
+
+void ImagePipeline::SetScannedSizes(const std::vector<ScannedImage>& images)
+{
+    std::unordered_map<std::filesystem::path, ScannedSize> sizes;
+    sizes.reserve(images.size());
+    for (const auto& img : images) {
+        // RAW headers describe the sensor or an IFD0 thumbnail, not the
+        // embedded preview that actually gets decoded
+        if (img.width == 0 || img.height == 0 || ImageDecoder::IsRawFormat(img.path)) continue;
+        ScannedSize size;
+        size.width = img.width;
+        size.height = img.height;
+        if (img.orientation >= 5 && img.orientation <= 8) std::swap(size.width, size.height);
+        size.deep = img.bitDepth > 8;
+        sizes.emplace(img.path, size);
     }
+
+    std::unique_lock lock(scannedSizeMutex_);
+    scannedSizes_ = std::move(sizes);
+}
+
+bool ImagePipeline::FindScannedSize(const std::filesystem::path& path, ScannedSize& size) const
+{
+    std::shared_lock lock(scannedSizeMutex_);
+    auto it = scannedSizes_.find(path);
+    if (it == scannedSizes_.end()) return false;
+    size = it->second;
+    return true;
+}
+
+const std::filesystem::path& ImagePipeline::ResolveAlias(const std::filesystem::path& path,
+                                                         std::filesystem::path& storage) const
+{
+    std::shared_lock lock(aliasMutex_);
+    if (contentAliases_.empty()) return path;
+    auto it = contentAliases_.find(path);
+    if (it == contentAliases_.end()) return path;
+    storage = it->second;
+    return storage;
 }
 
 bool ImagePipeline::HasPendingThumbnails() const
@@ -745,20 +1964,35 @@ bool ImagePipeline::HasPendingThumbnails() const
 }
 
 void ImagePipeline::ThumbnailDecodeTask(const std::filesystem::path& path,
-                                         uint32_t targetSize, uint64_t generation)
+                                         uint32_t targetSize, uint64_t generation,
+                                         TraceTimeline trace)
 {
+    int level = ThumbnailLevelFor(targetSize);
+
+    // Every return before the ready queue counts the request as dropped
+    struct TraceDropGuard {
+        PipelineTrace& tracer;
+        const TraceTimeline& timeline;
+        const std::filesystem::path& path;
+        bool handedOff = false;
+        ~TraceDropGuard() {
+            if (!handedOff) tracer.Finish(timeline, path, false);
+        }
+    } traceGuard{trace_, trace, path};
+
     // Check generation — skip stale requests
     if (generation < generation_.load()) {
         std::lock_guard lock(cacheMutex_);
-        pendingRequests_.erase(path);
+        ErasePendingLocked(path, level);
         return;
     }
 
-    // Check if already cached (another worker may have finished it)
+    // Check if already cached at this level (another worker may have finished it)
     {
         std::lock_guard lock(cacheMutex_);
-        if (thumbnailCache_.contains(path)) {
-            pendingRequests_.erase(path);
+        auto it = thumbnailCache_.find(path);
+        if (it != thumbnailCache_.end() && it->second.level >= level) {
+            ErasePendingLocked(path, level);
             return;
         }
     }
@@ -785,19 +2019,32 @@ void ImagePipeline::ThumbnailDecodeTask(const std::filesystem::path& path,
     std::unique_ptr<uint8_t[]> pixels;
     uint32_t imgWidth = 0, imgHeight = 0;
 
-    // Extract compressed data under lock, decompress outside lock
+    // Extract compressed data under lock, decompress outside lock. An entry at
+    // exactly this level is consumed; a higher level is copied and downsampled.
     {
         CompressedThumbnail t2copy;
         {
             std::lock_guard lock(cacheMutex_);
             auto t2it = tier2Cache_.find(path);
-            if (t2it != tier2Cache_.end()) {
-                t2copy = std::move(t2it->second);
-                tier2Bytes_ -= t2copy.compressedSize;
-                tier2Cache_.erase(t2it);
+            if (t2it != tier2Cache_.end() && t2it->second.level >= level) {
+                if (t2it->second.level == level) {
+                    t2copy = std::move(t2it->second);
+                    tier2Bytes_ -= t2copy.compressedSize;
+                    tier2Cache_.erase(t2it);
+                } else {
+                    t2copy.data = std::make_unique<uint8_t[]>(t2it->second.compressedSize);
+                    memcpy(t2copy.data.get(), t2it->second.data.get(), t2it->second.compressedSize);
+                    t2copy.compressedSize = t2it->second.compressedSize;
+                    t2copy.rawSize = t2it->second.rawSize;
+                    t2copy.width = t2it->second.width;
+                    t2copy.height = t2it->second.height;
+                    t2copy.level = t2it->second.level;
+                    t2it->second.lastAccess = std::chrono::steady_clock::now();
+                }
             }
         }
         if (t2copy.data) {
+            governor_.RecordHit(MemoryTier::Tier2Compressed);
             imgWidth = t2copy.width;
             imgHeight = t2copy.height;
             pixels = std::make_unique<uint8_t[]>(t2copy.rawSize);
@@ -805,50 +2052,106 @@ void ImagePipeline::ThumbnailDecodeTask(const std::filesystem::path& path,
                                   pixels.get(), t2copy.rawSize)) {
                 pixels.reset();
                 imgWidth = imgHeight = 0;
+            } else if (t2copy.level > level) {
+                pixels = ScaleToLevel(pixels.get(), imgWidth, imgHeight, level, imgWidth, imgHeight);
             }
+        } else {
+            governor_.RecordMiss(MemoryTier::Tier2Compressed);
         }
     }
+    trace_.Mark(trace, TraceEvent::Tier2Checked);
 
     // Tier 3: try persistent thumbnail cache (memcpy vs JPEG decode = 100x faster)
     if (!pixels) {
-        std::shared_lock plock(persistMutex_);
-        auto it = persistIndex_.find(path);
-        if (it != persistIndex_.end()) {
-            imgWidth = it->second.width;
-            imgHeight = it->second.height;
-            uint32_t pixelSize = imgWidth * imgHeight * 4;
-            pixels = std::make_unique<uint8_t[]>(pixelSize);
-            memcpy(pixels.get(), it->second.pixelData, pixelSize);
-        }
+        ReadPersistentThumb(path, level, pixels, imgWidth, imgHeight);
+        trace_.Mark(trace, TraceEvent::Tier3Checked);
     }
 
     // Fall back to JPEG decode if not in persistent cache
+    bool decodedFromSource = false;
     if (!pixels) {
         if (!decoder_) {
             std::lock_guard lock(cacheMutex_);
-            pendingRequests_.erase(path);
+            ErasePendingLocked(path, level);
             return;
         }
 
-        auto image = decoder_->GenerateThumbnail(path, targetSize);
-        if (!image || !image->data) {
-            image = decoder_->Decode(path, DecoderFlags::ZeroCopy);
+        // Cold cell: a JPEG's EXIF thumbnail sits in the first KB of the file
+        // and decodes in well under a millisecond. When it's too small for
+        // this level it's shown at the level it covers while the real decode
+        // below upgrades the cell.
+        uint16_t orientation = 1;
+        if (auto embedded = decoder_->DecodeExifThumbnail(path, orientation)) {
+            uint32_t embeddedPx = std::max(embedded->info.width, embedded->info.height);
+            int coveredLevel = -1;
+            for (int l = level; l >= 0 && coveredLevel < 0; --l) {
+                if (embeddedPx >= kThumbnailLevelPx[l]) coveredLevel = l;
+            }
+            if (coveredLevel == level) {
+                pixels = ScaleToLevel(embedded->data.get(), embedded->info.width, embedded->info.height,
+                                      level, imgWidth, imgHeight);
+            } else if (coveredLevel >= 0) {
+                ReadyThumbnail placeholder;
+                placeholder.path = path;
+                placeholder.pixels = ScaleToLevel(embedded->data.get(), embedded->info.width,
+                                                  embedded->info.height, coveredLevel,
+                                                  placeholder.width, placeholder.height);
+                placeholder.level = coveredLevel;
+                std::lock_guard lock(readyMutex_);
+                readyQueue_.push_back(std::move(placeholder));
+            }
         }
-        if (!image || !image->data) {
-            std::lock_guard lock(cacheMutex_);
-            pendingRequests_.erase(path);
-            return;
+
+        if (!pixels) {
+            auto image = decoder_->GenerateThumbnail(path, kThumbnailLevelPx[level]);
+            if (!image || !image->data) {
+                image = decoder_->Decode(path, DecoderFlags::ZeroCopy);
+            }
+            if (!image || !image->data) {
+                std::lock_guard lock(cacheMutex_);
+                ErasePendingLocked(path, level);
+                return;
+            }
+
+            pixels = std::move(image->data);
+            imgWidth = image->info.width;
+            imgHeight = image->info.height;
+            if (std::max(imgWidth, imgHeight) > kThumbnailLevelPx[level]) {
+                pixels = ScaleToLevel(pixels.get(), imgWidth, imgHeight, level, imgWidth, imgHeight);
+            }
         }
+        decodedFromSource = true;
+        trace_.Mark(trace, TraceEvent::Decoded);
+    }
 
-        pixels = std::move(image->data);
-        imgWidth = image->info.width;
-        imgHeight = image->info.height;
+    // A fresh source decode also yields level 0 for free, so the next fast
+    // scroll over this cell has something cheap to show.
+    if (decodedFromSource && level > 0) {
+        bool haveTiny = false;
+        {
+            std::shared_lock plock(persistMutex_);
+            auto it = persistIndex_.find(path);
+            haveTiny = (it != persistIndex_.end() && it->second.levels[0].pixelData);
+        }
+        if (!haveTiny) {
+            uint32_t tinyW = 0, tinyH = 0;
+            auto tiny = ScaleToLevel(pixels.get(), imgWidth, imgHeight, 0, tinyW, tinyH);
+            std::lock_guard lock(thumbSaveMutex_);
+            auto& save = thumbSaveBuffer_[path].levels[0];
+            if (!save.pixels) {
+                save.width = static_cast<uint16_t>(tinyW);
+                save.height = static_cast<uint16_t>(tinyH);
+                save.pixelSize = tinyW * tinyH * 4;
+                save.pixels = std::move(tiny);
+                thumbSaveBytes_ += save.pixelSize;
+            }
+        }
     }
 
     // Check generation again after decode
     if (generation < generation_.load()) {
         std::lock_guard lock(cacheMutex_);
-        pendingRequests_.erase(path);
+        ErasePendingLocked(path, level);
         return;
     }
 
@@ -858,6 +2161,10 @@ void ImagePipeline::ThumbnailDecodeTask(const std::filesystem::path& path,
     ready.pixels = std::move(pixels);
     ready.width = imgWidth;
     ready.height = imgHeight;
+    ready.level = level;
+    trace_.Mark(trace, TraceEvent::Ready);
+    ready.trace = trace;
+    traceGuard.handedOff = true;
 
     {
         std::lock_guard lock(readyMutex_);
@@ -909,11 +2216,11 @@ bool ImagePipeline::DecompressPixels(const uint8_t* src, size_t srcSize,
 void ImagePipeline::EvictFullImagesIfNeeded()
 {
     // Called with cacheMutex_ held. Evict oldest entries to stay under budget.
-    while (fullImageCacheBytes_ > kFullImageCacheMax && fullImageCache_.size() > 1) {
+    size_t budget = governor_.GetBudget(MemoryTier::FullImage);
+    while (fullImageCacheBytes_ > budget && fullImageCache_.size() > 1) {
         // Find the first entry (unordered_map iteration = arbitrary = oldest-ish)
         auto oldest = fullImageCache_.begin();
-        auto sz = oldest->second->GetPixelSize();
-        size_t bytes = static_cast<size_t>(sz.width) * sz.height * 4;
+        size_t bytes = BitmapBytes(oldest->second.Get());
         if (fullImageCacheBytes_ >= bytes) {
             fullImageCacheBytes_ -= bytes;
         } else {
@@ -923,11 +2230,61 @@ void ImagePipeline::EvictFullImagesIfNeeded()
     }
 }
 
+void ImagePipeline::EvictPreviewsIfNeeded()
+{
+    // Called with cacheMutex_ held
+    size_t budget = governor_.GetBudget(MemoryTier::Preview);
+    while (previewCacheBytes_ > budget && previewCache_.size() > 1) {
+        auto oldest = previewCache_.begin();
+        size_t bytes = BitmapBytes(oldest->second.Get());
+        previewCacheBytes_ -= std::min(previewCacheBytes_, bytes);
+        previewCache_.erase(oldest);
+    }
+}
+
+void ImagePipeline::EvictTilesIfNeeded()
+{
+    // Called with cacheMutex_ held. Trim to 90% so eviction isn't paid per tile.
+    size_t budget = governor_.GetBudget(MemoryTier::Tiles);
+    if (tileCacheBytes_ <= budget) return;
+
+    std::vector<std::pair<std::chrono::steady_clock::time_point, TileKey>> candidates;
+    candidates.reserve(tileCache_.size());
+    for (const auto& [key, entry] : tileCache_) {
+        candidates.emplace_back(entry.lastAccess, key);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t target = budget / 10 * 9;
+    for (const auto& [lastAccess, key] : candidates) {
+        if (tileCacheBytes_ <= target) break;
+        auto it = tileCache_.find(key);
+        tileCacheBytes_ -= std::min(tileCacheBytes_, it->second.bytes);
+        tileCache_.erase(it);
+    }
+}
+
+void ImagePipeline::EvictTier2Locked(size_t incomingBytes)
+{
+    size_t budget = governor_.GetBudget(MemoryTier::Tier2Compressed);
+    while (tier2Bytes_ + incomingBytes > budget && !tier2Cache_.empty()) {
+        auto oldest = tier2Cache_.begin();
+        for (auto it = tier2Cache_.begin(); it != tier2Cache_.end(); ++it) {
+            if (it->second.lastAccess < oldest->second.lastAccess)
+                oldest = it;
+        }
+        tier2Bytes_ -= std::min(tier2Bytes_, oldest->second.compressedSize);
+        tier2Cache_.erase(oldest);
+    }
+}
+
 void ImagePipeline::EvictThumbnailsIfNeeded()
 {
     std::lock_guard lock(cacheMutex_);
 
-    if (thumbnailCacheBytes_ <= UI::Theme::ThumbnailCacheMaxBytes) return;
+    size_t budget = governor_.GetBudget(MemoryTier::ThumbnailGpu);
+    if (thumbnailCacheBytes_ <= budget) return;
 
     // Build a list sorted by last access time (oldest first)
     struct EvictCandidate {
@@ -936,6 +2293,7 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
         size_t bytes;
         uint32_t width;
         uint32_t height;
+        int level;
     };
 
     std::vector<EvictCandidate> candidates;
@@ -944,7 +2302,7 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
         // Never evict visible thumbnails
         if (visiblePaths_.contains(path)) continue;
         size_t bytes = static_cast<size_t>(entry.width) * entry.height * 4;
-        candidates.push_back({path, entry.lastAccess, bytes, entry.width, entry.height});
+        candidates.push_back({path, entry.lastAccess, bytes, entry.width, entry.height, entry.level});
     }
 
     std::sort(candidates.begin(), candidates.end(),
@@ -957,17 +2315,18 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
         std::filesystem::path path;
         uint32_t width, height;
         size_t rawBytes;
+        int level;
     };
     std::vector<DemoteEntry> demoteList;
 
     // Evict to 75% of budget to avoid thrashing
-    size_t targetBytes = UI::Theme::ThumbnailCacheMaxBytes * 3 / 4;
+    size_t targetBytes = budget * 3 / 4;
     for (const auto& c : candidates) {
         if (thumbnailCacheBytes_ <= targetBytes) break;
 
         // Try to demote to Tier 2 (LRU eviction makes space if needed)
         if (!tier2Cache_.contains(c.path)) {
-            demoteList.push_back({c.path, c.width, c.height, c.bytes});
+            demoteList.push_back({c.path, c.width, c.height, c.bytes, c.level});
         }
 
         thumbnailCache_.erase(c.path);
@@ -985,23 +2344,17 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
         std::lock_guard saveLock(thumbSaveMutex_);
         for (const auto& d : demoteList) {
             auto saveIt = thumbSaveBuffer_.find(d.path);
-            if (saveIt == thumbSaveBuffer_.end() || !saveIt->second.pixels) continue;
+            if (saveIt == thumbSaveBuffer_.end()) continue;
+            const auto& save = saveIt->second.levels[d.level];
+            if (!save.pixels || save.width != d.width || save.height != d.height) continue;
 
             uint32_t rawSize = d.width * d.height * 4;
             std::unique_ptr<uint8_t[]> compressed;
             size_t compressedSize = 0;
 
-            if (CompressPixels(saveIt->second.pixels.get(), rawSize, compressed, compressedSize)) {
-                // Evict oldest Tier 2 entry if over budget
-                if (tier2Bytes_ + compressedSize > kTier2MaxBytes && !tier2Cache_.empty()) {
-                    auto oldest = tier2Cache_.begin();
-                    for (auto it = tier2Cache_.begin(); it != tier2Cache_.end(); ++it) {
-                        if (it->second.lastAccess < oldest->second.lastAccess)
-                            oldest = it;
-                    }
-                    tier2Bytes_ -= oldest->second.compressedSize;
-                    tier2Cache_.erase(oldest);
-                }
+            if (CompressPixels(save.pixels.get(), rawSize, compressed, compressedSize)) {
+                // Evict oldest Tier 2 entries if over budget
+                EvictTier2Locked(compressedSize);
 
                 CompressedThumbnail ct;
                 ct.data = std::move(compressed);
@@ -1009,6 +2362,7 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
                 ct.rawSize = rawSize;
                 ct.width = static_cast<uint16_t>(d.width);
                 ct.height = static_cast<uint16_t>(d.height);
+                ct.level = static_cast<uint8_t>(d.level);
                 ct.lastAccess = std::chrono::steady_clock::now();
                 tier2Bytes_ += compressedSize;
                 tier2Cache_[d.path] = std::move(ct);
@@ -1021,7 +2375,11 @@ void ImagePipeline::EvictThumbnailsIfNeeded()
 //
 // File format: sequential variable-size entries
 //   Header (32 bytes): "UIVT" + version(4) + entry_count(4) + reserved(20)
-//   Per entry: path_len(2) + width(2) + height(2) + reserved(2) + path(wchar_t[]) + pixels(BGRA[])
+//   Per entry: path_len(2) + width(2) + height(2) + level(2) + path(wchar_t[]) + pixels(BGRA[])
+// One entry per (path, ladder level). Version 1 files had a reserved zero
+// instead of the level; their single entry is mapped to a level by size.
+// Version 3 entries are all upright. Before it only JPEGs were turned, so
+// older files keep just their JPEG entries.
 
 void ImagePipeline::ClosePersistentMapping()
 {
@@ -1085,7 +2443,7 @@ void ImagePipeline::LoadPersistentThumbs(const std::filesystem::path& cachePath)
     uint32_t version, entryCount;
     memcpy(&version, data + 4, 4);
     memcpy(&entryCount, data + 8, 4);
-    if (version != 1) {
+    if (version < 1 || version > 3) {
         UnmapViewOfFile(data);
         CloseHandle(hMapping);
         CloseHandle(hFile);
@@ -1099,12 +2457,15 @@ void ImagePipeline::LoadPersistentThumbs(const std::filesystem::path& cachePath)
     for (uint32_t i = 0; i < entryCount; ++i) {
         if (offset + 8 > size) break;
 
-        uint16_t pathLen, w, h, reserved;
+        uint16_t pathLen, w, h, level;
         memcpy(&pathLen, data + offset, 2);
         memcpy(&w, data + offset + 2, 2);
         memcpy(&h, data + offset + 4, 2);
-        memcpy(&reserved, data + offset + 6, 2);
+        memcpy(&level, data + offset + 6, 2);
         offset += 8;
+        if (version == 1) {
+            level = static_cast<uint16_t>(ThumbnailLevelFor(std::max(w, h)));
+        }
 
         size_t pathBytes = static_cast<size_t>(pathLen) * sizeof(wchar_t);
         if (offset + pathBytes > size) break;
@@ -1116,11 +2477,20 @@ void ImagePipeline::LoadPersistentThumbs(const std::filesystem::path& cachePath)
         uint32_t pixelSize = static_cast<uint32_t>(w) * h * 4;
         if (offset + pixelSize > size) break;
 
-        PersistThumbInfo info;
-        info.pixelData = data + offset;
-        info.width = w;
-        info.height = h;
-        persistIndex_[std::move(path)] = info;
+        bool upright = version >= 3;
+        if (!upright) {
+            std::wstring ext = path.extension().wstring();
+            Simd::ToLowerInPlace(ext);
+            upright = ext == L".jpg" || ext == L".jpeg";
+        }
+
+        if (level < kThumbnailLevelCount && upright) {
+            PersistThumbInfo info;
+            info.pixelData = data + offset;
+            info.width = w;
+            info.height = h;
+            persistIndex_[std::move(path)].levels[level] = info;
+        }
 
         offset += pixelSize;
     }
@@ -1137,29 +2507,44 @@ void ImagePipeline::LoadPersistentThumbs(const std::filesystem::path& cachePath)
 void ImagePipeline::SavePersistentThumbs(const std::filesystem::path& cachePath)
 {
     // Snapshot the save buffer (newly decoded this session)
-    std::unordered_map<std::filesystem::path, ThumbSaveEntry> saveBuffer;
+    std::unordered_map<std::filesystem::path, ThumbSaveSet> saveBuffer;
     {
         std::lock_guard lock(thumbSaveMutex_);
         saveBuffer = std::move(thumbSaveBuffer_);
         thumbSaveBuffer_.clear();
+        thumbSaveBytes_ = 0;
     }
 
-    // Collect old persistent entries not already in save buffer
+    // Collect old persistent entries not already in save buffer (per level)
     struct OldEntry {
         std::filesystem::path path;
         PersistThumbInfo info;
+        uint16_t level;
     };
     std::vector<OldEntry> oldEntries;
     {
         std::shared_lock plock(persistMutex_);
-        for (const auto& [path, info] : persistIndex_) {
-            if (!saveBuffer.contains(path)) {
-                oldEntries.push_back({path, info});
+        std::shared_lock alock(aliasMutex_);
+        for (const auto& [path, set] : persistIndex_) {
+            // Copies of another image now share its entry
+            if (contentAliases_.contains(path)) continue;
+            auto saveIt = saveBuffer.find(path);
+            for (int level = 0; level < kThumbnailLevelCount; ++level) {
+                if (!set.levels[level].pixelData) continue;
+                if (saveIt != saveBuffer.end() && saveIt->second.levels[level].pixels) continue;
+                oldEntries.push_back({path, set.levels[level], static_cast<uint16_t>(level)});
             }
         }
     }
 
-    uint32_t totalEntries = static_cast<uint32_t>(saveBuffer.size() + oldEntries.size());
+    size_t newEntries = 0;
+    for (const auto& [path, set] : saveBuffer) {
+        for (const auto& entry : set.levels) {
+            if (entry.pixels) ++newEntries;
+        }
+    }
+
+    uint32_t totalEntries = static_cast<uint32_t>(newEntries + oldEntries.size());
     if (totalEntries == 0) return;
 
     // Write to .tmp file
@@ -1171,35 +2556,38 @@ void ImagePipeline::SavePersistentThumbs(const std::filesystem::path& cachePath)
     // Header
     uint8_t header[32] = {};
     memcpy(header, "UIVT", 4);
-    uint32_t version = 1;
+    uint32_t version = 3;
     memcpy(header + 4, &version, 4);
     memcpy(header + 8, &totalEntries, 4);
     fwrite(header, 1, 32, f);
 
     // Helper: write one entry
     auto writeEntry = [&](const std::filesystem::path& path, uint16_t w, uint16_t h,
-                          const uint8_t* pixels) {
+                          uint16_t level, const uint8_t* pixels) {
         std::wstring pathStr = path.wstring();
         uint16_t pathLen = static_cast<uint16_t>(pathStr.size());
-        uint16_t reserved = 0;
         fwrite(&pathLen, 2, 1, f);
         fwrite(&w, 2, 1, f);
         fwrite(&h, 2, 1, f);
-        fwrite(&reserved, 2, 1, f);
+        fwrite(&level, 2, 1, f);
         fwrite(pathStr.data(), sizeof(wchar_t), pathLen, f);
         fwrite(pixels, 1, static_cast<size_t>(w) * h * 4, f);
     };
 
     // Write new/updated entries from save buffer
-    for (const auto& [path, entry] : saveBuffer) {
-        if (entry.pixels) {
-            writeEntry(path, entry.width, entry.height, entry.pixels.get());
+    for (const auto& [path, set] : saveBuffer) {
+        for (int level = 0; level < kThumbnailLevelCount; ++level) {
+            const auto& entry = set.levels[level];
+            if (entry.pixels) {
+                writeEntry(path, entry.width, entry.height,
+                           static_cast<uint16_t>(level), entry.pixels.get());
+            }
         }
     }
 
     // Write old entries (still valid, from previous persistent cache)
     for (const auto& old : oldEntries) {
-        writeEntry(old.path, old.info.width, old.info.height, old.info.pixelData);
+        writeEntry(old.path, old.info.width, old.info.height, old.level, old.info.pixelData);
     }
 
     fclose(f);
@@ -0,0 +1,223 @@
+#include "core/ImageProbe.hpp"
+#include "core/ExifReader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+inline uint16_t BE16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+inline uint32_t BE32(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+inline uint16_t LE16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t LE24(const uint8_t* p) { return p[0] | (p[1] << 8) | (static_cast<uint32_t>(p[2]) << 16); }
+inline uint32_t LE32(const uint8_t* p) { return LE24(p) | (static_cast<uint32_t>(p[3]) << 24); }
+
+ProbeStatus ProbeJpeg(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    bool exifSeen = false;
+    size_t pos = 2;
+    while (true) {
+        if (pos + 4 > size) return ProbeStatus::NeedMoreData;
+        if (data[pos] != 0xFF) return ProbeStatus::Unsupported;
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) { ++pos; continue; }
+        size_t length = BE16(data + pos + 2);
+        if (length < 2) return ProbeStatus::Unsupported;
+
+        if (marker == 0xE1 && !exifSeen) {
+            if (pos + 2 + length > size) return ProbeStatus::NeedMoreData;
+            ExifInfo exif;
+            if (ReadExif(data, pos + 2 + length, exif)) {
+                exifSeen = true;
+                out.orientation = exif.orientation;
+                out.year = exif.year;
+                out.month = exif.month;
+            }
+        } else if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if (pos + 11 > size) return ProbeStatus::NeedMoreData;
+            out.bitDepth = data[pos + 4];
+            out.height = BE16(data + pos + 5);
+            out.width = BE16(data + pos + 7);
+            out.channels = data[pos + 9];
+            return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+        } else if (marker == 0xDA || marker == 0xD9) {
+            return ProbeStatus::Unsupported;  // no frame header before the scan
+        }
+        pos += 2 + length;
+    }
+}
+
+ProbeStatus ProbePng(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    if (size < 29) return ProbeStatus::NeedMoreData;
+    if (std::memcmp(data + 12, "IHDR", 4) != 0) return ProbeStatus::Unsupported;
+    out.width = BE32(data + 16);
+    out.height = BE32(data + 20);
+    out.bitDepth = data[24];
+    static const uint8_t kChannels[7] = {1, 0, 3, 1, 2, 0, 4};  // by colour type
+    out.channels = data[25] < 7 ? kChannels[data[25]] : 0;
+    return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+}
+
+ProbeStatus ProbeGif(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    if (size < 10) return ProbeStatus::NeedMoreData;
+    out.width = LE16(data + 6);
+    out.height = LE16(data + 8);
+    out.bitDepth = 8;
+    out.channels = 1;
+    return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+}
+
+ProbeStatus ProbeBmp(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    if (size < 30) return ProbeStatus::NeedMoreData;
+    uint32_t headerSize = LE32(data + 14);
+    if (headerSize == 12) {  // OS/2 core header
+        out.width = LE16(data + 18);
+        out.height = LE16(data + 20);
+        out.bitDepth = static_cast<uint8_t>(std::min<uint16_t>(LE16(data + 24), 8));
+        out.channels = LE16(data + 24) >= 24 ? 3 : 1;
+    } else {
+        int32_t width = static_cast<int32_t>(LE32(data + 18));
+        int32_t height = static_cast<int32_t>(LE32(data + 22));
+        if (width <= 0 || height == 0 || height == INT32_MIN) return ProbeStatus::Unsupported;
+        out.width = static_cast<uint32_t>(width);
+        out.height = static_cast<uint32_t>(height < 0 ? -height : height);
+        uint16_t bpp = LE16(data + 28);
+        out.bitDepth = static_cast<uint8_t>(bpp >= 24 ? 8 : (bpp == 16 ? 5 : bpp));
+        out.channels = static_cast<uint8_t>(bpp >= 24 ? bpp / 8 : (bpp == 16 ? 3 : 1));
+    }
+    return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+}
+
+ProbeStatus ProbeTiff(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    const bool bigEndian = data[0] == 'M';
+    auto u16 = [&](size_t at) { return bigEndian ? BE16(data + at) : LE16(data + at); };
+    auto u32 = [&](size_t at) { return bigEndian ? BE32(data + at) : LE32(data + at); };
+
+    size_t ifd = u32(4);
+    if (ifd < 8) return ProbeStatus::Unsupported;
+    if (ifd + 2 > size) return ProbeStatus::NeedMoreData;
+    size_t entries = u16(ifd);
+    if (ifd + 2 + entries * 12 > size) return ProbeStatus::NeedMoreData;
+
+    for (size_t i = 0; i < entries; ++i) {
+        size_t entry = ifd + 2 + i * 12;
+        uint16_t tag = u16(entry);
+        uint16_t type = u16(entry + 2);
+        uint32_t value = type == 3 ? u16(entry + 8) : (type == 4 ? u32(entry + 8) : 0);
+        if (tag == 256) out.width = value;
+        else if (tag == 277) out.channels = static_cast<uint8_t>(value);
+        else if (tag == 257) out.height = value;
+        else if (tag == 258) {
+            // One count inline; otherwise the first of several equal values
+            uint32_t count = u32(entry + 4);
+            if (type == 3 && count > 2) {
+                size_t at = u32(entry + 8);
+                if (at + 2 > size) return ProbeStatus::NeedMoreData;
+                value = u16(at);
+            }
+            out.bitDepth = static_cast<uint8_t>(value);
+        }
+    }
+
+    // Orientation and capture date (camera TIFFs and RAW containers);
+    // the EXIF sub-IFD may sit past the head, which only costs the date
+    ExifInfo exif;
+    if (ReadExifTiff(data, size, exif)) {
+        out.orientation = exif.orientation;
+        out.year = exif.year;
+        out.month = exif.month;
+    }
+    if (!out.bitDepth) out.bitDepth = 1;  // BitsPerSample defaults to 1
+    if (!out.channels) out.channels = 1;
+    return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+}
+
+ProbeStatus ProbeWebp(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    if (size < 30) return ProbeStatus::NeedMoreData;
+    const uint8_t* chunk = data + 12;
+    out.bitDepth = 8;
+    out.channels = 3;
+    if (std::memcmp(chunk, "VP8X", 4) == 0) {
+        if (chunk[8] & 0x10) out.channels = 4;  // alpha flag
+        out.width = LE24(chunk + 12) + 1;
+        out.height = LE24(chunk + 15) + 1;
+    } else if (std::memcmp(chunk, "VP8L", 4) == 0) {
+        if (chunk[8] != 0x2F) return ProbeStatus::Unsupported;
+        uint32_t bits = LE32(chunk + 9);
+        out.width = (bits & 0x3FFF) + 1;
+        out.height = ((bits >> 14) & 0x3FFF) + 1;
+        if (bits & (1u << 28)) out.channels = 4;
+    } else if (std::memcmp(chunk, "VP8 ", 4) == 0) {
+        // Key frame: 3-byte tag, start code 9D 01 2A, then 14-bit sizes
+        if (chunk[11] != 0x9D || chunk[12] != 0x01 || chunk[13] != 0x2A) return ProbeStatus::Unsupported;
+        out.width = LE16(chunk + 14) & 0x3FFF;
+        out.height = LE16(chunk + 16) & 0x3FFF;
+    } else {
+        return ProbeStatus::Unsupported;
+    }
+    return out.width && out.height ? ProbeStatus::Ok : ProbeStatus::Unsupported;
+}
+
+} // namespace
+
+ProbeStatus ProbeImage(const uint8_t* data, size_t size, ImageProbeResult& out)
+{
+    out = {};
+    if (!data || size < 12) return ProbeStatus::NeedMoreData;
+
+    if (data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) {
+        return ProbeJpeg(data, size, out);
+    }
+    if (std::memcmp(data, "\x89PNG\r\n\x1a\n", 8) == 0) {
+        return ProbePng(data, size, out);
+    }
+    if (std::memcmp(data, "GIF87a", 6) == 0 || std::memcmp(data, "GIF89a", 6) == 0) {
+        return ProbeGif(data, size, out);
+    }
+    if (data[0] == 'B' && data[1] == 'M') {
+        return ProbeBmp(data, size, out);
+    }
+    if ((data[0] == 'I' && data[1] == 'I' && data[2] == 42 && data[3] == 0) ||
+        (data[0] == 'M' && data[1] == 'M' && data[2] == 0 && data[3] == 42)) {
+        return ProbeTiff(data, size, out);
+    }
+    if (std::memcmp(data, "RIFF", 4) == 0 && std::memcmp(data + 8, "WEBP", 4) == 0) {
+        return ProbeWebp(data, size, out);
+    }
+    return ProbeStatus::Unsupported;
+}
+
+bool ProbeFile(const std::filesystem::path& path, ImageProbeResult& out)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::vector<uint8_t> head(kProbeHeadBytes);
+    file.read(reinterpret_cast<char*>(head.data()), static_cast<std::streamsize>(head.size()));
+    size_t got = static_cast<size_t>(file.gcount());
+
+    ProbeStatus status = ProbeImage(head.data(), got, out);
+    if (status == ProbeStatus::NeedMoreData && got == head.size()) {
+        head.resize(kProbeMaxBytes);
+        file.read(reinterpret_cast<char*>(head.data() + got), static_cast<std::streamsize>(kProbeMaxBytes - got));
+        got += static_cast<size_t>(file.gcount());
+        status = ProbeImage(head.data(), got, out);
+    }
+    return status == ProbeStatus::Ok;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,1141 @@
+#include "core/JpegCodec.hpp"
+#include <emmintrin.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+// Zigzag index -> natural (row-major) index. The tail absorbs out-of-range
+// k from corrupt streams without bounds checks in the hot loops.
+const uint8_t kZigZag[64 + 16] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+constexpr int kMaxComponents = 4;
+constexpr int kFastBits = 9;
+constexpr uint64_t kMaxPixels = 1ull << 28;   // larger frames go through WIC's tiled paths
+
+inline uint16_t ReadU16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+
+inline uint8_t Clamp255(int v) { return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+// DC predictor update kept in int16 range: corrupt streams can add a
+// 15-bit difference every block, and the product with the quantizer must
+// stay inside int
+inline int AddDc(int pred, int diff) { return std::clamp(pred + diff, -32768, 32767); }
+
+// ---- Huffman tables ----
+
+struct HuffmanTable {
+    uint16_t fast[1 << kFastBits] = {};  // (length << 8) | symbol; 0 = longer code
+    int16_t fastAc[1 << kFastBits] = {}; // (value << 8) | (run << 4) | total bits; 0 = use fast
+    int32_t maxCode[18] = {};            // largest code of each length, -1 if none
+    int32_t valOffset[17] = {};          // symbol index = code + valOffset[length]
+    uint8_t values[256] = {};
+    bool defined = false;
+
+    bool Build(const uint8_t counts[16], const uint8_t* symbols, int symbolCount)
+    {
+        std::memset(fast, 0, sizeof(fast));
+        std::memcpy(values, symbols, symbolCount);
+
+        int code = 0;
+        int k = 0;
+        for (int len = 1; len <= 16; ++len) {
+            valOffset[len] = k - code;
+            // Kraft check before any fill: over-subscribed lengths would
+            // index past fast[]
+            if (code + counts[len - 1] > (1 << len)) return false;
+            for (int i = 0; i < counts[len - 1]; ++i, ++k, ++code) {
+                if (len <= kFastBits) {
+                    int shift = kFastBits - len;
+                    int first = code << shift;
+                    for (int j = 0; j < (1 << shift) && first + j < (1 << kFastBits); ++j) {
+                        fast[first + j] = static_cast<uint16_t>((len << 8) | symbols[k]);
+                    }
+                }
+            }
+            maxCode[len] = counts[len - 1] ? code - 1 : -1;
+            code <<= 1;
+        }
+        maxCode[17] = 0x7FFFFFFF;
+        defined = true;
+        BuildFastAc();
+        return true;
+    }
+
+    // AC codes whose magnitude bits also fit in the peek window decode
+    // run and value in one lookup (most coefficients of a typical photo)
+    void BuildFastAc()
+    {
+        for (int i = 0; i < (1 << kFastBits); ++i) {
+            fastAc[i] = 0;
+            if (!fast[i]) continue;
+            int len = fast[i] >> 8;
+            int run = (fast[i] >> 4) & 15;
+            int size = fast[i] & 15;
+            if (size == 0 || len + size > kFastBits) continue;
+            int value = ((i << len) & ((1 << kFastBits) - 1)) >> (kFastBits - size);
+            if (value < (1 << (size - 1))) value -= (1 << size) - 1;
+            if (value >= -128 && value <= 127) {
+                fastAc[i] = static_cast<int16_t>(value * 256 + run * 16 + len + size);
+            }
+        }
+    }
+};
+
+// ---- Entropy-coded segment reader ----
+
+class BitReader {
+public:
+    void Reset(const uint8_t* pos, const uint8_t* end)
+    {
+        pos_ = pos;
+        end_ = end;
+        buffer_ = 0;
+        bits_ = 0;
+        atMarker_ = false;
+    }
+
+    const uint8_t* Position() const { return pos_; }
+
+    void Fill()
+    {
+        while (bits_ <= 56) {
+            uint32_t byte = 0;
+            if (!atMarker_ && pos_ < end_) {
+                byte = *pos_;
+                if (byte == 0xFF) {
+                    uint8_t next = (pos_ + 1 < end_) ? pos_[1] : 0xD9;
+                    if (next == 0x00) {
+                        pos_ += 2;      // stuffed zero
+                    } else {
+                        atMarker_ = true;  // feed zeros until the marker is consumed
+                        byte = 0;
+                    }
+                } else {
+                    ++pos_;
+                }
+            }
+            buffer_ |= static_cast<uint64_t>(byte) << (56 - bits_);
+            bits_ += 8;
+        }
+    }
+
+    uint32_t Peek(int n) const { return static_cast<uint32_t>(buffer_ >> (64 - n)); }
+    void Skip(int n) { buffer_ <<= n; bits_ -= n; }
+
+    // At least 16 bits buffered, top kFastBits returned
+    uint32_t PeekFast()
+    {
+        if (bits_ < 16) Fill();
+        return Peek(kFastBits);
+    }
+
+    int GetBits(int n)
+    {
+        if (n == 0) return 0;
+        if (bits_ < n) Fill();
+        int v = static_cast<int>(Peek(n));
+        Skip(n);
+        return v;
+    }
+
+    int GetBit() { return GetBits(1); }
+
+    // Huffman-coded value of n bits, sign-extended (JPEG "EXTEND")
+    int Receive(int n)
+    {
+        if (n == 0) return 0;
+        int v = GetBits(n);
+        return v < (1 << (n - 1)) ? v - (1 << n) + 1 : v;
+    }
+
+    int Decode(const HuffmanTable& table)
+    {
+        if (bits_ < 16) Fill();
+        uint16_t entry = table.fast[Peek(kFastBits)];
+        if (entry) {
+            Skip(entry >> 8);
+            return entry & 0xFF;
+        }
+        for (int len = kFastBits + 1; len <= 16; ++len) {
+            int code = static_cast<int>(Peek(len));
+            if (code <= table.maxCode[len]) {
+                Skip(len);
+                return table.values[(code + table.valOffset[len]) & 0xFF];
+            }
+        }
+        Skip(16);  // corrupt: no code matches
+        return 0;
+    }
+
+    // Consume the RSTn marker at the end of a restart interval
+    void Restart()
+    {
+        buffer_ = 0;
+        bits_ = 0;
+        atMarker_ = false;
+        while (pos_ + 1 < end_) {
+            if (pos_[0] == 0xFF && pos_[1] >= 0xD0 && pos_[1] <= 0xD7) {
+                pos_ += 2;
+                return;
+            }
+            if (pos_[0] == 0xFF && pos_[1] != 0x00 && pos_[1] != 0xFF) return;  // other marker: leave it
+            ++pos_;
+        }
+    }
+
+    // Move past the scan's entropy data to the next marker
+    void SkipToMarker()
+    {
+        while (pos_ + 1 < end_) {
+            if (pos_[0] == 0xFF && pos_[1] != 0x00 && !(pos_[1] >= 0xD0 && pos_[1] <= 0xD7) &&
+                pos_[1] != 0xFF) {
+                return;
+            }
+            ++pos_;
+        }
+        pos_ = end_;
+    }
+
+private:
+    const uint8_t* pos_ = nullptr;
+    const uint8_t* end_ = nullptr;
+    uint64_t buffer_ = 0;
+    int bits_ = 0;
+    bool atMarker_ = false;
+};
+
+// ---- IDCT (libjpeg jidctint "islow" arithmetic) ----
+
+constexpr int kConstBits = 13;
+constexpr int kPass1Bits = 2;
+
+constexpr int32_t kFix_0_298631336 = 2446;
+constexpr int32_t kFix_0_390180644 = 3196;
+constexpr int32_t kFix_0_541196100 = 4433;
+constexpr int32_t kFix_0_765366865 = 6270;
+constexpr int32_t kFix_0_899976223 = 7373;
+constexpr int32_t kFix_1_175875602 = 9633;
+constexpr int32_t kFix_1_501321110 = 12299;
+constexpr int32_t kFix_1_847759065 = 15137;
+constexpr int32_t kFix_1_961570560 = 16069;
+constexpr int32_t kFix_2_053119869 = 16819;
+constexpr int32_t kFix_2_562915447 = 20995;
+constexpr int32_t kFix_3_072711026 = 25172;
+
+// in: dequantized coefficients, natural order. out: 8x8 samples at stride.
+void Idct8x8_SSE2(const int16_t* in, uint8_t* out, size_t stride)
+{
+    auto pair = [](int32_t a, int32_t b) {
+        return _mm_setr_epi16(static_cast<int16_t>(a), static_cast<int16_t>(b),
+                              static_cast<int16_t>(a), static_cast<int16_t>(b),
+                              static_cast<int16_t>(a), static_cast<int16_t>(b),
+                              static_cast<int16_t>(a), static_cast<int16_t>(b));
+    };
+    // Rotations: madd of interleaved (x, y) with (c0, c1) = x*c0 + y*c1
+    const __m128i rotEven0 = pair(kFix_0_541196100, kFix_0_541196100 - kFix_1_847759065);
+    const __m128i rotEven1 = pair(kFix_0_541196100 + kFix_0_765366865, kFix_0_541196100);
+    const __m128i rotSum0 = pair(kFix_1_175875602 - kFix_0_899976223, kFix_1_175875602);
+    const __m128i rotSum1 = pair(kFix_1_175875602, kFix_1_175875602 - kFix_2_562915447);
+    const __m128i rot73_0 = pair(kFix_0_298631336 - kFix_1_961570560, -kFix_1_961570560);
+    const __m128i rot73_1 = pair(-kFix_1_961570560, kFix_3_072711026 - kFix_1_961570560);
+    const __m128i rot51_0 = pair(kFix_2_053119869 - kFix_0_390180644, -kFix_0_390180644);
+    const __m128i rot51_1 = pair(-kFix_0_390180644, kFix_1_501321110 - kFix_0_390180644);
+
+    __m128i row[8];
+    for (int i = 0; i < 8; ++i) {
+        row[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 8));
+    }
+
+    // One 1-D pass over 8 vectors (computes all 8 columns at once).
+    // bias is added to the even base so every output picks it up once.
+    auto pass = [&](__m128i* r, __m128i bias, int shift) {
+        auto rot = [](__m128i x, __m128i y, __m128i c0, __m128i c1,
+                      __m128i& out0Lo, __m128i& out0Hi, __m128i& out1Lo, __m128i& out1Hi) {
+            __m128i lo = _mm_unpacklo_epi16(x, y);
+            __m128i hi = _mm_unpackhi_epi16(x, y);
+            out0Lo = _mm_madd_epi16(lo, c0);
+            out0Hi = _mm_madd_epi16(hi, c0);
+            out1Lo = _mm_madd_epi16(lo, c1);
+            out1Hi = _mm_madd_epi16(hi, c1);
+        };
+
+        // Even part
+        __m128i t2Lo, t2Hi, t3Lo, t3Hi;
+        rot(r[2], r[6], rotEven0, rotEven1, t2Lo, t2Hi, t3Lo, t3Hi);
+
+        __m128i sum04 = _mm_add_epi16(r[0], r[4]);
+        __m128i dif04 = _mm_sub_epi16(r[0], r[4]);
+        // (x << 16) >> 3 == x << kConstBits, sign-extended
+        __m128i t0Lo = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), sum04), 16 - kConstBits), bias);
+        __m128i t0Hi = _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), sum04), 16 - kConstBits), bias);
+        __m128i t1Lo = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), dif04), 16 - kConstBits), bias);
+        __m128i t1Hi = _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), dif04), 16 - kConstBits), bias);
+
+        __m128i t10Lo = _mm_add_epi32(t0Lo, t3Lo), t10Hi = _mm_add_epi32(t0Hi, t3Hi);
+        __m128i t13Lo = _mm_sub_epi32(t0Lo, t3Lo), t13Hi = _mm_sub_epi32(t0Hi, t3Hi);
+        __m128i t11Lo = _mm_add_epi32(t1Lo, t2Lo), t11Hi = _mm_add_epi32(t1Hi, t2Hi);
+        __m128i t12Lo = _mm_sub_epi32(t1Lo, t2Lo), t12Hi = _mm_sub_epi32(t1Hi, t2Hi);
+
+        // Odd part (rows 7, 5, 3, 1)
+        __m128i sum71 = _mm_add_epi16(r[7], r[1]);
+        __m128i sum53 = _mm_add_epi16(r[5], r[3]);
+        __m128i s0Lo, s0Hi, s1Lo, s1Hi;
+        rot(sum71, sum53, rotSum0, rotSum1, s0Lo, s0Hi, s1Lo, s1Hi);
+        __m128i a0Lo, a0Hi, a2Lo, a2Hi;
+        rot(r[7], r[3], rot73_0, rot73_1, a0Lo, a0Hi, a2Lo, a2Hi);
+        __m128i a1Lo, a1Hi, a3Lo, a3Hi;
+        rot(r[5], r[1], rot51_0, rot51_1, a1Lo, a1Hi, a3Lo, a3Hi);
+
+        __m128i o0Lo = _mm_add_epi32(a0Lo, s0Lo), o0Hi = _mm_add_epi32(a0Hi, s0Hi);
+        __m128i o1Lo = _mm_add_epi32(a1Lo, s1Lo), o1Hi = _mm_add_epi32(a1Hi, s1Hi);
+        __m128i o2Lo = _mm_add_epi32(a2Lo, s1Lo), o2Hi = _mm_add_epi32(a2Hi, s1Hi);
+        __m128i o3Lo = _mm_add_epi32(a3Lo, s0Lo), o3Hi = _mm_add_epi32(a3Hi, s0Hi);
+
+        const __m128i sh = _mm_cvtsi32_si128(shift);
+        auto butterfly = [&](__m128i aLo, __m128i aHi, __m128i bLo, __m128i bHi, __m128i& sum, __m128i& dif) {
+            sum = _mm_packs_epi32(_mm_sra_epi32(_mm_add_epi32(aLo, bLo), sh),
+                                  _mm_sra_epi32(_mm_add_epi32(aHi, bHi), sh));
+            dif = _mm_packs_epi32(_mm_sra_epi32(_mm_sub_epi32(aLo, bLo), sh),
+                                  _mm_sra_epi32(_mm_sub_epi32(aHi, bHi), sh));
+        };
+        butterfly(t10Lo, t10Hi, o3Lo, o3Hi, r[0], r[7]);
+        butterfly(t11Lo, t11Hi, o2Lo, o2Hi, r[1], r[6]);
+        butterfly(t12Lo, t12Hi, o1Lo, o1Hi, r[2], r[5]);
+        butterfly(t13Lo, t13Hi, o0Lo, o0Hi, r[3], r[4]);
+    };
+
+    auto transpose = [](__m128i* r) {
+        __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+        __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+        __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+        __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+        __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+        __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+        __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+        __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+        __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+        __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+        __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+        __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+        __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+        __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+        __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+        __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+        r[0] = _mm_unpacklo_epi64(b0, b4);
+        r[1] = _mm_unpackhi_epi64(b0, b4);
+        r[2] = _mm_unpacklo_epi64(b1, b5);
+        r[3] = _mm_unpackhi_epi64(b1, b5);
+        r[4] = _mm_unpacklo_epi64(b2, b6);
+        r[5] = _mm_unpackhi_epi64(b2, b6);
+        r[6] = _mm_unpacklo_epi64(b3, b7);
+        r[7] = _mm_unpackhi_epi64(b3, b7);
+    };
+
+    // Columns, then rows; the second pass folds in the +128 level shift
+    const int shift1 = kConstBits - kPass1Bits;
+    const int shift2 = kConstBits + kPass1Bits + 3;
+    pass(row, _mm_set1_epi32(1 << (shift1 - 1)), shift1);
+    transpose(row);
+    pass(row, _mm_set1_epi32((1 << (shift2 - 1)) + (128 << shift2)), shift2);
+    transpose(row);
+
+    for (int i = 0; i < 8; i += 2) {
+        __m128i packed = _mm_packus_epi16(row[i], row[i + 1]);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i * stride), packed);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + (i + 1) * stride), _mm_srli_si128(packed, 8));
+    }
+}
+
+// Blocks with only a DC term (most of a smooth photo) are a flat fill
+inline bool IdctDcOnly(const int16_t* in, uint8_t* out, size_t stride)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i any = _mm_insert_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), 0, 0);
+    for (int i = 1; i < 8; ++i) {
+        any = _mm_or_si128(any, _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 8)));
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xFFFF) return false;
+
+    uint8_t v = Clamp255(((in[0] + 4) >> 3) + 128);
+    for (int y = 0; y < 8; ++y) {
+        std::memset(out + y * stride, v, 8);
+    }
+    return true;
+}
+
+// Reduced-size IDCT for scaled decodes: n x n output (n = 4, 2) from the
+// n x n lowest-frequency coefficients. Each output sample is the full 8x8
+// reconstruction evaluated at the centre of the 8/n x 8/n pixel area it
+// replaces, with the frequencies it can't represent dropped.
+void IdctScaled(const int16_t* in, uint8_t* out, size_t stride, int n)
+{
+    // kernel[n][u][x] = c(u)/2 * cos((2x+1) u pi / 2n), 2^12 fixed point
+    static const auto kernel = [] {
+        std::array<std::array<std::array<int32_t, 4>, 4>, 5> k{};
+        for (int size : {2, 4}) {
+            for (int u = 0; u < size; ++u) {
+                double cu = u == 0 ? std::sqrt(0.5) : 1.0;
+                for (int x = 0; x < size; ++x) {
+                    double v = cu / 2.0 * std::cos((2 * x + 1) * u * 3.14159265358979323846 / (2 * size));
+                    k[size][u][x] = static_cast<int32_t>(std::lround(v * 4096.0));
+                }
+            }
+        }
+        return k;
+    }();
+    const auto& k = kernel[n];
+
+    // Columns (2 fractional bits kept), then rows with the level shift
+    int32_t tmp[4][4];
+    for (int u = 0; u < n; ++u) {
+        for (int y = 0; y < n; ++y) {
+            int32_t sum = 0;
+            for (int v = 0; v < n; ++v) sum += in[v * 8 + u] * k[v][y];
+            tmp[y][u] = (sum + (1 << 9)) >> 10;
+        }
+    }
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            int32_t sum = (128 << 14) + (1 << 13);
+            for (int u = 0; u < n; ++u) sum += tmp[y][u] * k[u][x];
+            out[y * stride + x] = Clamp255(sum >> 14);
+        }
+    }
+}
+
+// Writes one dequantized block as blockPx x blockPx samples (8 = full size)
+inline void OutputBlock(const int16_t* block, uint8_t* out, size_t stride, int blockPx)
+{
+    if (blockPx == 8) {
+        if (!IdctDcOnly(block, out, stride)) {
+            Idct8x8_SSE2(block, out, stride);
+        }
+    } else if (blockPx == 1) {
+        *out = Clamp255(((block[0] + 4) >> 3) + 128);  // DC average
+    } else {
+        IdctScaled(block, out, stride, blockPx);
+    }
+}
+
+// Smallest DCT scale whose output still covers a maxDimension box, as
+// samples per 8x8 block (8 = full resolution)
+int ChooseBlockPx(int width, int height, uint32_t maxDimension)
+{
+    if (maxDimension == 0) return 8;
+    const int longest = std::max(width, height);
+    const int target = std::min(static_cast<int>(maxDimension), longest);
+    for (int blockPx : {1, 2, 4}) {
+        if ((longest * blockPx + 7) / 8 >= target) return blockPx;
+    }
+    return 8;
+}
+
+// ---- Decoder state ----
+
+struct Component {
+    uint8_t id = 0;
+    int h = 1, v = 1;          // sampling factors
+    int tq = 0;                // quantization table
+    int dcTable = 0, acTable = 0;
+    int blockPx = 8;                // output samples per block side
+    int blocksW = 0, blocksH = 0;   // padded to whole MCUs
+    int usedW = 0, usedH = 0;       // blocks covering the component's own extent
+    int dcPred = 0;
+    std::vector<uint8_t> plane;     // blocksW*blockPx x blocksH*blockPx samples
+    std::vector<int16_t> coeffs;    // progressive: all blocks, natural order, not dequantized
+    size_t Stride() const { return static_cast<size_t>(blocksW) * blockPx; }
+    uint8_t* BlockOut(int bx, int by)
+    {
+        return plane.data() + static_cast<size_t>(by) * blockPx * Stride() + static_cast<size_t>(bx) * blockPx;
+    }
+};
+
+class JpegDecoder {
+public:
+    JpegDecoder(const uint8_t* data, size_t size, uint32_t maxDimension = 0)
+        : data_(data), end_(data + size), maxDimension_(maxDimension) {}
+
+    bool ReadHeaderOnly(uint32_t& width, uint32_t& height);
+    bool Decode(CodecImage& out);
+
+private:
+    bool ParseMarkers(bool headerOnly);
+    bool ReadSOF(const uint8_t* p, uint16_t length, uint8_t marker);
+    bool ReadDHT(const uint8_t* p, uint16_t length);
+    bool ReadDQT(const uint8_t* p, uint16_t length);
+    bool ReadSOS(const uint8_t* p, uint16_t length);
+    bool DecodeScan();
+
+    void DecodeBlockBaseline(Component& c, int bx, int by);
+    void DecodeBlockDCFirst(Component& c, int bx, int by);
+    void DecodeBlockDCRefine(Component& c, int bx, int by);
+    void DecodeBlockACFirst(Component& c, int bx, int by);
+    void DecodeBlockACRefine(Component& c, int bx, int by);
+
+    void FinishProgressive();
+    void ConvertColor(CodecImage& out);
+
+    const uint8_t* data_;
+    const uint8_t* end_;
+    const uint8_t* pos_ = nullptr;
+
+    uint32_t maxDimension_;
+    int width_ = 0, height_ = 0;
+    int blockPx_ = 8;
+    int outWidth_ = 0, outHeight_ = 0;  // width_/height_ at the chosen DCT scale
+    bool progressive_ = false;
+    bool adobeRgb_ = false;       // APP14 transform 0 on 3 components
+    bool sawAdobe_ = false;
+    bool sawJfif_ = false;
+    int restartInterval_ = 0;
+    int hmax_ = 1, vmax_ = 1;
+    int mcusX_ = 0, mcusY_ = 0;
+
+    int componentCount_ = 0;
+    Component components_[kMaxComponents];
+    uint16_t qt_[4][64] = {};     // natural order
+    HuffmanTable dcTables_[4];
+    HuffmanTable acTables_[4];
+
+    // Current scan
+    int scanCount_ = 0;
+    int scanComponents_[kMaxComponents] = {};
+    int ss_ = 0, se_ = 63, ah_ = 0, al_ = 0;
+    int eobRun_ = 0;
+    BitReader bits_;
+};
+
+bool JpegDecoder::ReadSOF(const uint8_t* p, uint16_t length, uint8_t marker)
+{
+    if (length < 8) return false;
+    if (p[0] != 8) return false;  // 12-bit precision: WIC
+    height_ = ReadU16(p + 1);
+    width_ = ReadU16(p + 3);
+    componentCount_ = p[5];
+    if (width_ == 0 || height_ == 0) return false;  // DNL-defined height: rare, leave to WIC
+    if (static_cast<uint64_t>(width_) * height_ > kMaxPixels) return false;
+    if (componentCount_ != 1 && componentCount_ != 3) return false;  // CMYK/YCCK: WIC
+    if (length < 6 + componentCount_ * 3) return false;
+
+    progressive_ = (marker == 0xC2);
+    blockPx_ = ChooseBlockPx(width_, height_, maxDimension_);
+    outWidth_ = (width_ * blockPx_ + 7) / 8;
+    outHeight_ = (height_ * blockPx_ + 7) / 8;
+    hmax_ = vmax_ = 1;
+    for (int i = 0; i < componentCount_; ++i) {
+        Component& c = components_[i];
+        c.id = p[6 + i * 3];
+        c.h = p[7 + i * 3] >> 4;
+        c.v = p[7 + i * 3] & 15;
+        c.tq = p[8 + i * 3] & 3;
+        if (c.h < 1 || c.h > 4 || c.v < 1 || c.v > 4) return false;
+        hmax_ = std::max(hmax_, c.h);
+        vmax_ = std::max(vmax_, c.v);
+    }
+    if (componentCount_ == 1) {
+        // A single component is never interleaved: one block per MCU
+        components_[0].h = components_[0].v = hmax_ = vmax_ = 1;
+    }
+    for (int i = 0; i < componentCount_; ++i) {
+        // Non-integral ratios (e.g. 3x3 luma over 2x2 chroma) are legal but
+        // the upsampler only scales by whole factors: leave them to WIC
+        if (hmax_ % components_[i].h != 0 || vmax_ % components_[i].v != 0) return false;
+    }
+
+    mcusX_ = (width_ + 8 * hmax_ - 1) / (8 * hmax_);
+    mcusY_ = (height_ + 8 * vmax_ - 1) / (8 * vmax_);
+    for (int i = 0; i < componentCount_; ++i) {
+        Component& c = components_[i];
+        c.blockPx = blockPx_;
+        c.blocksW = mcusX_ * c.h;
+        c.blocksH = mcusY_ * c.v;
+        c.usedW = ((width_ * c.h + hmax_ - 1) / hmax_ + 7) / 8;
+        c.usedH = ((height_ * c.v + vmax_ - 1) / vmax_ + 7) / 8;
+    }
+    return true;
+}
+
+bool JpegDecoder::ReadDHT(const uint8_t* p, uint16_t length)
+{
+    const uint8_t* end = p + length - 2;
+    while (p + 17 <= end) {
+        int tc = p[0] >> 4;
+        int th = p[0] & 15;
+        if (tc > 1 || th > 3) return false;
+        uint8_t counts[16];
+        std::memcpy(counts, p + 1, 16);
+        int total = 0;
+        for (uint8_t n : counts) total += n;
+        if (total > 256 || p + 17 + total > end) return false;
+        HuffmanTable& table = tc == 0 ? dcTables_[th] : acTables_[th];
+        if (!table.Build(counts, p + 17, total)) return false;
+        p += 17 + total;
+    }
+    return true;
+}
+
+bool JpegDecoder::ReadDQT(const uint8_t* p, uint16_t length)
+{
+    const uint8_t* end = p + length - 2;
+    while (p < end) {
+        int pq = p[0] >> 4;
+        int tq = p[0] & 15;
+        if (tq > 3 || pq > 1) return false;
+        size_t bytes = pq ? 128 : 64;
+        if (p + 1 + bytes > end) return false;
+        for (int k = 0; k < 64; ++k) {
+            qt_[tq][kZigZag[k]] = pq ? ReadU16(p + 1 + k * 2) : p[1 + k];
+        }
+        p += 1 + bytes;
+    }
+    return true;
+}
+
+bool JpegDecoder::ReadSOS(const uint8_t* p, uint16_t length)
+{
+    if (componentCount_ == 0 || length < 6) return false;
+    scanCount_ = p[0];
+    if (scanCount_ < 1 || scanCount_ > componentCount_ || length < 6 + scanCount_ * 2) return false;
+    for (int i = 0; i < scanCount_; ++i) {
+        uint8_t id = p[1 + i * 2];
+        int index = -1;
+        for (int c = 0; c < componentCount_; ++c) {
+            if (components_[c].id == id) index = c;
+        }
+        if (index < 0) return false;
+        scanComponents_[i] = index;
+        components_[index].dcTable = p[2 + i * 2] >> 4;
+        components_[index].acTable = p[2 + i * 2] & 15;
+        if (components_[index].dcTable > 3 || components_[index].acTable > 3) return false;
+    }
+    const uint8_t* q = p + 1 + scanCount_ * 2;
+    ss_ = q[0];
+    se_ = q[1];
+    ah_ = q[2] >> 4;
+    al_ = q[2] & 15;
+    if (!progressive_) {
+        ss_ = 0;
+        se_ = 63;
+        ah_ = al_ = 0;
+    } else if (ss_ > se_ || se_ > 63 || (ss_ == 0 && se_ != 0) || (ss_ > 0 && scanCount_ != 1)) {
+        return false;
+    }
+    return true;
+}
+
+void JpegDecoder::DecodeBlockBaseline(Component& c, int bx, int by)
+{
+    alignas(16) int16_t block[64] = {};
+    const uint16_t* q = qt_[c.tq];
+
+    int s = bits_.Decode(dcTables_[c.dcTable]);
+    c.dcPred = AddDc(c.dcPred, bits_.Receive(s & 15));
+    block[0] = static_cast<int16_t>(c.dcPred * q[0]);
+
+    const HuffmanTable& ac = acTables_[c.acTable];
+    for (int k = 1; k < 64; ) {
+        int fastAc = ac.fastAc[bits_.PeekFast()];
+        if (fastAc) {
+            k += (fastAc >> 4) & 15;
+            bits_.Skip(fastAc & 15);
+            int z = kZigZag[k];
+            block[z] = static_cast<int16_t>((fastAc >> 8) * q[z]);
+            ++k;
+            continue;
+        }
+        int rs = bits_.Decode(ac);
+        int r = rs >> 4;
+        s = rs & 15;
+        if (s) {
+            k += r;
+            int z = kZigZag[k];
+            block[z] = static_cast<int16_t>(bits_.Receive(s) * q[z]);
+            ++k;
+        } else {
+            if (r != 15) break;  // EOB
+            k += 16;
+        }
+    }
+
+    OutputBlock(block, c.BlockOut(bx, by), c.Stride(), c.blockPx);
+}
+
+void JpegDecoder::DecodeBlockDCFirst(Component& c, int bx, int by)
+{
+    int16_t* block = c.coeffs.data() + (static_cast<size_t>(by) * c.blocksW + bx) * 64;
+    int s = bits_.Decode(dcTables_[c.dcTable]);
+    c.dcPred = AddDc(c.dcPred, bits_.Receive(s & 15));
+    block[0] = static_cast<int16_t>(c.dcPred * (1 << al_));
+}
+
+void JpegDecoder::DecodeBlockDCRefine(Component& c, int bx, int by)
+{
+    int16_t* block = c.coeffs.data() + (static_cast<size_t>(by) * c.blocksW + bx) * 64;
+    if (bits_.GetBit()) {
+        block[0] = static_cast<int16_t>(block[0] | (1 << al_));
+    }
+}
+
+void JpegDecoder::DecodeBlockACFirst(Component& c, int bx, int by)
+{
+    if (eobRun_ > 0) {
+        --eobRun_;
+        return;
+    }
+    int16_t* block = c.coeffs.data() + (static_cast<size_t>(by) * c.blocksW + bx) * 64;
+    const HuffmanTable& ac = acTables_[c.acTable];
+    for (int k = ss_; k <= se_; ) {
+        int rs = bits_.Decode(ac);
+        int r = rs >> 4;
+        int s = rs & 15;
+        if (s) {
+            k += r;
+            block[kZigZag[k]] = static_cast<int16_t>(bits_.Receive(s) * (1 << al_));
+            ++k;
+        } else {
+            if (r < 15) {
+                eobRun_ = (1 << r) - 1;
+                if (r) eobRun_ += bits_.GetBits(r);
+                break;
+            }
+            k += 16;
+        }
+    }
+}
+
+void JpegDecoder::DecodeBlockACRefine(Component& c, int bx, int by)
+{
+    int16_t* block = c.coeffs.data() + (static_cast<size_t>(by) * c.blocksW + bx) * 64;
+    const int p1 = 1 << al_;
+    const int m1 = -1 << al_;
+
+    // Correction bit for a coefficient that is already nonzero
+    auto refine = [&](int16_t& coef) {
+        if (bits_.GetBit() && (coef & p1) == 0) {
+            coef = static_cast<int16_t>(coef + (coef >= 0 ? p1 : m1));
+        }
+    };
+
+    int k = ss_;
+    if (eobRun_ == 0) {
+        const HuffmanTable& ac = acTables_[c.acTable];
+        for (; k <= se_; ++k) {
+            int rs = bits_.Decode(ac);
+            int r = rs >> 4;
+            int s = rs & 15;
+            int value = 0;
+            if (s) {
+                value = bits_.GetBit() ? p1 : m1;  // s is always 1 here
+            } else if (r != 15) {
+                eobRun_ = 1 << r;
+                if (r) eobRun_ += bits_.GetBits(r);
+                break;
+            }
+
+            // Skip r zero coefficients, refining nonzero ones on the way
+            for (; k <= se_; ++k) {
+                int16_t& coef = block[kZigZag[k]];
+                if (coef != 0) {
+                    refine(coef);
+                } else {
+                    if (r == 0) break;
+                    --r;
+                }
+            }
+            if (value && k <= se_) {
+                block[kZigZag[k]] = static_cast<int16_t>(value);
+            }
+        }
+    }
+
+    if (eobRun_ > 0) {
+        for (; k <= se_; ++k) {
+            int16_t& coef = block[kZigZag[k]];
+            if (coef != 0) refine(coef);
+        }
+        --eobRun_;
+    }
+}
+
+bool JpegDecoder::DecodeScan()
+{
+    bits_.Reset(pos_, end_);
+    eobRun_ = 0;
+    for (int i = 0; i < scanCount_; ++i) {
+        components_[scanComponents_[i]].dcPred = 0;
+    }
+
+    using BlockFn = void (JpegDecoder::*)(Component&, int, int);
+    BlockFn decodeBlock = &JpegDecoder::DecodeBlockBaseline;
+    if (progressive_) {
+        if (ss_ == 0) {
+            decodeBlock = ah_ ? &JpegDecoder::DecodeBlockDCRefine : &JpegDecoder::DecodeBlockDCFirst;
+        } else {
+            decodeBlock = ah_ ? &JpegDecoder::DecodeBlockACRefine : &JpegDecoder::DecodeBlockACFirst;
+        }
+    }
+
+    // Tables the scan uses must exist (AC tables aren't read by DC scans)
+    for (int i = 0; i < scanCount_; ++i) {
+        const Component& c = components_[scanComponents_[i]];
+        bool needDc = !progressive_ || (ss_ == 0 && ah_ == 0);
+        bool needAc = !progressive_ || ss_ > 0;
+        if ((needDc && !dcTables_[c.dcTable].defined) || (needAc && !acTables_[c.acTable].defined)) {
+            return false;
+        }
+    }
+
+    int restartsLeft = restartInterval_;
+    auto nextUnit = [&]() {
+        if (restartInterval_ && --restartsLeft == 0) {
+            bits_.Restart();
+            restartsLeft = restartInterval_;
+            eobRun_ = 0;
+            for (int i = 0; i < scanCount_; ++i) {
+                components_[scanComponents_[i]].dcPred = 0;
+            }
+        }
+    };
+
+    if (scanCount_ == 1) {
+        // Non-interleaved: blocks in raster order over the component's own extent
+        Component& c = components_[scanComponents_[0]];
+        for (int by = 0; by < c.usedH; ++by) {
+            for (int bx = 0; bx < c.usedW; ++bx) {
+                (this->*decodeBlock)(c, bx, by);
+                nextUnit();
+            }
+        }
+    } else {
+        for (int my = 0; my < mcusY_; ++my) {
+            for (int mx = 0; mx < mcusX_; ++mx) {
+                for (int i = 0; i < scanCount_; ++i) {
+                    Component& c = components_[scanComponents_[i]];
+                    for (int v = 0; v < c.v; ++v) {
+                        for (int h = 0; h < c.h; ++h) {
+                            (this->*decodeBlock)(c, mx * c.h + h, my * c.v + v);
+                        }
+                    }
+                }
+                nextUnit();
+            }
+        }
+    }
+
+    bits_.SkipToMarker();
+    pos_ = bits_.Position();
+    return true;
+}
+
+bool JpegDecoder::ParseMarkers(bool headerOnly)
+{
+    pos_ = data_;
+    if (end_ - pos_ < 4 || pos_[0] != 0xFF || pos_[1] != 0xD8) return false;
+    pos_ += 2;
+
+    bool frameSeen = false;
+    bool scanSeen = false;
+    while (pos_ + 4 <= end_) {
+        if (pos_[0] != 0xFF) {
+            ++pos_;  // garbage between segments
+            continue;
+        }
+        uint8_t marker = pos_[1];
+        if (marker == 0xFF) {
+            ++pos_;  // fill byte
+            continue;
+        }
+        pos_ += 2;
+        if (marker == 0xD9) break;                          // EOI
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+
+        uint16_t length = ReadU16(pos_);
+        if (length < 2 || pos_ + length > end_) return scanSeen;
+        const uint8_t* p = pos_ + 2;
+
+        switch (marker) {
+        case 0xC0: case 0xC1: case 0xC2:
+            if (frameSeen || !ReadSOF(p, length - 2, marker)) return false;
+            frameSeen = true;
+            if (headerOnly) return true;
+            for (int i = 0; i < componentCount_; ++i) {
+                Component& c = components_[i];
+                c.plane.assign(c.Stride() * c.blocksH * c.blockPx, 0);
+                if (progressive_) {
+                    c.coeffs.assign(static_cast<size_t>(c.blocksW) * c.blocksH * 64, 0);
+                }
+            }
+            break;
+        case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+        case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+            return false;  // lossless / hierarchical / arithmetic: WIC
+        case 0xC4:
+            if (!ReadDHT(p, length)) return false;
+            break;
+        case 0xDB:
+            if (!ReadDQT(p, length)) return false;
+            break;
+        case 0xDD:
+            if (length < 4) return false;
+            restartInterval_ = ReadU16(p);
+            break;
+        case 0xE0:
+            if (length >= 7 && std::memcmp(p, "JFIF", 4) == 0) sawJfif_ = true;
+            break;
+        case 0xEE:
+            if (length >= 14 && std::memcmp(p, "Adobe", 5) == 0) {
+                sawAdobe_ = true;
+                adobeRgb_ = (p[11] == 0);
+            }
+            break;
+        case 0xDA:
+            if (!frameSeen || !ReadSOS(p, length)) return false;
+            pos_ += length;
+            if (!DecodeScan()) return false;
+            scanSeen = true;
+            continue;
+        default:
+            break;  // APPn, COM, DNL...
+        }
+        pos_ += length;
+    }
+    return frameSeen && scanSeen;
+}
+
+void JpegDecoder::FinishProgressive()
+{
+    alignas(16) int16_t block[64];
+    for (int i = 0; i < componentCount_; ++i) {
+        Component& c = components_[i];
+        const uint16_t* q = qt_[c.tq];
+        for (int by = 0; by < c.usedH; ++by) {
+            for (int bx = 0; bx < c.usedW; ++bx) {
+                const int16_t* coef = c.coeffs.data() + (static_cast<size_t>(by) * c.blocksW + bx) * 64;
+                for (int k = 0; k < 64; ++k) {
+                    block[k] = static_cast<int16_t>(coef[k] * q[k]);
+                }
+                OutputBlock(block, c.BlockOut(bx, by), c.Stride(), c.blockPx);
+            }
+        }
+        std::vector<int16_t>().swap(c.coeffs);
+    }
+}
+
+// YCbCr -> BGRA, 8 pixels per step. Fixed point 2^14 (libjpeg's jdcolor
+// constants), products via madd on interleaved (Cb, Cr) pairs.
+void YCbCrRowToBGRA(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* out, int width)
+{
+    constexpr int kCrR = 22970;    // 1.40200
+    constexpr int kCbG = -5638;    // -0.34414
+    constexpr int kCrG = -11700;   // -0.71414
+    constexpr int kCbB = 29032;    // 1.77200
+    constexpr int kRound = 1 << 13;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i coefR = _mm_setr_epi16(0, kCrR, 0, kCrR, 0, kCrR, 0, kCrR);
+    const __m128i coefG = _mm_setr_epi16(kCbG, kCrG, kCbG, kCrG, kCbG, kCrG, kCbG, kCrG);
+    const __m128i coefB = _mm_setr_epi16(kCbB, 0, kCbB, 0, kCbB, 0, kCbB, 0);
+    const __m128i round = _mm_set1_epi32(kRound);
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i yv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+        __m128i cbv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb + x)), zero), bias);
+        __m128i crv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cr + x)), zero), bias);
+        __m128i lo = _mm_unpacklo_epi16(cbv, crv);
+        __m128i hi = _mm_unpackhi_epi16(cbv, crv);
+
+        auto channel = [&](__m128i coef) {
+            __m128i a = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, coef), round), 14);
+            __m128i b = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(hi, coef), round), 14);
+            return _mm_adds_epi16(yv, _mm_packs_epi32(a, b));
+        };
+        __m128i r = _mm_packus_epi16(channel(coefR), zero);
+        __m128i g = _mm_packus_epi16(channel(coefG), zero);
+        __m128i b = _mm_packus_epi16(channel(coefB), zero);
+
+        __m128i bg = _mm_unpacklo_epi8(b, g);
+        __m128i ra = _mm_unpacklo_epi8(r, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+    for (; x < width; ++x) {
+        int yy = y[x], cbb = cb[x] - 128, crr = cr[x] - 128;
+        uint8_t* px = out + x * 4;
+        px[0] = Clamp255(yy + ((kCbB * cbb + kRound) >> 14));
+        px[1] = Clamp255(yy + ((kCbG * cbb + kCrG * crr + kRound) >> 14));
+        px[2] = Clamp255(yy + ((kCrR * crr + kRound) >> 14));
+        px[3] = 255;
+    }
+}
+
+// Chroma upsampling by linear interpolation between sample centres
+// (libjpeg's "fancy" upsampling for 2x; any integer ratio works).
+class Upsampler {
+public:
+    void Init(const Component& c, int hmax, int vmax, int outWidth)
+    {
+        ratioX_ = hmax / c.h;
+        ratioY_ = vmax / c.v;
+        width_ = (outWidth + ratioX_ - 1) / ratioX_ + 1;
+        width_ = std::min(width_, c.blocksW * c.blockPx);
+        row_.resize(static_cast<size_t>(width_));
+        out_.resize(static_cast<size_t>(outWidth) + 16);
+
+        // Horizontal taps: source index and weight (of the next sample) in 1/256
+        xIndex_.resize(outWidth);
+        xWeight_.resize(outWidth);
+        for (int x = 0; x < outWidth; ++x) {
+            int pos = ((2 * x + 1) * 256) / (2 * ratioX_) - 128;
+            int x0 = pos >> 8;
+            int w = pos - x0 * 256;
+            if (x0 < 0) { x0 = 0; w = 0; }
+            if (x0 >= width_ - 1) { x0 = width_ - 1; w = 0; }
+            xIndex_[x] = x0;
+            xWeight_[x] = static_cast<uint16_t>(w);
+        }
+    }
+
+    bool Identity() const { return ratioX_ == 1 && ratioY_ == 1; }
+
+    const uint8_t* Row(const Component& c, int y, int outWidth)
+    {
+        const size_t stride = c.Stride();
+        const int rows = c.blocksH * c.blockPx;
+        int pos = ((2 * y + 1) * 256) / (2 * ratioY_) - 128;
+        int y0 = pos >> 8;
+        int w = pos - y0 * 256;
+        if (y0 < 0) { y0 = 0; w = 0; }
+        if (y0 >= rows - 1) { y0 = rows - 1; w = 0; }
+
+        const uint8_t* a = c.plane.data() + static_cast<size_t>(y0) * stride;
+        const uint8_t* b = w ? a + stride : a;
+        for (int x = 0; x < width_; ++x) {
+            row_[x] = static_cast<uint16_t>(a[x] * (256 - w) + b[x] * w);  // 8.8 fixed point
+        }
+        if (ratioX_ == 1) {
+            for (int x = 0; x < outWidth; ++x) out_[x] = static_cast<uint8_t>((row_[x] + 128) >> 8);
+        } else {
+            for (int x = 0; x < outWidth; ++x) {
+                int i = xIndex_[x];
+                int wx = xWeight_[x];
+                uint32_t v = row_[i] * (256 - wx) + (wx ? row_[i + 1] * wx : 0);
+                out_[x] = static_cast<uint8_t>((v + 32768) >> 16);
+            }
+        }
+        return out_.data();
+    }
+
+private:
+    int ratioX_ = 1, ratioY_ = 1;
+    int width_ = 0;
+    std::vector<uint16_t> row_;
+    std::vector<uint8_t> out_;
+    std::vector<int> xIndex_;
+    std::vector<uint16_t> xWeight_;
+};
+
+void JpegDecoder::ConvertColor(CodecImage& out)
+{
+    const size_t outStride = static_cast<size_t>(outWidth_) * 4;
+    uint8_t* dst = out.pixels.get();
+
+    if (componentCount_ == 1) {
+        const Component& c = components_[0];
+        for (int y = 0; y < outHeight_; ++y) {
+            const uint8_t* src = c.plane.data() + static_cast<size_t>(y) * c.Stride();
+            uint32_t* row = reinterpret_cast<uint32_t*>(dst + y * outStride);
+            for (int x = 0; x < outWidth_; ++x) {
+                row[x] = 0xFF000000u | (src[x] * 0x010101u);
+            }
+        }
+        return;
+    }
+
+    // Per libjpeg: RGB when Adobe says so, or when the ids spell R, G, B
+    bool rgb = (sawAdobe_ && adobeRgb_) ||
+               (!sawJfif_ && !sawAdobe_ && components_[0].id == 'R' &&
+                components_[1].id == 'G' && components_[2].id == 'B');
+
+    Upsampler up[3];
+    for (int i = 0; i < 3; ++i) up[i].Init(components_[i], hmax_, vmax_, outWidth_);
+
+    for (int y = 0; y < outHeight_; ++y) {
+        const uint8_t* ch[3];
+        for (int i = 0; i < 3; ++i) {
+            const Component& c = components_[i];
+            ch[i] = up[i].Identity() ? c.plane.data() + static_cast<size_t>(y) * c.Stride()
+                                     : up[i].Row(c, y, outWidth_);
+        }
+        uint8_t* row = dst + y * outStride;
+        if (rgb) {
+            for (int x = 0; x < outWidth_; ++x) {
+                row[x * 4 + 0] = ch[2][x];
+                row[x * 4 + 1] = ch[1][x];
+                row[x * 4 + 2] = ch[0][x];
+                row[x * 4 + 3] = 255;
+            }
+        } else {
+            YCbCrRowToBGRA(ch[0], ch[1], ch[2], row, outWidth_);
+        }
+    }
+}
+
+bool JpegDecoder::ReadHeaderOnly(uint32_t& width, uint32_t& height)
+{
+    if (!ParseMarkers(true)) return false;
+    width = static_cast<uint32_t>(width_);
+    height = static_cast<uint32_t>(height_);
+    return true;
+}
+
+bool JpegDecoder::Decode(CodecImage& out)
+{
+    if (!ParseMarkers(false)) return false;
+    if (progressive_) FinishProgressive();
+
+    size_t bytes = static_cast<size_t>(outWidth_) * outHeight_ * 4;
+    out.pixels = std::make_unique<uint8_t[]>(bytes);
+    out.width = static_cast<uint32_t>(outWidth_);
+    out.height = static_cast<uint32_t>(outHeight_);
+    out.sourceWidth = static_cast<uint32_t>(width_);
+    out.sourceHeight = static_cast<uint32_t>(height_);
+    ConvertColor(out);
+    return true;
+}
+
+} // namespace
+
+bool JpegCodec::Matches(const uint8_t* data, size_t size) const
+{
+    return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+bool JpegCodec::ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const
+{
+    JpegDecoder decoder(data, size);
+    return decoder.ReadHeaderOnly(width, height);
+}
+
+bool JpegCodec::Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const
+{
+    JpegDecoder decoder(data, size, maxDimension);
+    return decoder.Decode(out);
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
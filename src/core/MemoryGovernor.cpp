@@ -0,0 +1,209 @@
+#include "core/MemoryGovernor.hpp"
+#include "ui/Theme.hpp"
+#include <algorithm>
+#include <string>
+
+namespace UltraImageViewer {
+namespace Core {
+
+static constexpr size_t kMB = 1024ULL * 1024;
+static constexpr DWORD kElevatedLoadPercent = 80;   // dwMemoryLoad: shed the cheap tiers
+static constexpr DWORD kCriticalLoadPercent = 92;   // dwMemoryLoad: every tier to its floor
+static constexpr size_t kElevatedShedTiers = 4;     // DecodeCache..FullImage
+static constexpr float kMissSmoothing = 0.3f;       // EWMA weight of the latest window
+
+// Floors keep each tier useful (one full image, a screen of thumbnails);
+// ceilings are the fixed budgets these caches had before the governor.
+const std::array<MemoryGovernor::TierLimits, MemoryGovernor::kTierCount> MemoryGovernor::kLimits = {{
+    {32 * kMB, 512 * kMB, true},                                   // DecodeCache
+    {32 * kMB, UI::Theme::TileCacheMaxBytes, true},                // Tiles
+    {16 * kMB, 96 * kMB, true},                                    // Preview
+    {64 * kMB, 256 * kMB, true},                                   // FullImage
+    {16 * kMB, 256 * kMB, true},                                   // Tier2Compressed
+    {32 * kMB, 256 * kMB, false},                                  // SaveBuffer (not traffic-driven)
+    {128 * kMB, UI::Theme::ThumbnailCacheMaxBytes, true},          // ThumbnailGpu
+}};
+
+MemoryGovernor::MemoryGovernor()
+{
+    lowMemoryNotification_ = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+
+    // Start from the ceilings' proportions; traffic moves shares from there
+    for (size_t i = 0; i < kTierCount; ++i) {
+        tiers_[i].share = static_cast<float>((kLimits[i].maxBytes - kLimits[i].minBytes) / kMB);
+        tiers_[i].budget.store(kLimits[i].maxBytes, std::memory_order_relaxed);
+    }
+
+    lastUpdate_ = std::chrono::steady_clock::now() - kUpdateInterval;
+    Update();
+}
+
+MemoryGovernor::~MemoryGovernor()
+{
+    if (lowMemoryNotification_) {
+        CloseHandle(lowMemoryNotification_);
+    }
+}
+
+size_t MemoryGovernor::GetBudget(MemoryTier tier) const
+{
+    return tiers_[static_cast<size_t>(tier)].budget.load(std::memory_order_relaxed);
+}
+
+void MemoryGovernor::RecordHit(MemoryTier tier)
+{
+    tiers_[static_cast<size_t>(tier)].hits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryGovernor::RecordMiss(MemoryTier tier)
+{
+    tiers_[static_cast<size_t>(tier)].misses.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryGovernor::ReportUsage(MemoryTier tier, size_t bytes)
+{
+    tiers_[static_cast<size_t>(tier)].usage.store(bytes, std::memory_order_relaxed);
+}
+
+MemoryPressure MemoryGovernor::ReadPressure(uint64_t& totalPhys)
+{
+    MEMORYSTATUSEX status = {};
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        totalPhys = 0;
+        return MemoryPressure::Normal;
+    }
+    totalPhys = status.ullTotalPhys;
+
+    // The OS raises this when free physical memory runs low system-wide
+    BOOL lowMemory = FALSE;
+    if (lowMemoryNotification_ &&
+        QueryMemoryResourceNotification(lowMemoryNotification_, &lowMemory) && lowMemory) {
+        return MemoryPressure::Critical;
+    }
+    if (status.dwMemoryLoad >= kCriticalLoadPercent) return MemoryPressure::Critical;
+    if (status.dwMemoryLoad >= kElevatedLoadPercent) return MemoryPressure::Elevated;
+    return MemoryPressure::Normal;
+}
+
+bool MemoryGovernor::Update()
+{
+    std::lock_guard lock(updateMutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastUpdate_ < kUpdateInterval) return false;
+    lastUpdate_ = now;
+
+    size_t minTotal = 0, maxTotal = 0;
+    for (const auto& limits : kLimits) {
+        minTotal += limits.minBytes;
+        maxTotal += limits.maxBytes;
+    }
+
+    // A quarter of physical RAM, within what the tiers can use at all
+    uint64_t totalPhys = 0;
+    MemoryPressure pressure = ReadPressure(totalPhys);
+    size_t processBudget = totalPhys ? static_cast<size_t>(totalPhys / 4) : maxTotal;
+    processBudget = std::clamp(processBudget, minTotal, maxTotal);
+
+    MemoryPressure previous = pressure_.exchange(pressure, std::memory_order_relaxed);
+    if (pressure != previous) {
+        static const char* kNames[] = {"normal", "elevated", "critical"};
+        OutputDebugStringA(("[UIV] Memory pressure: " + std::string(kNames[static_cast<int>(pressure)]) +
+            ", process budget " + std::to_string(processBudget / kMB) + " MB\n").c_str());
+    }
+
+    std::array<size_t, kTierCount> before;
+    for (size_t i = 0; i < kTierCount; ++i) {
+        before[i] = tiers_[i].budget.load(std::memory_order_relaxed);
+    }
+
+    Rebalance(processBudget, pressure);
+
+    for (size_t i = 0; i < kTierCount; ++i) {
+        if (tiers_[i].budget.load(std::memory_order_relaxed) < before[i]) return true;
+    }
+    return false;
+}
+
+void MemoryGovernor::Rebalance(size_t processBudget, MemoryPressure pressure)
+{
+    // Marginal value of memory per tier: smoothed misses per MB it holds.
+    // Tiers above the mean grow their share, the rest give a little back.
+    std::array<float, kTierCount> marginal{};
+    float marginalSum = 0.0f;
+    int active = 0;
+    for (size_t i = 0; i < kTierCount; ++i) {
+        auto& t = tiers_[i];
+        uint32_t hits = t.hits.exchange(0, std::memory_order_relaxed);
+        uint32_t misses = t.misses.exchange(0, std::memory_order_relaxed);
+        t.missRate += kMissSmoothing * (static_cast<float>(misses) - t.missRate);
+        if (!kLimits[i].rebalance) continue;
+
+        if (hits == 0 && misses == 0) {
+            t.share = std::max(1.0f, t.share * 0.98f);  // idle tier drifts down
+            marginal[i] = -1.0f;
+            continue;
+        }
+        float usageMB = std::max(1.0f, static_cast<float>(t.usage.load(std::memory_order_relaxed) / kMB));
+        marginal[i] = t.missRate / usageMB;
+        marginalSum += marginal[i];
+        ++active;
+    }
+    if (active > 0) {
+        float mean = marginalSum / static_cast<float>(active);
+        for (size_t i = 0; i < kTierCount; ++i) {
+            if (marginal[i] < 0.0f || !kLimits[i].rebalance) continue;
+            float factor = marginal[i] > mean ? 1.1f : 0.97f;
+            tiers_[i].share = std::clamp(tiers_[i].share * factor, 1.0f, 4096.0f);
+        }
+    }
+
+    // Shed in MemoryTier order: those tiers sit at their floor
+    size_t shedCount = 0;
+    if (pressure == MemoryPressure::Critical) {
+        shedCount = kTierCount;
+    } else if (pressure == MemoryPressure::Elevated) {
+        shedCount = kElevatedShedTiers;
+        processBudget = processBudget / 4 * 3;
+    }
+
+    std::array<size_t, kTierCount> budget{};
+    std::array<bool, kTierCount> open{};
+    size_t slack = processBudget;
+    for (size_t i = 0; i < kTierCount; ++i) {
+        budget[i] = kLimits[i].minBytes;
+        slack -= std::min(slack, budget[i]);
+        open[i] = i >= shedCount;
+    }
+
+    // Split the slack by share; tiers that hit their ceiling return the excess
+    for (int pass = 0; pass < 3 && slack > 0; ++pass) {
+        float shareSum = 0.0f;
+        for (size_t i = 0; i < kTierCount; ++i) {
+            if (open[i]) shareSum += tiers_[i].share;
+        }
+        if (shareSum <= 0.0f) break;
+
+        size_t handedOut = 0;
+        for (size_t i = 0; i < kTierCount; ++i) {
+            if (!open[i]) continue;
+            size_t grant = static_cast<size_t>(static_cast<double>(slack) * (tiers_[i].share / shareSum));
+            size_t room = kLimits[i].maxBytes - budget[i];
+            if (grant >= room) {
+                grant = room;
+                open[i] = false;
+            }
+            budget[i] += grant;
+            handedOut += grant;
+        }
+        slack -= std::min(slack, handedOut);
+    }
+
+    for (size_t i = 0; i < kTierCount; ++i) {
+        tiers_[i].budget.store(budget[i], std::memory_order_relaxed);
+    }
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,182 @@
+#include "core/PipelineTrace.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+
+namespace UltraImageViewer {
+namespace Core {
+
+// Stage i is the time spent reaching TraceEvent i; slot 0 (Requested) holds
+// the end-to-end total instead.
+static const char* kStageNames[kTraceEventCount] = {
+    "total", "lane wait", "tier2", "tier3", "decode", "finish", "ready queue", "upload"
+};
+
+PipelineTrace::PipelineTrace()
+    : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+void PipelineTrace::SetEnabled(bool enabled, uint32_t sampleEvery)
+{
+    sampleEvery_.store(sampleEvery, std::memory_order_relaxed);
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+TraceTimeline PipelineTrace::Begin(uint8_t level)
+{
+    TraceTimeline timeline;
+    if (!enabled_.load(std::memory_order_relaxed)) return timeline;
+
+    timeline.id = nextId_.fetch_add(1, std::memory_order_relaxed);
+    timeline.level = level;
+    timeline.ns[static_cast<size_t>(TraceEvent::Requested)] = NowNs();
+    return timeline;
+}
+
+void PipelineTrace::Record(size_t stage, int64_t ns)
+{
+    uint64_t us = static_cast<uint64_t>(std::max<int64_t>(0, ns) / 1000);
+    size_t bucket = std::min<size_t>(std::bit_width(us), kBuckets - 1);
+    auto& h = stages_[stage];
+    h.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.totalUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void PipelineTrace::Finish(const TraceTimeline& timeline, const std::filesystem::path& path, bool completed)
+{
+    if (!timeline) return;
+
+    if (completed) {
+        int64_t previous = timeline.ns[0];
+        for (size_t i = 1; i < kTraceEventCount; ++i) {
+            if (timeline.ns[i] == 0) continue;
+            Record(i, timeline.ns[i] - previous);
+            previous = timeline.ns[i];
+        }
+        Record(0, previous - timeline.ns[0]);
+    } else {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t every = sampleEvery_.load(std::memory_order_relaxed);
+    if (every == 0 || timeline.id % every != 0) return;
+
+    std::lock_guard lock(sampleMutex_);
+    Sample sample{timeline, path, completed};
+    if (samples_.size() < kMaxSamples) {
+        samples_.push_back(std::move(sample));
+    } else {
+        samples_[sampleNext_] = std::move(sample);
+        sampleNext_ = (sampleNext_ + 1) % kMaxSamples;
+    }
+}
+
+std::string PipelineTrace::FormatHistograms() const
+{
+    std::string out = "stage          count    mean ms   p50 ms   p95 ms   p99 ms\n";
+    char line[160];
+    for (size_t stage = 0; stage < kStageCount; ++stage) {
+        const auto& h = stages_[stage];
+        uint64_t count = h.count.load(std::memory_order_relaxed);
+        if (count == 0) continue;
+
+        // Bucket upper bound (2^b us) at each percentile
+        double pct[3] = {};
+        const double targets[3] = {0.50, 0.95, 0.99};
+        for (int p = 0; p < 3; ++p) {
+            uint64_t want = static_cast<uint64_t>(targets[p] * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < kBuckets; ++b) {
+                seen += h.buckets[b].load(std::memory_order_relaxed);
+                if (seen >= want) {
+                    pct[p] = static_cast<double>(1ULL << b) / 1000.0;
+                    break;
+                }
+            }
+        }
+        double meanMs = static_cast<double>(h.totalUs.load(std::memory_order_relaxed)) / count / 1000.0;
+        std::snprintf(line, sizeof(line), "%-12s %8llu %10.2f %8.2f %8.2f %8.2f\n",
+                      kStageNames[stage], static_cast<unsigned long long>(count),
+                      meanMs, pct[0], pct[1], pct[2]);
+        out += line;
+    }
+    out += "dropped: " + std::to_string(dropped_.load(std::memory_order_relaxed)) + "\n";
+    return out;
+}
+
+static void AppendJsonString(std::string& out, const std::string& text)
+{
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+bool PipelineTrace::ExportTimelines(const std::filesystem::path& jsonPath) const
+{
+    std::vector<Sample> samples;
+    {
+        std::lock_guard lock(sampleMutex_);
+        samples = samples_;
+    }
+
+    // One track (tid) per request, one complete ("X") event per stage
+    std::string json = "{\"traceEvents\":[\n";
+    bool first = true;
+    char buf[192];
+    for (const auto& sample : samples) {
+        const auto& tl = sample.timeline;
+        auto u8 = sample.path.filename().u8string();
+        std::string name(u8.begin(), u8.end());
+
+        int64_t previous = tl.ns[0];
+        for (size_t i = 1; i < kTraceEventCount; ++i) {
+            if (tl.ns[i] == 0) continue;
+            std::snprintf(buf, sizeof(buf),
+                "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"%s\",\"args\":{\"level\":%d,\"file\":",
+                first ? "" : ",\n", static_cast<unsigned long long>(tl.id),
+                previous / 1000.0, (tl.ns[i] - previous) / 1000.0, kStageNames[i], tl.level);
+            json += buf;
+            AppendJsonString(json, name);
+            json += sample.completed ? "}}" : ",\"dropped\":true}}";
+            first = false;
+            previous = tl.ns[i];
+        }
+    }
+    json += "\n]}\n";
+
+    std::ofstream file(jsonPath, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
+}
+
+void PipelineTrace::Reset()
+{
+    for (auto& h : stages_) {
+        for (auto& b : h.buckets) b.store(0, std::memory_order_relaxed);
+        h.count.store(0, std::memory_order_relaxed);
+        h.totalUs.store(0, std::memory_order_relaxed);
+    }
+    dropped_.store(0, std::memory_order_relaxed);
+
+    std::lock_guard lock(sampleMutex_);
+    samples_.clear();
+    sampleNext_ = 0;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,561 @@
+#include "core/PixelConvert.hpp"
+#include "core/SimdUtils.hpp"
+#include <intrin.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace UltraImageViewer {
+namespace Core {
+namespace Simd {
+
+// ---- Scalar reference: the SIMD kernels below must match it bit for bit ----
+
+// (c * a + 127) / 255 without a divide; exact for all 8-bit c, a
+static inline uint8_t MulDiv255(uint32_t c, uint32_t a)
+{
+    uint32_t t = c * a + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+static void Convert_Scalar(PixelLayout layout, const uint8_t* src, uint8_t* dst, size_t count)
+{
+    switch (layout) {
+    case PixelLayout::BGR24:
+    case PixelLayout::RGB24: {
+        const int r = layout == PixelLayout::RGB24 ? 0 : 2;
+        for (size_t i = 0; i < count; ++i, src += 3, dst += 4) {
+            dst[0] = src[2 - r];
+            dst[1] = src[1];
+            dst[2] = src[r];
+            dst[3] = 255;
+        }
+        break;
+    }
+    case PixelLayout::BGRA32:
+    case PixelLayout::RGBA32: {
+        const int r = layout == PixelLayout::RGBA32 ? 0 : 2;
+        for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+            const uint8_t a = src[3];
+            dst[0] = MulDiv255(src[2 - r], a);
+            dst[1] = MulDiv255(src[1], a);
+            dst[2] = MulDiv255(src[r], a);
+            dst[3] = a;
+        }
+        break;
+    }
+    case PixelLayout::BGRX32:
+        for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+        }
+        break;
+    case PixelLayout::PBGRA32:
+        if (count) memcpy(dst, src, count * 4);
+        break;
+    case PixelLayout::Gray8:
+        for (size_t i = 0; i < count; ++i, dst += 4) {
+            dst[0] = dst[1] = dst[2] = src[i];
+            dst[3] = 255;
+        }
+        break;
+    case PixelLayout::CMYK32:
+        for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+            const uint32_t k = 255 - src[3];
+            dst[0] = MulDiv255(255 - src[2], k);
+            dst[1] = MulDiv255(255 - src[1], k);
+            dst[2] = MulDiv255(255 - src[0], k);
+            dst[3] = 255;
+        }
+        break;
+    default:
+        break;  // 16-bit layouts are narrowed first (ConvertToPBGRA)
+    }
+}
+
+static void Narrow_Scalar(const uint16_t* src, uint8_t* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<uint8_t>((static_cast<uint32_t>(src[i]) + 128) / 257);
+    }
+}
+
+// Tone mapping: every tier computes table indices the same way, then shares
+// the table lookup and premultiply below
+static constexpr int kToneSteps = 16384;        // linear -> sRGB table resolution
+static constexpr float kToneMaxLinear = 65504;  // half-float max: keeps inf out of the curves
+static constexpr float kToneMinAlpha = 1.0f / 512;
+
+static const uint8_t* ToneEncodeTable()
+{
+    static const auto table = [] {
+        std::array<uint8_t, kToneSteps + 1> t{};
+        for (int i = 0; i <= kToneSteps; ++i) {
+            double l = static_cast<double>(i) / kToneSteps;
+            double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            t[i] = static_cast<uint8_t>(std::lround(std::clamp(c, 0.0, 1.0) * 255.0));
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+static inline float ToneCurve(float x, ToneMapOperator op)
+{
+    if (op == ToneMapOperator::Reinhard) return x / (1.0f + x);
+    const float t = x * 0.6f;
+    return (t * (2.51f * t + 0.03f)) / (t * (2.43f * t + 0.59f) + 0.14f);
+}
+
+// n pixels from per-channel table indices and 8-bit alpha
+static inline void StoreToneMapped(const int32_t* r, const int32_t* g, const int32_t* b, const int32_t* a,
+                                   size_t n, uint8_t* dst)
+{
+    const uint8_t* encode = ToneEncodeTable();
+    for (size_t i = 0; i < n; ++i, dst += 4) {
+        const uint32_t alpha = static_cast<uint32_t>(a[i]);
+        if (alpha == 0) {
+            dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            continue;
+        }
+        dst[0] = MulDiv255(encode[b[i]], alpha);
+        dst[1] = MulDiv255(encode[g[i]], alpha);
+        dst[2] = MulDiv255(encode[r[i]], alpha);
+        dst[3] = static_cast<uint8_t>(alpha);
+    }
+}
+
+static void ToneMap_Scalar(const float* src, uint8_t* dst, size_t count, ToneMapOperator op, float exposure)
+{
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        const float alpha = std::min(std::max(src[3], 0.0f), 1.0f);
+        const float scale = (1.0f / std::max(alpha, kToneMinAlpha)) * exposure;
+        int32_t index[3];
+        for (int c = 0; c < 3; ++c) {
+            float x = src[c] * scale;
+            x = x > 0.0f ? std::min(x, kToneMaxLinear) : 0.0f;  // NaN -> 0
+            float y = std::min(std::max(ToneCurve(x, op), 0.0f), 1.0f);
+            index[c] = static_cast<int32_t>(y * kToneSteps + 0.5f);
+        }
+        int32_t a8 = static_cast<int32_t>(alpha * 255.0f + 0.5f);
+        StoreToneMapped(&index[0], &index[1], &index[2], &a8, 1, dst);
+    }
+}
+
+// ---- SSE2 path ----
+
+// Two pixels widened to 16-bit lanes: premultiply RGB by alpha, keep alpha
+// (its multiplier is 255, which MulDiv255 maps back to itself)
+static inline __m128i Premultiply_SSE2(__m128i px)
+{
+    const __m128i rgbMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alpha255 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, 0xFF), 0xFF);
+    a = _mm_or_si128(_mm_and_si128(a, rgbMask), alpha255);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(px, a), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+static inline __m128i SwapRB16_SSE2(__m128i px)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+static inline __m128i CmykToBgr16_SSE2(__m128i inv)
+{
+    __m128i k = _mm_shufflehi_epi16(_mm_shufflelo_epi16(inv, 0xFF), 0xFF);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(inv, k), _mm_set1_epi16(128));
+    return SwapRB16_SSE2(_mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8));
+}
+
+static size_t Convert_SSE2(PixelLayout layout, const uint8_t* src, uint8_t* dst, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    size_t i = 0;
+
+    switch (layout) {
+    case PixelLayout::BGR24:
+    case PixelLayout::RGB24: {
+        if (!HasSSE42()) return 0;  // SSSE3 shuffle below
+        const __m128i shuffle = layout == PixelLayout::BGR24
+            ? _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)
+            : _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+        // 16-byte loads use 12: stop while the 4-byte over-read stays in src
+        for (; i + 6 <= count; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            px = _mm_or_si128(_mm_shuffle_epi8(px, shuffle), opaque);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), px);
+        }
+        break;
+    }
+    case PixelLayout::BGRA32:
+    case PixelLayout::RGBA32: {
+        const bool swap = layout == PixelLayout::RGBA32;
+        for (; i + 4 <= count; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m128i lo = Premultiply_SSE2(_mm_unpacklo_epi8(px, zero));
+            __m128i hi = Premultiply_SSE2(_mm_unpackhi_epi8(px, zero));
+            if (swap) {
+                lo = SwapRB16_SSE2(lo);
+                hi = SwapRB16_SSE2(hi);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(lo, hi));
+        }
+        break;
+    }
+    case PixelLayout::BGRX32:
+        for (; i + 4 <= count; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(px, opaque));
+        }
+        break;
+    case PixelLayout::Gray8:
+        for (; i + 16 <= count; i += 16) {
+            __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i gg0 = _mm_unpacklo_epi8(g, g);
+            __m128i gg1 = _mm_unpackhi_epi8(g, g);
+            __m128i ga0 = _mm_unpacklo_epi8(g, _mm_cmpeq_epi8(g, g));
+            __m128i ga1 = _mm_unpackhi_epi8(g, _mm_cmpeq_epi8(g, g));
+            __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(gg0, ga0));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gg0, ga0));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(gg1, ga1));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(gg1, ga1));
+        }
+        break;
+    case PixelLayout::CMYK32: {
+        const __m128i ones = _mm_cmpeq_epi8(zero, zero);
+        for (; i + 4 <= count; i += 4) {
+            __m128i px = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)), ones);
+            __m128i lo = CmykToBgr16_SSE2(_mm_unpacklo_epi8(px, zero));
+            __m128i hi = CmykToBgr16_SSE2(_mm_unpackhi_epi8(px, zero));
+            __m128i out = _mm_or_si128(_mm_packus_epi16(lo, hi), opaque);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), out);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return i;
+}
+
+// round(v / 257) = floor((v + 128) / 257); saturating the add is harmless
+// (both sides are 255 there) and the divide is a multiply-high by 0xFF01
+static size_t Narrow_SSE2(const uint16_t* src, uint8_t* dst, size_t count)
+{
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i magic = _mm_set1_epi16(static_cast<short>(0xFF01));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        a = _mm_srli_epi16(_mm_mulhi_epu16(_mm_adds_epu16(a, bias), magic), 8);
+        b = _mm_srli_epi16(_mm_mulhi_epu16(_mm_adds_epu16(b, bias), magic), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+// Four pixels transposed to one register per channel
+static size_t ToneMap_SSE2(const float* src, uint8_t* dst, size_t count, ToneMapOperator op, float exposure)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 maxLinear = _mm_set1_ps(kToneMaxLinear);
+    const __m128 minAlpha = _mm_set1_ps(kToneMinAlpha);
+    const __m128 steps = _mm_set1_ps(static_cast<float>(kToneSteps));
+    const __m128 exposureV = _mm_set1_ps(exposure);
+    alignas(16) int32_t index[4][4];
+
+    auto curve = [&](__m128 x) {
+        if (op == ToneMapOperator::Reinhard) return _mm_div_ps(x, _mm_add_ps(one, x));
+        const __m128 t = _mm_mul_ps(x, _mm_set1_ps(0.6f));
+        const __m128 num = _mm_mul_ps(t, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.51f), t), _mm_set1_ps(0.03f)));
+        const __m128 den = _mm_add_ps(
+            _mm_mul_ps(t, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.43f), t), _mm_set1_ps(0.59f))), _mm_set1_ps(0.14f));
+        return _mm_div_ps(num, den);
+    };
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 r = _mm_loadu_ps(src + i * 4);
+        __m128 g = _mm_loadu_ps(src + i * 4 + 4);
+        __m128 b = _mm_loadu_ps(src + i * 4 + 8);
+        __m128 a = _mm_loadu_ps(src + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        a = _mm_min_ps(_mm_max_ps(a, zero), one);
+        const __m128 scale = _mm_mul_ps(_mm_div_ps(one, _mm_max_ps(a, minAlpha)), exposureV);
+        __m128 channels[3] = {r, g, b};
+        for (int c = 0; c < 3; ++c) {
+            __m128 x = _mm_min_ps(_mm_max_ps(_mm_mul_ps(channels[c], scale), zero), maxLinear);
+            __m128 y = _mm_min_ps(_mm_max_ps(curve(x), zero), one);
+            _mm_store_si128(reinterpret_cast<__m128i*>(index[c]),
+                            _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(y, steps), half)));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(index[3]),
+                        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(255.0f)), half)));
+        StoreToneMapped(index[0], index[1], index[2], index[3], 4, dst + i * 4);
+    }
+    return i;
+}
+
+// ---- AVX2 path: same arithmetic, 8 pixels per register ----
+
+static inline __m256i Premultiply_AVX2(__m256i px)
+{
+    const __m256i rgbMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alpha255 = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px, 0xFF), 0xFF);
+    a = _mm256_or_si256(_mm256_and_si256(a, rgbMask), alpha255);
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(px, a), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+static inline __m256i CmykToBgr16_AVX2(__m256i inv)
+{
+    __m256i k = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(inv, 0xFF), 0xFF);
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(inv, k), _mm256_set1_epi16(128));
+    t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+static size_t Convert_AVX2(PixelLayout layout, const uint8_t* src, uint8_t* dst, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    size_t i = 0;
+
+    switch (layout) {
+    case PixelLayout::BGR24:
+    case PixelLayout::RGB24: {
+        // Dwords 0-2 (pixels 0-3) to the low lane, 3-5 (pixels 4-7) to the high
+        const __m256i spread = _mm256_setr_epi32(0, 1, 2, 2, 3, 4, 5, 5);
+        const __m256i shuffle = layout == PixelLayout::BGR24
+            ? _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                               0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)
+            : _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                               2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+        // 32-byte loads use 24: stop while the 8-byte over-read stays in src
+        for (; i + 11 <= count; i += 8) {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 3));
+            px = _mm256_permutevar8x32_epi32(px, spread);
+            px = _mm256_or_si256(_mm256_shuffle_epi8(px, shuffle), opaque);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), px);
+        }
+        break;
+    }
+    case PixelLayout::BGRA32:
+    case PixelLayout::RGBA32: {
+        const bool swap = layout == PixelLayout::RGBA32;
+        const __m256i swapRB = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        for (; i + 8 <= count; i += 8) {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            __m256i lo = Premultiply_AVX2(_mm256_unpacklo_epi8(px, zero));
+            __m256i hi = Premultiply_AVX2(_mm256_unpackhi_epi8(px, zero));
+            __m256i out = _mm256_packus_epi16(lo, hi);  // per-lane unpack/pack keeps pixel order
+            if (swap) out = _mm256_shuffle_epi8(out, swapRB);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), out);
+        }
+        break;
+    }
+    case PixelLayout::BGRX32:
+        for (; i + 8 <= count; i += 8) {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(px, opaque));
+        }
+        break;
+    case PixelLayout::Gray8: {
+        // Each shuffle expands 8 gray bytes (4 per lane) to 8 pixels
+        const __m256i expand = _mm256_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1,
+                                                4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1);
+        const __m256i next8 = _mm256_set1_epi8(8);
+        for (; i + 16 <= count; i += 16) {
+            __m256i g = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+            __m256i* out = reinterpret_cast<__m256i*>(dst + i * 4);
+            _mm256_storeu_si256(out + 0, _mm256_or_si256(_mm256_shuffle_epi8(g, expand), opaque));
+            _mm256_storeu_si256(out + 1, _mm256_or_si256(_mm256_shuffle_epi8(g, _mm256_add_epi8(expand, next8)), opaque));
+        }
+        break;
+    }
+    case PixelLayout::CMYK32: {
+        const __m256i ones = _mm256_cmpeq_epi8(zero, zero);
+        for (; i + 8 <= count; i += 8) {
+            __m256i px = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4)), ones);
+            __m256i lo = CmykToBgr16_AVX2(_mm256_unpacklo_epi8(px, zero));
+            __m256i hi = CmykToBgr16_AVX2(_mm256_unpackhi_epi8(px, zero));
+            __m256i out = _mm256_or_si256(_mm256_packus_epi16(lo, hi), opaque);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), out);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return i;
+}
+
+static size_t Narrow_AVX2(const uint16_t* src, uint8_t* dst, size_t count)
+{
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m256i magic = _mm256_set1_epi16(static_cast<short>(0xFF01));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        a = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_adds_epu16(a, bias), magic), 8);
+        b = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_adds_epu16(b, bias), magic), 8);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    return i;
+}
+
+// Eight pixels: pixels n and n + 4 share a register so the SSE2 transpose
+// runs per 128-bit lane and each channel comes out in pixel order
+static size_t ToneMap_AVX2(const float* src, uint8_t* dst, size_t count, ToneMapOperator op, float exposure)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 maxLinear = _mm256_set1_ps(kToneMaxLinear);
+    const __m256 minAlpha = _mm256_set1_ps(kToneMinAlpha);
+    const __m256 steps = _mm256_set1_ps(static_cast<float>(kToneSteps));
+    const __m256 exposureV = _mm256_set1_ps(exposure);
+    alignas(32) int32_t index[4][8];
+
+    auto curve = [&](__m256 x) {
+        if (op == ToneMapOperator::Reinhard) return _mm256_div_ps(x, _mm256_add_ps(one, x));
+        const __m256 t = _mm256_mul_ps(x, _mm256_set1_ps(0.6f));
+        const __m256 num = _mm256_mul_ps(
+            t, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.51f), t), _mm256_set1_ps(0.03f)));
+        const __m256 den = _mm256_add_ps(
+            _mm256_mul_ps(t, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.43f), t), _mm256_set1_ps(0.59f))),
+            _mm256_set1_ps(0.14f));
+        return _mm256_div_ps(num, den);
+    };
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float* p = src + i * 4;
+        __m256 m0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 16), 1);
+        __m256 m1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 20), 1);
+        __m256 m2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 24), 1);
+        __m256 m3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 12)), _mm_loadu_ps(p + 28), 1);
+        __m256 rg01 = _mm256_unpacklo_ps(m0, m1);
+        __m256 rg23 = _mm256_unpacklo_ps(m2, m3);
+        __m256 ba01 = _mm256_unpackhi_ps(m0, m1);
+        __m256 ba23 = _mm256_unpackhi_ps(m2, m3);
+        __m256 channels[3] = {
+            _mm256_shuffle_ps(rg01, rg23, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(rg01, rg23, _MM_SHUFFLE(3, 2, 3, 2)),
+            _mm256_shuffle_ps(ba01, ba23, _MM_SHUFFLE(1, 0, 1, 0)),
+        };
+        __m256 a = _mm256_shuffle_ps(ba01, ba23, _MM_SHUFFLE(3, 2, 3, 2));
+
+        a = _mm256_min_ps(_mm256_max_ps(a, zero), one);
+        const __m256 scale = _mm256_mul_ps(_mm256_div_ps(one, _mm256_max_ps(a, minAlpha)), exposureV);
+        for (int c = 0; c < 3; ++c) {
+            __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(channels[c], scale), zero), maxLinear);
+            __m256 y = _mm256_min_ps(_mm256_max_ps(curve(x), zero), one);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(index[c]),
+                               _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y, steps), half)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(index[3]),
+                           _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(a, _mm256_set1_ps(255.0f)), half)));
+        StoreToneMapped(index[0], index[1], index[2], index[3], 8, dst + i * 4);
+    }
+    return i;
+}
+
+// ---- Dispatch ----
+
+uint32_t BytesPerPixel(PixelLayout layout)
+{
+    switch (layout) {
+    case PixelLayout::BGR24:
+    case PixelLayout::RGB24:  return 3;
+    case PixelLayout::Gray8:  return 1;
+    case PixelLayout::RGB48:  return 6;
+    case PixelLayout::RGBA64: return 8;
+    case PixelLayout::Gray16: return 2;
+    default:                  return 4;
+    }
+}
+
+SimdLevel MaxSimdLevel()
+{
+    return HasAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;  // SSE2 is baseline on x64
+}
+
+void Narrow16To8(const uint16_t* src, uint8_t* dst, size_t count, SimdLevel level)
+{
+    level = std::min(level, MaxSimdLevel());
+    size_t done = 0;
+    if (level == SimdLevel::AVX2) {
+        done = Narrow_AVX2(src, dst, count);
+    } else if (level == SimdLevel::SSE2) {
+        done = Narrow_SSE2(src, dst, count);
+    }
+    Narrow_Scalar(src + done, dst + done, count - done);
+}
+
+void ToneMapToPBGRA(const float* src, uint8_t* dst, size_t count, ToneMapOperator op, float exposure,
+                    SimdLevel level)
+{
+    level = std::min(level, MaxSimdLevel());
+    size_t done = 0;
+    if (level == SimdLevel::AVX2) {
+        done = ToneMap_AVX2(src, dst, count, op, exposure);
+    } else if (level == SimdLevel::SSE2) {
+        done = ToneMap_SSE2(src, dst, count, op, exposure);
+    }
+    ToneMap_Scalar(src + done * 4, dst + done * 4, count - done, op, exposure);
+}
+
+void ConvertToPBGRA(PixelLayout layout, const uint8_t* src, uint8_t* dst, size_t count, SimdLevel level)
+{
+    level = std::min(level, MaxSimdLevel());
+
+    // 16-bit layouts: narrow a chunk to the matching 8-bit layout on the
+    // stack, then run that layout's kernel
+    PixelLayout narrowed;
+    switch (layout) {
+    case PixelLayout::RGB48:  narrowed = PixelLayout::RGB24;  break;
+    case PixelLayout::RGBA64: narrowed = PixelLayout::RGBA32; break;
+    case PixelLayout::Gray16: narrowed = PixelLayout::Gray8;  break;
+    default:                  narrowed = layout;              break;
+    }
+    if (narrowed != layout) {
+        constexpr size_t kChunkPixels = 1024;
+        const uint32_t channels = BytesPerPixel(narrowed);
+        alignas(32) uint8_t chunk[kChunkPixels * 4];
+        for (size_t i = 0; i < count; i += kChunkPixels) {
+            const size_t n = std::min(kChunkPixels, count - i);
+            Narrow16To8(reinterpret_cast<const uint16_t*>(src) + i * channels, chunk, n * channels, level);
+            ConvertToPBGRA(narrowed, chunk, dst + i * 4, n, level);
+        }
+        return;
+    }
+
+    size_t done = 0;
+    if (level == SimdLevel::AVX2) {
+        done = Convert_AVX2(layout, src, dst, count);
+    } else if (level == SimdLevel::SSE2) {
+        done = Convert_SSE2(layout, src, dst, count);
+    }
+    const uint32_t bpp = BytesPerPixel(layout);
+    Convert_Scalar(layout, src + done * bpp, dst + done * 4, count - done);
+}
+
+} // namespace Simd
+} // namespace Core
+} // namespace UltraImageViewer
@@ -0,0 +1,352 @@
+#include "core/RasterCodecs.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+constexpr uint64_t kMaxPixels = 1ull << 28;
+
+inline uint16_t ReadLE16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t ReadLE32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint8_t Premultiply(uint8_t c, uint8_t a) { return static_cast<uint8_t>((c * a + 127) / 255); }
+
+bool AllocateImage(CodecImage& out, uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0 || static_cast<uint64_t>(width) * height > kMaxPixels) return false;
+    out.pixels = std::make_unique<uint8_t[]>(static_cast<size_t>(width) * height * 4);
+    out.width = out.sourceWidth = width;
+    out.height = out.sourceHeight = height;
+    return true;
+}
+
+// ---- BMP ----
+
+struct BmpHeader {
+    uint32_t pixelOffset = 0;
+    uint32_t headerSize = 0;
+    int32_t width = 0;
+    int32_t height = 0;          // negative = top-down
+    uint16_t bpp = 0;
+    uint32_t compression = 0;
+    uint32_t colorsUsed = 0;
+    uint32_t masks[4] = {};      // R, G, B, A
+};
+
+constexpr uint32_t kBiRgb = 0;
+constexpr uint32_t kBiBitfields = 3;
+constexpr uint32_t kBiAlphaBitfields = 6;
+
+bool ParseBmpHeader(const uint8_t* data, size_t size, BmpHeader& h)
+{
+    if (size < 54 || data[0] != 'B' || data[1] != 'M') return false;
+    h.pixelOffset = ReadLE32(data + 10);
+    h.headerSize = ReadLE32(data + 14);
+    if (h.headerSize < 40 || 14 + static_cast<size_t>(h.headerSize) > size) return false;  // OS/2 core header: WIC
+    h.width = static_cast<int32_t>(ReadLE32(data + 18));
+    h.height = static_cast<int32_t>(ReadLE32(data + 22));
+    h.bpp = ReadLE16(data + 28);
+    h.compression = ReadLE32(data + 30);
+    h.colorsUsed = ReadLE32(data + 46);
+    if (h.width <= 0 || h.height == 0 || h.height == INT32_MIN) return false;
+
+    if (h.compression == kBiBitfields || h.compression == kBiAlphaBitfields) {
+        // Masks follow the 40-byte header (inside it for V4/V5)
+        size_t count = (h.compression == kBiAlphaBitfields || h.headerSize >= 56) ? 4 : 3;
+        if (54 + count * 4 > size) return false;
+        for (size_t i = 0; i < count; ++i) h.masks[i] = ReadLE32(data + 54 + i * 4);
+    } else if (h.compression == kBiRgb && h.bpp == 16) {
+        h.masks[0] = 0x7C00; h.masks[1] = 0x03E0; h.masks[2] = 0x001F;
+    } else if (h.compression != kBiRgb) {
+        return false;  // RLE, JPEG, PNG
+    }
+    return true;
+}
+
+// Extracts one channel through a BITFIELDS mask, scaled to 8 bits
+struct MaskChannel {
+    uint32_t mask = 0;
+    int shift = 0;
+    uint32_t max = 0;
+
+    explicit MaskChannel(uint32_t m) : mask(m)
+    {
+        if (!mask) return;
+        while (!((mask >> shift) & 1)) ++shift;
+        max = mask >> shift;
+    }
+    uint8_t operator()(uint32_t v) const
+    {
+        if (!mask) return 0;
+        return static_cast<uint8_t>((((v & mask) >> shift) * 255 + max / 2) / max);
+    }
+};
+
+// ---- TIFF ----
+
+class TiffReader {
+public:
+    TiffReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool Open()
+    {
+        if (size_ < 8) return false;
+        if (data_[0] == 'I' && data_[1] == 'I') bigEndian_ = false;
+        else if (data_[0] == 'M' && data_[1] == 'M') bigEndian_ = true;
+        else return false;
+        if (U16(2) != 42) return false;
+        ifd_ = U32(4);
+        if (ifd_ < 8 || ifd_ + 2 > size_) return false;
+        entries_ = U16(ifd_);
+        return ifd_ + 2 + static_cast<size_t>(entries_) * 12 <= size_;
+    }
+
+    // Value i of a SHORT/LONG/BYTE tag, or fallback when absent
+    uint32_t Tag(uint16_t tag, uint32_t fallback, uint32_t index = 0) const
+    {
+        size_t entry = FindEntry(tag);
+        if (!entry) return fallback;
+        uint16_t type = U16(entry + 2);
+        uint32_t count = U32(entry + 4);
+        if (index >= count) return fallback;
+        size_t width = type == 3 ? 2 : (type == 4 ? 4 : (type == 1 ? 1 : 0));
+        if (!width) return fallback;
+        size_t offset = (count * width <= 4) ? entry + 8 : U32(entry + 8);
+        offset += index * width;
+        if (offset + width > size_) return fallback;
+        return width == 1 ? data_[offset] : (width == 2 ? U16(offset) : U32(offset));
+    }
+
+    uint32_t Count(uint16_t tag) const
+    {
+        size_t entry = FindEntry(tag);
+        return entry ? U32(entry + 4) : 0;
+    }
+
+private:
+    size_t FindEntry(uint16_t tag) const
+    {
+        for (uint16_t i = 0; i < entries_; ++i) {
+            size_t entry = ifd_ + 2 + static_cast<size_t>(i) * 12;
+            if (U16(entry) == tag) return entry;
+        }
+        return 0;
+    }
+
+    uint16_t U16(size_t at) const
+    {
+        const uint8_t* p = data_ + at;
+        return bigEndian_ ? static_cast<uint16_t>((p[0] << 8) | p[1]) : ReadLE16(p);
+    }
+    uint32_t U32(size_t at) const
+    {
+        const uint8_t* p = data_ + at;
+        return bigEndian_ ? (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                                (static_cast<uint32_t>(p[2]) << 8) | p[3]
+                          : ReadLE32(p);
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    bool bigEndian_ = false;
+    size_t ifd_ = 0;
+    uint16_t entries_ = 0;
+};
+
+constexpr uint16_t kTagWidth = 256;
+constexpr uint16_t kTagHeight = 257;
+constexpr uint16_t kTagBitsPerSample = 258;
+constexpr uint16_t kTagCompression = 259;
+constexpr uint16_t kTagPhotometric = 262;
+constexpr uint16_t kTagStripOffsets = 273;
+constexpr uint16_t kTagSamplesPerPixel = 277;
+constexpr uint16_t kTagRowsPerStrip = 278;
+constexpr uint16_t kTagStripByteCounts = 279;
+constexpr uint16_t kTagPlanarConfig = 284;
+constexpr uint16_t kTagPredictor = 317;
+constexpr uint16_t kTagTileWidth = 322;
+constexpr uint16_t kTagExtraSamples = 338;
+constexpr uint16_t kTagSampleFormat = 339;
+
+} // namespace
+
+bool BmpCodec::Matches(const uint8_t* data, size_t size) const
+{
+    return size >= 2 && data[0] == 'B' && data[1] == 'M';
+}
+
+bool BmpCodec::ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const
+{
+    BmpHeader h;
+    if (!ParseBmpHeader(data, size, h)) return false;
+    width = static_cast<uint32_t>(h.width);
+    height = static_cast<uint32_t>(h.height < 0 ? -h.height : h.height);
+    return true;
+}
+
+bool BmpCodec::Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const
+{
+    (void)maxDimension;
+    BmpHeader h;
+    if (!ParseBmpHeader(data, size, h)) return false;
+
+    const uint32_t width = static_cast<uint32_t>(h.width);
+    const uint32_t height = static_cast<uint32_t>(h.height < 0 ? -h.height : h.height);
+    const bool topDown = h.height < 0;
+    const size_t stride = ((static_cast<size_t>(width) * h.bpp + 31) / 32) * 4;
+    if (h.pixelOffset > size || stride * height > size - h.pixelOffset) return false;
+
+    uint32_t palette[256] = {};
+    if (h.bpp <= 8) {
+        if (h.bpp != 1 && h.bpp != 4 && h.bpp != 8) return false;
+        size_t count = h.colorsUsed ? std::min<uint32_t>(h.colorsUsed, 1u << h.bpp) : (1u << h.bpp);
+        size_t at = 14 + h.headerSize;
+        if (at + count * 4 > size) return false;
+        for (size_t i = 0; i < count; ++i) {
+            palette[i] = ReadLE32(data + at + i * 4) | 0xFF000000u;
+        }
+    } else if (h.bpp != 16 && h.bpp != 24 && h.bpp != 32) {
+        return false;
+    }
+    if (h.bpp == 16 && !h.masks[0] && !h.masks[1] && !h.masks[2]) return false;
+
+    if (!AllocateImage(out, width, height)) return false;
+
+    const MaskChannel r(h.masks[0]), g(h.masks[1]), b(h.masks[2]), a(h.masks[3]);
+    const bool masked = h.compression != kBiRgb || h.bpp == 16;
+    const bool hasAlpha = masked && h.masks[3] != 0;
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* src = data + h.pixelOffset + stride * (topDown ? y : height - 1 - y);
+        uint32_t* dst = reinterpret_cast<uint32_t*>(out.pixels.get() + static_cast<size_t>(y) * width * 4);
+
+        switch (h.bpp) {
+        case 1: case 4: case 8: {
+            const int perByte = 8 / h.bpp;
+            const uint32_t mask = (1u << h.bpp) - 1;
+            for (uint32_t x = 0; x < width; ++x) {
+                int shift = 8 - h.bpp * (1 + static_cast<int>(x % perByte));
+                dst[x] = palette[(src[x / perByte] >> shift) & mask];
+            }
+            break;
+        }
+        case 24:
+            for (uint32_t x = 0; x < width; ++x) {
+                dst[x] = 0xFF000000u | src[x * 3] | (src[x * 3 + 1] << 8) | (src[x * 3 + 2] << 16);
+            }
+            break;
+        default:
+            for (uint32_t x = 0; x < width; ++x) {
+                uint32_t v = h.bpp == 16 ? ReadLE16(src + x * 2) : ReadLE32(src + x * 4);
+                if (!masked) {
+                    dst[x] = v | 0xFF000000u;  // BI_RGB 32-bit: the fourth byte is padding
+                    continue;
+                }
+                uint8_t alpha = hasAlpha ? a(v) : 255;
+                uint8_t* px = reinterpret_cast<uint8_t*>(dst + x);
+                px[0] = Premultiply(b(v), alpha);
+                px[1] = Premultiply(g(v), alpha);
+                px[2] = Premultiply(r(v), alpha);
+                px[3] = alpha;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool TiffCodec::Matches(const uint8_t* data, size_t size) const
+{
+    return size >= 4 && ((data[0] == 'I' && data[1] == 'I' && data[2] == 42 && data[3] == 0) ||
+                         (data[0] == 'M' && data[1] == 'M' && data[2] == 0 && data[3] == 42));
+}
+
+bool TiffCodec::ReadSize(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) const
+{
+    TiffReader tiff(data, size);
+    if (!tiff.Open()) return false;
+    width = tiff.Tag(kTagWidth, 0);
+    height = tiff.Tag(kTagHeight, 0);
+    return width && height;
+}
+
+bool TiffCodec::Decode(const uint8_t* data, size_t size, uint32_t maxDimension, CodecImage& out) const
+{
+    (void)maxDimension;
+    TiffReader tiff(data, size);
+    if (!tiff.Open()) return false;
+
+    const uint32_t width = tiff.Tag(kTagWidth, 0);
+    const uint32_t height = tiff.Tag(kTagHeight, 0);
+    const uint32_t samples = tiff.Tag(kTagSamplesPerPixel, 1);
+    const uint32_t photometric = tiff.Tag(kTagPhotometric, 1);
+    const uint32_t extraSamples = tiff.Count(kTagExtraSamples);
+
+    if (tiff.Tag(kTagCompression, 1) != 1 || tiff.Tag(kTagPredictor, 1) != 1 ||
+        tiff.Tag(kTagPlanarConfig, 1) != 1 || tiff.Tag(kTagSampleFormat, 1) != 1 ||
+        tiff.Count(kTagTileWidth) != 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < samples; ++i) {
+        if (tiff.Tag(kTagBitsPerSample, 1, i) != 8) return false;
+    }
+
+    const bool gray = (photometric == 0 || photometric == 1);
+    const uint32_t colorSamples = gray ? 1 : 3;
+    if (!gray && photometric != 2) return false;  // palette, CMYK, YCbCr, Lab: WIC
+    if (samples < colorSamples || samples > colorSamples + 1) return false;
+
+    // ExtraSamples: 1 = associated (premultiplied) alpha, 2 = unassociated
+    const bool hasAlpha = samples == colorSamples + 1 && extraSamples > 0 && tiff.Tag(kTagExtraSamples, 0) != 0;
+    const bool premultiplied = hasAlpha && tiff.Tag(kTagExtraSamples, 0) == 1;
+
+    const uint32_t strips = tiff.Count(kTagStripOffsets);
+    if (strips == 0 || tiff.Count(kTagStripByteCounts) != strips) return false;
+    if (!AllocateImage(out, width, height)) return false;
+
+    const uint32_t rowsPerStrip = std::max(1u, std::min(tiff.Tag(kTagRowsPerStrip, height), height));
+    const size_t rowBytes = static_cast<size_t>(width) * samples;
+
+    for (uint32_t y = 0; y < height; ++y) {
+        uint32_t strip = y / rowsPerStrip;
+        if (strip >= strips) return false;
+        size_t offset = tiff.Tag(kTagStripOffsets, 0, strip);
+        size_t bytes = tiff.Tag(kTagStripByteCounts, 0, strip);
+        size_t rowOffset = static_cast<size_t>(y % rowsPerStrip) * rowBytes;
+        if (rowOffset + rowBytes > bytes || offset > size || offset + rowOffset + rowBytes > size) {
+            return false;
+        }
+
+        const uint8_t* src = data + offset + rowOffset;
+        uint8_t* dst = out.pixels.get() + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; ++x, src += samples, dst += 4) {
+            uint8_t alpha = hasAlpha ? src[colorSamples] : 255;
+            uint8_t cr, cg, cb;
+            if (gray) {
+                cr = cg = cb = photometric == 0 ? static_cast<uint8_t>(255 - src[0]) : src[0];
+            } else {
+                cr = src[0]; cg = src[1]; cb = src[2];
+            }
+            if (hasAlpha && !premultiplied) {
+                cr = Premultiply(cr, alpha);
+                cg = Premultiply(cg, alpha);
+                cb = Premultiply(cb, alpha);
+            }
+            dst[0] = cb;
+            dst[1] = cg;
+            dst[2] = cr;
+            dst[3] = alpha;
+        }
+    }
+    return true;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
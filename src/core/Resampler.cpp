@@ -0,0 +1,316 @@
+#include "core/Resampler.hpp"
+#include "core/ThreadPool.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace UltraImageViewer {
+namespace Core {
+
+namespace {
+
+constexpr double kLanczosRadius = 3.0;
+constexpr double kAreaAbove = 3.0;      // Auto: reductions beyond this use area weights
+constexpr uint32_t kBandRows = 64;      // output rows per work item
+constexpr int kEncodeSteps = 16384;     // linear -> sRGB table resolution (exact round trip)
+constexpr uint64_t kParallelSourcePixels = 4u << 20;
+
+struct GammaTables {
+    float toLinear[256];
+    uint8_t toSrgb[kEncodeSteps + 1];
+};
+
+const GammaTables& Gamma()
+{
+    static const GammaTables tables = [] {
+        GammaTables t{};
+        for (int i = 0; i < 256; ++i) {
+            double c = i / 255.0;
+            t.toLinear[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+        }
+        for (int i = 0; i <= kEncodeSteps; ++i) {
+            double l = static_cast<double>(i) / kEncodeSteps;
+            double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            t.toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(c, 0.0, 1.0) * 255.0));
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// Source taps for every destination index along one axis
+struct AxisTaps {
+    std::vector<uint32_t> first;   // first source index
+    std::vector<uint32_t> count;
+    std::vector<uint32_t> offset;  // into weights
+    std::vector<float> weights;    // sum to 1 per destination index
+};
+
+double Lanczos3(double x)
+{
+    x = std::abs(x);
+    if (x < 1e-9) return 1.0;
+    if (x >= kLanczosRadius) return 0.0;
+    const double px = 3.14159265358979323846 * x;
+    return kLanczosRadius * std::sin(px) * std::sin(px / kLanczosRadius) / (px * px);
+}
+
+AxisTaps BuildTaps(uint32_t srcSize, uint32_t dstSize, ResampleFilter filter)
+{
+    const double scale = static_cast<double>(srcSize) / dstSize;
+    if (filter == ResampleFilter::Auto) {
+        filter = scale > kAreaAbove ? ResampleFilter::Area : ResampleFilter::Lanczos3;
+    }
+    if (filter == ResampleFilter::Area && scale < 1.0) {
+        filter = ResampleFilter::Lanczos3;  // coverage weights only make sense when reducing
+    }
+
+    AxisTaps taps;
+    taps.first.reserve(dstSize);
+    taps.count.reserve(dstSize);
+    taps.offset.reserve(dstSize);
+
+    std::vector<double> w;
+    for (uint32_t d = 0; d < dstSize; ++d) {
+        int64_t s0, s1;
+        w.clear();
+        if (filter == ResampleFilter::Area) {
+            const double lo = d * scale, hi = (d + 1) * scale;
+            s0 = static_cast<int64_t>(std::floor(lo));
+            s1 = std::min<int64_t>(srcSize, static_cast<int64_t>(std::ceil(hi)));
+            for (int64_t s = s0; s < s1; ++s) {
+                w.push_back(std::min(hi, s + 1.0) - std::max(lo, static_cast<double>(s)));
+            }
+        } else {
+            // Stretched to the reduction so the kernel also low-passes
+            const double center = (d + 0.5) * scale;
+            const double stretch = std::max(scale, 1.0);
+            const double support = kLanczosRadius * stretch;
+            s0 = std::max<int64_t>(0, static_cast<int64_t>(std::floor(center - support)));
+            s1 = std::min<int64_t>(srcSize, static_cast<int64_t>(std::ceil(center + support)));
+            for (int64_t s = s0; s < s1; ++s) {
+                w.push_back(Lanczos3((s + 0.5 - center) / stretch));
+            }
+        }
+
+        // Drop taps that contribute nothing (kernel zeros, sub-ulp slivers)
+        size_t lead = 0, tail = w.size();
+        while (lead < tail && std::abs(w[lead]) < 1e-7) ++lead;
+        while (tail > lead && std::abs(w[tail - 1]) < 1e-7) --tail;
+
+        double sum = 0.0;
+        for (size_t k = lead; k < tail; ++k) sum += w[k];
+        taps.offset.push_back(static_cast<uint32_t>(taps.weights.size()));
+        if (tail == lead || std::abs(sum) < 1e-9) {
+            // Degenerate: nearest source sample
+            taps.first.push_back(std::min<uint32_t>(srcSize - 1, static_cast<uint32_t>((d + 0.5) * scale)));
+            taps.count.push_back(1);
+            taps.weights.push_back(1.0f);
+            continue;
+        }
+        taps.first.push_back(static_cast<uint32_t>(s0 + lead));
+        taps.count.push_back(static_cast<uint32_t>(tail - lead));
+        for (size_t k = lead; k < tail; ++k) {
+            taps.weights.push_back(static_cast<float>(w[k] / sum));
+        }
+    }
+    return taps;
+}
+
+// Premultiplied sRGB bytes -> premultiplied linear floats
+void LinearizeRow(const uint8_t* src, uint32_t width, float* out)
+{
+    const auto& g = Gamma();
+    for (uint32_t x = 0; x < width; ++x, src += 4, out += 4) {
+        const uint32_t a = src[3];
+        if (a == 255) {
+            out[0] = g.toLinear[src[0]];
+            out[1] = g.toLinear[src[1]];
+            out[2] = g.toLinear[src[2]];
+            out[3] = 1.0f;
+        } else if (a == 0) {
+            out[0] = out[1] = out[2] = out[3] = 0.0f;
+        } else {
+            const float alpha = a / 255.0f;
+            const float unpremultiply = 255.0f / a;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t straight = std::min(255u, static_cast<uint32_t>(src[c] * unpremultiply + 0.5f));
+                out[c] = g.toLinear[straight] * alpha;
+            }
+            out[3] = alpha;
+        }
+    }
+}
+
+void FilterRow(const float* row, const AxisTaps& taps, float* out)
+{
+    const size_t dstWidth = taps.first.size();
+    for (size_t d = 0; d < dstWidth; ++d) {
+        const float* px = row + static_cast<size_t>(taps.first[d]) * 4;
+        const float* w = taps.weights.data() + taps.offset[d];
+        __m128 sum = _mm_setzero_ps();
+        for (uint32_t k = 0; k < taps.count[d]; ++k) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(px + k * 4), _mm_set1_ps(w[k])));
+        }
+        _mm_storeu_ps(out + d * 4, sum);
+    }
+}
+
+// Premultiplied linear floats -> premultiplied sRGB bytes. Lanczos lobes can
+// overshoot: alpha is clamped to [0, 1] and colour to [0, alpha].
+void EncodeRow(const float* in, uint32_t width, uint8_t* dst)
+{
+    const auto& g = Gamma();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 steps = _mm_set1_ps(static_cast<float>(kEncodeSteps));
+    const __m128 half = _mm_set1_ps(0.5f);
+    alignas(16) int32_t index[4];
+
+    for (uint32_t x = 0; x < width; ++x, in += 4, dst += 4) {
+        const float alpha = std::clamp(in[3], 0.0f, 1.0f);
+        const uint32_t a8 = static_cast<uint32_t>(alpha * 255.0f + 0.5f);
+        if (a8 == 0) {
+            dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            continue;
+        }
+
+        __m128 straight = _mm_div_ps(_mm_loadu_ps(in), _mm_set1_ps(alpha));
+        straight = _mm_min_ps(_mm_max_ps(straight, zero), one);
+        _mm_store_si128(reinterpret_cast<__m128i*>(index),
+                        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(straight, steps), half)));
+
+        for (int c = 0; c < 3; ++c) {
+            uint32_t value = g.toSrgb[index[c]];
+            if (a8 < 255) {
+                uint32_t t = value * a8 + 128;
+                value = (t + (t >> 8)) >> 8;
+            }
+            dst[c] = static_cast<uint8_t>(value);
+        }
+        dst[3] = static_cast<uint8_t>(a8);
+    }
+}
+
+struct ResampleJob {
+    const uint8_t* src;
+    uint32_t srcWidth;
+    uint8_t* dst;
+    uint32_t dstWidth;
+    uint32_t dstHeight;
+    AxisTaps horizontal;
+    AxisTaps vertical;
+};
+
+// Per-worker scratch, reused across bands
+struct BandScratch {
+    std::vector<float> linear;  // one source row
+    std::vector<float> rows;    // horizontally filtered source rows of the band
+    std::vector<float> acc;     // one output row
+};
+
+void ResampleBand(const ResampleJob& job, uint32_t y0, uint32_t y1, BandScratch& scratch)
+{
+    const size_t rowFloats = static_cast<size_t>(job.dstWidth) * 4;
+    const auto& v = job.vertical;
+
+    const uint32_t s0 = v.first[y0];
+    uint32_t s1 = s0;
+    for (uint32_t y = y0; y < y1; ++y) {
+        s1 = std::max(s1, v.first[y] + v.count[y]);
+    }
+
+    scratch.rows.resize((s1 - s0) * rowFloats);
+    for (uint32_t s = s0; s < s1; ++s) {
+        LinearizeRow(job.src + static_cast<size_t>(s) * job.srcWidth * 4, job.srcWidth, scratch.linear.data());
+        FilterRow(scratch.linear.data(), job.horizontal, scratch.rows.data() + (s - s0) * rowFloats);
+    }
+
+    float* acc = scratch.acc.data();
+    for (uint32_t y = y0; y < y1; ++y) {
+        const float* w = v.weights.data() + v.offset[y];
+        const float* base = scratch.rows.data() + (v.first[y] - s0) * rowFloats;
+        for (size_t i = 0; i < rowFloats; i += 4) {
+            _mm_storeu_ps(acc + i, _mm_mul_ps(_mm_loadu_ps(base + i), _mm_set1_ps(w[0])));
+        }
+        for (uint32_t k = 1; k < v.count[y]; ++k) {
+            const float* row = base + k * rowFloats;
+            const __m128 wk = _mm_set1_ps(w[k]);
+            for (size_t i = 0; i < rowFloats; i += 4) {
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(row + i), wk)));
+            }
+        }
+        EncodeRow(acc, job.dstWidth, job.dst + static_cast<size_t>(y) * job.dstWidth * 4);
+    }
+}
+
+} // namespace
+
+void ResampleBGRA(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                  uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight,
+                  ResampleFilter filter, uint32_t threads)
+{
+    if (!src || !dst || srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) return;
+
+    ResampleJob job{src, srcWidth, dst, dstWidth, dstHeight,
+                    BuildTaps(srcWidth, dstWidth, filter), BuildTaps(srcHeight, dstHeight, filter)};
+
+    const uint32_t bands = (dstHeight + kBandRows - 1) / kBandRows;
+    if (threads == 0) {
+        const uint64_t sourcePixels = static_cast<uint64_t>(srcWidth) * srcHeight;
+        threads = sourcePixels >= kParallelSourcePixels
+            ? std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u) : 1u;
+    }
+    threads = std::min(threads, bands);
+
+    // Helpers share the calling task's pool and lane instead of starting
+    // threads of their own; outside a pool task the caller works alone.
+    ThreadPool* pool = ThreadPool::Current();
+    if (!pool) threads = 1;
+
+    // Bands are claimed from shared state that outlives the call: a helper
+    // that starts after the caller finished claims nothing and never
+    // touches the job.
+    struct BandShare {
+        std::atomic<uint32_t> next{0};
+        std::atomic<uint32_t> done{0};
+    };
+    auto share = std::make_shared<BandShare>();
+
+    auto worker = [share, bands, &job] {
+        BandScratch scratch;
+        for (;;) {
+            uint32_t band = share->next.fetch_add(1);
+            if (band >= bands) return;
+            if (scratch.acc.empty()) {
+                scratch.linear.resize(static_cast<size_t>(job.srcWidth) * 4);
+                scratch.acc.resize(static_cast<size_t>(job.dstWidth) * 4);
+            }
+            uint32_t y0 = band * kBandRows;
+            ResampleBand(job, y0, std::min(job.dstHeight, y0 + kBandRows), scratch);
+            share->done.fetch_add(1, std::memory_order_release);
+            share->done.notify_all();
+        }
+    };
+
+    if (threads > 1) {
+        const auto lane = static_cast<TaskPriority>(ThreadPool::CurrentLane());
+        std::vector<std::function<void()>> helpers(threads - 1, worker);
+        pool->SubmitBatch(helpers, lane);
+    }
+    worker();
+
+    // Wait for bands still running on helpers
+    uint32_t finished = share->done.load(std::memory_order_acquire);
+    while (finished < bands) {
+        share->done.wait(finished);
+        finished = share->done.load(std::memory_order_acquire);
+    }
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
@@ -1,6 +1,10 @@
 #include "core/SimdUtils.hpp"
 #include <intrin.h>
 #include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <array>
 
 namespace UltraImageViewer {
 namespace Core {
@@ -118,6 +122,150 @@ void ToLowerInPlace(wchar_t* data, size_t length)
     }
 }
 
+// ---- EXIF orientation ----
+
+static inline __m128i Reverse4(__m128i v)
+{
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// 2-4: every output row is one source row, mirrored and/or moved
+static void OrientRows(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height,
+                       bool mirror, bool flip, uint8_t* dst)
+{
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint32_t* in = reinterpret_cast<const uint32_t*>(src + y * srcStride);
+        uint32_t* out = reinterpret_cast<uint32_t*>(dst) + static_cast<size_t>(flip ? height - 1 - y : y) * width;
+        if (!mirror) {
+            memcpy(out, in, static_cast<size_t>(width) * 4);
+            continue;
+        }
+        uint32_t x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + width - 4 - x), Reverse4(v));
+        }
+        for (; x < width; ++x) {
+            out[width - 1 - x] = in[x];
+        }
+    }
+}
+
+// 5-8: output row r is source column x (r = x, or width-1-x with flipRows),
+// its pixels in source row order (reversed with flipCols)
+static void OrientTransposed(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height,
+                             bool flipRows, bool flipCols, uint8_t* dst)
+{
+    constexpr uint32_t kTile = 32;  // 4 KB of source and of output per tile
+    uint32_t* out = reinterpret_cast<uint32_t*>(dst);
+    auto target = [&](uint32_t x, uint32_t y) {
+        return static_cast<size_t>(flipRows ? width - 1 - x : x) * height + (flipCols ? height - 1 - y : y);
+    };
+    auto pixel = [&](uint32_t x, uint32_t y) {
+        uint32_t v;
+        memcpy(&v, src + y * srcStride + static_cast<size_t>(x) * 4, 4);
+        return v;
+    };
+
+    for (uint32_t ty = 0; ty < height; ty += kTile) {
+        const uint32_t yEnd = std::min(height, ty + kTile);
+        for (uint32_t tx = 0; tx < width; tx += kTile) {
+            const uint32_t xEnd = std::min(width, tx + kTile);
+            uint32_t y = ty;
+            for (; y + 4 <= yEnd; y += 4) {
+                const uint8_t* row = src + y * srcStride;
+                uint32_t x = tx;
+                for (; x + 4 <= xEnd; x += 4) {
+                    __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4));
+                    __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + srcStride + x * 4));
+                    __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * srcStride + x * 4));
+                    __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 3 * srcStride + x * 4));
+                    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+                    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+                    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+                    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+                    __m128i cols[4] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                                       _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+                    for (uint32_t k = 0; k < 4; ++k) {
+                        __m128i v = flipCols ? Reverse4(cols[k]) : cols[k];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + target(x + k, flipCols ? y + 3 : y)), v);
+                    }
+                }
+                for (; x < xEnd; ++x) {
+                    for (uint32_t k = 0; k < 4; ++k) out[target(x, y + k)] = pixel(x, y + k);
+                }
+            }
+            for (; y < yEnd; ++y) {
+                for (uint32_t x = tx; x < xEnd; ++x) out[target(x, y)] = pixel(x, y);
+            }
+        }
+    }
+}
+
+void OrientBGRA(const uint8_t* src, size_t srcStride, uint32_t width, uint32_t height,
+                uint16_t orientation, uint8_t* dst)
+{
+    if (!src || !dst || width == 0 || height == 0) return;
+
+    switch (orientation) {
+    case 2: OrientRows(src, srcStride, width, height, true, false, dst); break;        // mirror horizontal
+    case 3: OrientRows(src, srcStride, width, height, true, true, dst); break;         // rotate 180
+    case 4: OrientRows(src, srcStride, width, height, false, true, dst); break;        // mirror vertical
+    case 5: OrientTransposed(src, srcStride, width, height, false, false, dst); break;  // transpose
+    case 6: OrientTransposed(src, srcStride, width, height, false, true, dst); break;  // rotate 90 CW
+    case 7: OrientTransposed(src, srcStride, width, height, true, true, dst); break;   // transverse
+    case 8: OrientTransposed(src, srcStride, width, height, true, false, dst); break;  // rotate 90 CCW
+    default: OrientRows(src, srcStride, width, height, false, false, dst); break;
+    }
+}
+
+// ---- CRC-32C ----
+
+static uint32_t Crc32c_Table(const uint8_t* data, size_t length, uint32_t crc)
+{
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint32_t Crc32c_SSE42(const uint8_t* data, size_t length, uint32_t crc)
+{
+    uint64_t c = crc;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, 8);
+        c = _mm_crc32_u64(c, v);
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    for (; i < length; ++i) {
+        c32 = _mm_crc32_u8(c32, data[i]);
+    }
+    return c32;
+}
+
+uint32_t Crc32c(const uint8_t* data, size_t length, uint32_t crc)
+{
+    if (!data || length == 0) return crc;
+
+    crc = ~crc;
+    crc = s_hasSSE42 ? Crc32c_SSE42(data, length, crc) : Crc32c_Table(data, length, crc);
+    return ~crc;
+}
+
 } // namespace Simd
 } // namespace Core
 } // namespace UltraImageViewer
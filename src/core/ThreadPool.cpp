@@ -8,6 +8,7 @@ namespace UltraImageViewer {
 namespace Core {
 
 thread_local int ThreadPool::tl_currentLane_ = -1;
+thread_local ThreadPool* ThreadPool::tl_currentPool_ = nullptr;
 
 ThreadPool::ThreadPool(uint32_t numThreads)
 {
@@ -166,10 +167,12 @@ void ThreadPool::WorkerFunc(uint32_t /*index*/)
         bool changed = (prio != THREAD_PRIORITY_NORMAL);
         if (changed) SetThreadPriority(GetCurrentThread(), prio);
         tl_currentLane_ = task.lane;
+        tl_currentPool_ = this;
 
         try { task.fn(); } catch (...) { /* swallow — worker must not die */ }
 
         tl_currentLane_ = -1;
+        tl_currentPool_ = nullptr;
         if (changed) SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL);
 
         active_.fetch_sub(1, std::memory_order_acq_rel);
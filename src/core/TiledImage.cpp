@@ -0,0 +1,126 @@
+#include "core/TiledImage.hpp"
+#include "core/SimdUtils.hpp"
+#include <algorithm>
+
+namespace UltraImageViewer {
+namespace Core {
+
+TiledImageSource::TiledImageSource(Microsoft::WRL::ComPtr<IWICImagingFactory2> factory,
+                                   Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder,
+                                   Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame,
+                                   uint32_t width, uint32_t height, uint16_t orientation)
+    : factory_(std::move(factory))
+    , decoder_(std::move(decoder))
+    , frame_(std::move(frame))
+    , width_(width)
+    , height_(height)
+    , storedWidth_(width)
+    , storedHeight_(height)
+    , orientation_(orientation >= 2 && orientation <= 8 ? orientation : 1)
+    , levelCount_(LevelCountFor(width, height))
+{
+    if (orientation_ >= 5) {
+        std::swap(width_, height_);
+    }
+    levels_.resize(levelCount_);
+}
+
+void TiledImageSource::LevelSize(uint32_t width, uint32_t height, int level,
+                                 uint32_t& outWidth, uint32_t& outHeight)
+{
+    outWidth = std::max(1u, width >> level);
+    outHeight = std::max(1u, height >> level);
+}
+
+int TiledImageSource::LevelCountFor(uint32_t width, uint32_t height)
+{
+    // Stop at the first level that fits in a single tile
+    int count = 1;
+    uint32_t w = width;
+    uint32_t h = height;
+    while ((w > kTileSize || h > kTileSize) && count < 16) {
+        w = std::max(1u, w >> 1);
+        h = std::max(1u, h >> 1);
+        ++count;
+    }
+    return count;
+}
+
+IWICBitmapSource* TiledImageSource::LevelSource(int level)
+{
+    // Caller holds mutex_
+    if (levels_[level]) return levels_[level].Get();
+
+    Microsoft::WRL::ComPtr<IWICBitmapSource> input = frame_;
+    if (level > 0) {
+        uint32_t w, h;
+        LevelSize(storedWidth_, storedHeight_, level, w, h);
+        Microsoft::WRL::ComPtr<IWICBitmapScaler> scaler;
+        if (FAILED(factory_->CreateBitmapScaler(&scaler)) ||
+            FAILED(scaler->Initialize(frame_.Get(), w, h, WICBitmapInterpolationModeFant))) {
+            return nullptr;
+        }
+        input = scaler;
+    }
+
+    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+    if (FAILED(factory_->CreateFormatConverter(&converter)) ||
+        FAILED(converter->Initialize(input.Get(), GUID_WICPixelFormat32bppPBGRA,
+                                     WICBitmapDitherTypeNone, nullptr, 0.0,
+                                     WICBitmapPaletteTypeCustom))) {
+        return nullptr;
+    }
+    levels_[level] = converter;
+    return levels_[level].Get();
+}
+
+bool TiledImageSource::ReadTile(int level, uint32_t tileX, uint32_t tileY,
+                                std::unique_ptr<uint8_t[]>& outPixels,
+                                uint32_t& outWidth, uint32_t& outHeight)
+{
+    if (level < 0 || level >= levelCount_) return false;
+
+    uint32_t levelW, levelH;
+    LevelSize(width_, height_, level, levelW, levelH);
+    uint32_t x = tileX * kTileSize;
+    uint32_t y = tileY * kTileSize;
+    if (x >= levelW || y >= levelH) return false;
+
+    outWidth = std::min(kTileSize, levelW - x);
+    outHeight = std::min(kTileSize, levelH - y);
+    size_t bytes = static_cast<size_t>(outWidth) * outHeight * 4;
+    outPixels = std::make_unique<uint8_t[]>(bytes);
+
+    // Stored region that turns into this tile (levelW x levelH is upright)
+    const uint32_t w = outWidth, h = outHeight;
+    uint32_t sx = x, sy = y, sw = w, sh = h;
+    switch (orientation_) {
+    case 2: sx = levelW - x - w; break;
+    case 3: sx = levelW - x - w; sy = levelH - y - h; break;
+    case 4: sy = levelH - y - h; break;
+    case 5: sx = y; sy = x; sw = h; sh = w; break;
+    case 6: sx = y; sy = levelW - x - w; sw = h; sh = w; break;
+    case 7: sx = levelH - y - h; sy = levelW - x - w; sw = h; sh = w; break;
+    case 8: sx = levelH - y - h; sy = x; sw = h; sh = w; break;
+    default: break;
+    }
+
+    std::lock_guard lock(mutex_);
+    IWICBitmapSource* source = LevelSource(level);
+    if (!source) return false;
+
+    WICRect rect = {static_cast<INT>(sx), static_cast<INT>(sy), static_cast<INT>(sw), static_cast<INT>(sh)};
+    if (orientation_ == 1) {
+        return SUCCEEDED(source->CopyPixels(&rect, sw * 4, static_cast<UINT>(bytes), outPixels.get()));
+    }
+
+    auto stored = std::make_unique_for_overwrite<uint8_t[]>(bytes);
+    if (FAILED(source->CopyPixels(&rect, sw * 4, static_cast<UINT>(bytes), stored.get()))) {
+        return false;
+    }
+    Simd::OrientBGRA(stored.get(), static_cast<size_t>(sw) * 4, sw, sh, orientation_, outPixels.get());
+    return true;
+}
+
+} // namespace Core
+} // namespace UltraImageViewer
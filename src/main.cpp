@@ -3,12 +3,75 @@
 #include <string>
 #include <memory>
 #include <filesystem>
+#include <cstdio>
 
 #include "core/Application.hpp"
 #include "core/ImagePipeline.hpp"
+#include "core/HeadlessBenchmark.hpp"
 
 using namespace Microsoft::WRL;
 
+namespace {
+
+namespace Core = UltraImageViewer::Core;
+
+// "<switch> [folder]": runs without a window, prints the report and exits.
+// run clears passed to make the process exit with 1.
+struct HeadlessCommand {
+    const wchar_t* name;
+    std::string (*run)(const std::filesystem::path& folder, bool& passed);
+};
+
+const HeadlessCommand kHeadlessCommands[] = {
+    // Scrolls a simulated gallery over folder with no window or GPU
+    {L"--bench-headless", [](const std::filesystem::path& folder, bool&) { return Core::RunHeadlessBenchmark(folder); }},
+    // Times the native codecs against WIC on every image in folder
+    {L"--bench-decode", [](const std::filesystem::path& folder, bool&) { return Core::RunDecodeBenchmark(folder); }},
+    // Feeds corrupted copies of the images in folder to the native codecs
+    {L"--fuzz-decode", [](const std::filesystem::path& folder, bool&) { return Core::RunCodecFuzz(folder); }},
+    // Thumbnails folder per file in request order and through the disk-ordered batch decoder
+    {L"--bench-batch", [](const std::filesystem::path& folder, bool&) { return Core::RunBatchBenchmark(folder); }},
+    // Floods ImageDecoder::DecodeAsync, cancels mid-flight and destroys the decoder with decodes queued
+    {L"--bench-async", [](const std::filesystem::path&, bool&) { return Core::RunAsyncStress(); }},
+    // Times the SIMD pixel-format kernels at each tier against the scalar reference
+    {L"--bench-convert", [](const std::filesystem::path&, bool&) { return Core::RunConvertBenchmark(); }},
+    // Compares the SIMD pixel-format kernels bit for bit against the reference
+    {L"--check-convert", [](const std::filesystem::path&, bool& passed) { return Core::RunConvertCheck(&passed); }},
+};
+
+// Runs the headless command cmdLine starts with, if any
+bool RunHeadlessCommand(const wchar_t* cmdLine, int& exitCode)
+{
+    if (!cmdLine) return false;
+    for (const auto& command : kHeadlessCommands) {
+        const size_t length = wcslen(command.name);
+        if (wcsncmp(cmdLine, command.name, length) != 0) continue;
+        if (cmdLine[length] != L'\0' && cmdLine[length] != L' ') continue;
+
+        std::wstring folder = cmdLine + length;
+        while (!folder.empty() && (folder.front() == L' ' || folder.front() == L'"')) folder.erase(folder.begin());
+        while (!folder.empty() && (folder.back() == L' ' || folder.back() == L'"')) folder.pop_back();
+
+        bool passed = true;
+        std::string report = command.run(folder, passed);
+        OutputDebugStringA(("[UIV] " + report).c_str());
+
+        // GUI-subsystem process: borrow the launching console, if any
+        if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+            FILE* out = nullptr;
+            if (freopen_s(&out, "CONOUT$", "w", stdout) == 0) {
+                fputs(report.c_str(), stdout);
+                fflush(stdout);
+            }
+        }
+        exitCode = passed ? 0 : 1;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
 // Entry point
 int APIENTRY wWinMain(
     HINSTANCE hInstance,
@@ -25,6 +88,13 @@ int APIENTRY wWinMain(
         return 1;
     }
 
+    // Headless commands (benchmarks, checks) run instead of the viewer
+    int headlessExitCode = 0;
+    if (RunHeadlessCommand(lpCmdLine, headlessExitCode)) {
+        CoUninitialize();
+        return headlessExitCode;
+    }
+
     // Create and run application
     auto app = std::make_unique<UltraImageViewer::Core::Application>();
 
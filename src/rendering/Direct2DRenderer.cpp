@@ -366,10 +366,12 @@ ComPtr<ID2D1Bitmap> Direct2DRenderer::CreateBitmap(
 
     D2D1_SIZE_U size = { width, height };
 
+    // Tightly packed: 32-bit BGRA, or 64-bit half-float RGBA
+    const UINT32 bytesPerPixel = format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 8 : 4;
     HRESULT hr = context_->CreateBitmap(
         size,
         pixelData,
-        width * 4, // Pitch (assuming 32-bit BGRA)
+        width * bytesPerPixel,
         &props,
         &bitmap
     );
@@ -0,0 +1,173 @@
+#include "rendering/NullTextureFactory.hpp"
+#include <cstring>
+#include <new>
+
+namespace UltraImageViewer {
+namespace Rendering {
+
+namespace {
+
+size_t BytesPerPixel(DXGI_FORMAT format)
+{
+    return format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 8 : 4;
+}
+
+// Minimal ID2D1Bitmap: answers size/format queries, keeps the pixels it was
+// created from, and fails anything that needs a device.
+class NullBitmap final : public ID2D1Bitmap {
+public:
+    NullBitmap(std::shared_ptr<NullTextureFactory::Counters> counters,
+               uint32_t width, uint32_t height, DXGI_FORMAT format,
+               const void* pixelData, bool retainPixels)
+        : counters_(std::move(counters))
+        , width_(width)
+        , height_(height)
+        , format_(format)
+        , bytes_(static_cast<size_t>(width) * height * BytesPerPixel(format))  // same pitch as Direct2DRenderer
+    {
+        if (retainPixels) {
+            pixels_ = std::make_unique<uint8_t[]>(bytes_);
+            if (pixelData) std::memcpy(pixels_.get(), pixelData, bytes_);
+        }
+        counters_->liveBitmaps.fetch_add(1, std::memory_order_relaxed);
+        int64_t live = counters_->liveBytes.fetch_add(static_cast<int64_t>(bytes_),
+                                                      std::memory_order_relaxed) + static_cast<int64_t>(bytes_);
+        int64_t peak = counters_->peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !counters_->peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    ~NullBitmap()
+    {
+        counters_->liveBitmaps.fetch_sub(1, std::memory_order_relaxed);
+        counters_->liveBytes.fetch_sub(static_cast<int64_t>(bytes_), std::memory_order_relaxed);
+    }
+
+    // IUnknown
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (!object) return E_POINTER;
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(ID2D1Resource) ||
+            riid == __uuidof(ID2D1Image) || riid == __uuidof(ID2D1Bitmap)) {
+            *object = static_cast<ID2D1Bitmap*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return refCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        ULONG count = refCount_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (count == 0) delete this;
+        return count;
+    }
+
+    // ID2D1Resource
+    void STDMETHODCALLTYPE GetFactory(ID2D1Factory** factory) const override
+    {
+        if (factory) *factory = nullptr;
+    }
+
+    // ID2D1Bitmap (96 DPI: DIPs equal pixels)
+    D2D1_SIZE_F STDMETHODCALLTYPE GetSize() const override
+    {
+        return D2D1_SIZE_F{static_cast<float>(width_), static_cast<float>(height_)};
+    }
+
+    D2D1_SIZE_U STDMETHODCALLTYPE GetPixelSize() const override
+    {
+        return D2D1_SIZE_U{width_, height_};
+    }
+
+    D2D1_PIXEL_FORMAT STDMETHODCALLTYPE GetPixelFormat() const override
+    {
+        return D2D1_PIXEL_FORMAT{format_, D2D1_ALPHA_MODE_PREMULTIPLIED};
+    }
+
+    void STDMETHODCALLTYPE GetDpi(FLOAT* dpiX, FLOAT* dpiY) const override
+    {
+        if (dpiX) *dpiX = 96.0f;
+        if (dpiY) *dpiY = 96.0f;
+    }
+
+    HRESULT STDMETHODCALLTYPE CopyFromBitmap(const D2D1_POINT_2U*, ID2D1Bitmap*, const D2D1_RECT_U*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CopyFromRenderTarget(const D2D1_POINT_2U*, ID2D1RenderTarget*,
+                                                   const D2D1_RECT_U*) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CopyFromMemory(const D2D1_RECT_U* dstRect, const void* srcData, UINT32 pitch) override
+    {
+        if (!pixels_ || !srcData) return S_OK;
+
+        D2D1_RECT_U rect = dstRect ? *dstRect : D2D1_RECT_U{0, 0, width_, height_};
+        if (rect.right > width_ || rect.bottom > height_ || rect.left >= rect.right || rect.top >= rect.bottom) {
+            return E_INVALIDARG;
+        }
+        const size_t bytesPerPixel = BytesPerPixel(format_);
+        size_t rowBytes = static_cast<size_t>(rect.right - rect.left) * bytesPerPixel;
+        const auto* src = static_cast<const uint8_t*>(srcData);
+        for (uint32_t y = rect.top; y < rect.bottom; ++y) {
+            std::memcpy(pixels_.get() + (static_cast<size_t>(y) * width_ + rect.left) * bytesPerPixel,
+                        src + static_cast<size_t>(y - rect.top) * pitch, rowBytes);
+        }
+        return S_OK;
+    }
+
+private:
+    std::atomic<ULONG> refCount_{1};
+    std::shared_ptr<NullTextureFactory::Counters> counters_;
+    uint32_t width_;
+    uint32_t height_;
+    DXGI_FORMAT format_;
+    size_t bytes_;
+    std::unique_ptr<uint8_t[]> pixels_;
+};
+
+} // namespace
+
+NullTextureFactory::NullTextureFactory(bool retainPixels)
+    : counters_(std::make_shared<Counters>())
+    , retainPixels_(retainPixels)
+{
+}
+
+Microsoft::WRL::ComPtr<ID2D1Bitmap> NullTextureFactory::CreateBitmap(
+    uint32_t width,
+    uint32_t height,
+    const void* pixelData,
+    DXGI_FORMAT format)
+{
+    if (width == 0 || height == 0) {
+        return nullptr;
+    }
+
+    auto* bitmap = new (std::nothrow) NullBitmap(counters_, width, height, format, pixelData, retainPixels_);
+    if (!bitmap) {
+        return nullptr;
+    }
+    counters_->uploads.fetch_add(1, std::memory_order_relaxed);
+    counters_->uploadedBytes.fetch_add(static_cast<uint64_t>(width) * height * BytesPerPixel(format),
+                                       std::memory_order_relaxed);
+
+    // Attach() adopts the initial reference
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> result;
+    result.Attach(bitmap);
+    return result;
+}
+
+} // namespace Rendering
+} // namespace UltraImageViewer
@@ -2,6 +2,7 @@
 #include "ui/Theme.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <map>
 #include <vector>
 #include <d2d1_1.h>
@@ -13,6 +14,9 @@ using Microsoft::WRL::ComPtr;
 namespace UltraImageViewer {
 namespace UI {
 
+// Fling projection: seconds of release velocity added to the scroll target
+static constexpr float kInertiaProjection = 0.6f;
+
 // Helper: draw a bitmap clipped to a rounded rectangle
 static void DrawBitmapRounded(ID2D1DeviceContext* ctx, ID2D1Factory* factory,
                                ID2D1Bitmap* bitmap, const D2D1_RECT_F& destRect,
@@ -95,7 +99,21 @@ GalleryView::GalleryView()
     deleteCardScale_.SnapToTarget();
 }
 
-GalleryView::~GalleryView() = default;
+GalleryView::~GalleryView()
+{
+    // Landing prefetch hit rate against what the fixed margin alone would have covered
+    if (prefetchStats_.visibleCells > 0) {
+        char msg[192];
+        std::snprintf(msg, sizeof(msg),
+                      "[UIV] Scroll prefetch: %llu stops (%llu predicted), %.1f%% of cells ready at rest, "
+                      "%.1f%% inside the fixed margin\n",
+                      static_cast<unsigned long long>(prefetchStats_.stops),
+                      static_cast<unsigned long long>(prefetchStats_.predictedStops),
+                      100.0 * prefetchStats_.readyCells / prefetchStats_.visibleCells,
+                      100.0 * prefetchStats_.marginCells / prefetchStats_.visibleCells);
+        OutputDebugStringA(msg);
+    }
+}
 
 void GalleryView::Initialize(Rendering::Direct2DRenderer* renderer,
                               Core::ImagePipeline* pipeline,
@@ -111,6 +129,13 @@ void GalleryView::SetImagesGrouped(const std::vector<Core::ScannedImage>& scanne
 {
     bool wasEmpty = images_.empty();
 
+    // Copies of the same photo share one thumbnail; probed sizes spare the
+    // viewer and decode admission a header read per open
+    if (pipeline_) {
+        pipeline_->SetContentAliases(scannedImages);
+        pipeline_->SetScannedSizes(scannedImages);
+    }
+
     images_.clear();
     sections_.clear();
 
@@ -337,7 +362,7 @@ void GalleryView::EnterFolderDetail(size_t albumIndex)
     if (pipeline_) {
         size_t preload = std::min(folderDetailImages_.size(), size_t(40));
         for (size_t i = 0; i < preload; ++i) {
-            pipeline_->RequestThumbnail(folderDetailImages_[i], Theme::ThumbnailMaxPx);
+            pipeline_->RequestThumbnail(folderDetailImages_[i], Theme::ThumbnailScrollPx);
         }
     }
 
@@ -726,16 +751,19 @@ static void RenderImageGrid(
     float hoverX, float hoverY,
     std::optional<size_t> skipIndex,
     bool isFastScrolling,
+    bool isSettled,
     float dpiScale,
     std::vector<std::filesystem::path>* outVisiblePaths,
     LARGE_INTEGER budgetDeadline = {},
     LARGE_INTEGER perfFreq = {})
 {
-    // Cap thumbnail resolution to keep memory footprint small (160×160×4 = 100KB each)
-    // so the cache can hold 10,000+ thumbnails without eviction.
-    uint32_t targetPx = std::min(
+    // Thumbnail ladder: prefetch cells and anything requested mid-scroll stay at
+    // the mid level (160×160×4 = 100KB each) so the cache holds 10,000+ of them;
+    // on-screen cells step up to the sharp level once scrolling settles.
+    uint32_t sharpPx = std::min(
         static_cast<uint32_t>(grid.cellSize * dpiScale),
         Theme::ThumbnailMaxPx);
+    uint32_t scrollPx = std::min(sharpPx, Theme::ThumbnailScrollPx);
 
     // Prefetch buffer: pre-decode 1.5 screens above and below the viewport
     // so thumbnails are ready before the user scrolls to them.
@@ -822,8 +850,18 @@ static void RenderImageGrid(
                         thumbnail = pipeline->GetCachedThumbnail(images[globalIndex]);
                     }
                 } else {
-                    // Normal scroll: request for both visible and prefetch cells
-                    thumbnail = pipeline->RequestThumbnail(images[globalIndex], targetPx);
+                    // Normal scroll: request for both visible and prefetch cells,
+                    // ranked by distance from the viewport centre
+                    float centerDistance = cellY + grid.cellSize * 0.5f - contentHeight * 0.5f;
+                    uint32_t targetPx = (onScreen && isSettled) ? sharpPx : scrollPx;
+                    thumbnail = pipeline->RequestThumbnail(images[globalIndex], targetPx, centerDistance);
+                }
+            }
+
+            // Settled on-screen cells play GIF/WebP animations over the poster
+            if (onScreen && isSettled && pipeline) {
+                if (auto frame = pipeline->RequestAnimationFrame(images[globalIndex], sharpPx)) {
+                    thumbnail = frame;
                 }
             }
 
@@ -863,6 +901,105 @@ static void RenderImageGrid(
     }
 }
 
+bool GalleryView::IsScrollSettled() const
+{
+    return !isDragging_ && scrollDirection_ == 0 && !isFastScrolling_;
+}
+
+float GalleryView::PredictScrollLanding(const Animation::SpringAnimation& spring,
+                                         float maxScroll) const
+{
+    // While dragging, project the fling OnMouseUp would start right now
+    float landing = isDragging_
+        ? spring.GetValue() + scrollVelocity_ * kInertiaProjection
+        : spring.PredictRestValue();
+    // Rubber band pulls any overshoot back into range
+    return std::clamp(landing, 0.0f, std::max(0.0f, maxScroll));
+}
+
+void GalleryView::PrefetchScrollLanding(const Animation::SpringAnimation& spring, float maxScroll,
+                                        const GridLayout& grid,
+                                        const std::vector<std::filesystem::path>& images,
+                                        const std::vector<SectionLayoutInfo>& layouts,
+                                        const std::vector<Section>& sections,
+                                        float contentHeight, float dpiScale)
+{
+    if (!pipeline_ || grid.columns <= 0) return;
+    if (!isDragging_ && spring.IsFinished()) return;
+
+    float scroll = spring.GetValue();
+    float landing = PredictScrollLanding(spring, maxScroll);
+
+    // The regular grid pass already covers the prefetch margin, except during
+    // fast scroll where it only shows cached thumbnails.
+    float margin = contentHeight * Theme::PrefetchScreens;
+    if (!isFastScrolling_ &&
+        landing >= scroll - margin && landing <= scroll + margin) {
+        return;
+    }
+
+    scrollLandingPrefetched_ = true;
+
+    uint32_t targetPx = std::min(
+        static_cast<uint32_t>(grid.cellSize * dpiScale),
+        Theme::ThumbnailScrollPx);
+
+    float rowPitch = grid.cellSize + grid.gap;
+    float top = landing - contentHeight * Theme::LandingPrefetchScreens;
+    float bottom = landing + contentHeight * (1.0f + Theme::LandingPrefetchScreens);
+    float landingCenter = landing + contentHeight * 0.5f;
+
+    for (size_t s = 0; s < sections.size() && s < layouts.size(); ++s) {
+        const auto& sl = layouts[s];
+        if (sl.rows <= 0) continue;
+        if (sl.contentY + sl.rows * rowPitch < top) continue;
+        if (sl.contentY > bottom) break;
+
+        int firstRow = std::max(0, static_cast<int>((top - sl.contentY) / rowPitch));
+        int lastRow = std::min(sl.rows - 1, static_cast<int>((bottom - sl.contentY) / rowPitch));
+        for (int row = firstRow; row <= lastRow; ++row) {
+            // Rank against the landing viewport, not the current one
+            float distance = sl.contentY + row * rowPitch + grid.cellSize * 0.5f - landingCenter;
+            for (int col = 0; col < grid.columns; ++col) {
+                size_t local = static_cast<size_t>(row) * grid.columns + col;
+                if (local >= sections[s].count) break;
+                size_t globalIndex = sections[s].startIndex + local;
+                if (globalIndex >= images.size()) break;
+                pipeline_->RequestThumbnail(images[globalIndex], targetPx, distance);
+            }
+        }
+    }
+}
+
+void GalleryView::RecordScrollStop(const Animation::SpringAnimation& spring,
+                                   const std::vector<std::filesystem::path>& visiblePaths,
+                                   float scroll, float contentHeight)
+{
+    if (!scrollStopPending_ || scrollMotionSpring_ != &spring) return;
+    scrollStopPending_ = false;
+    if (!pipeline_ || visiblePaths.empty() || contentHeight <= 0.0f) return;
+
+    size_t ready = 0;
+    for (const auto& p : visiblePaths) {
+        if (pipeline_->HasThumbnail(p)) ++ready;
+    }
+
+    // Baseline: share of the landing viewport the fixed margin around the
+    // motion's start position would have prefetched
+    float margin = contentHeight * Theme::PrefetchScreens;
+    float windowTop = scrollMotionStart_ - margin;
+    float windowBottom = scrollMotionStart_ + contentHeight + margin;
+    float overlap = std::min(windowBottom, scroll + contentHeight) - std::max(windowTop, scroll);
+    float coverage = std::clamp(overlap / contentHeight, 0.0f, 1.0f);
+    size_t marginCells = static_cast<size_t>(std::lround(coverage * visiblePaths.size()));
+
+    ++prefetchStats_.stops;
+    if (scrollLandingPrefetched_) ++prefetchStats_.predictedStops;
+    prefetchStats_.visibleCells += visiblePaths.size();
+    prefetchStats_.readyCells += ready;
+    prefetchStats_.marginCells += marginCells;
+}
+
 void GalleryView::RenderPhotosTab(Rendering::Direct2DRenderer* renderer,
                                    ID2D1DeviceContext* ctx, float contentHeight)
 {
@@ -889,13 +1026,19 @@ void GalleryView::RenderPhotosTab(Rendering::Direct2DRenderer* renderer,
         cellBrush_.Get(), textBrush_.Get(), secondaryBrush_.Get(), hoverBrush_.Get(),
         sectionFormat_.Get(), countRightFormat_.Get(),
         hoverX_, hoverY_, skipIndex_,
-        isFastScrolling_, dpiScale, &visiblePaths,
+        isFastScrolling_, IsScrollSettled(), dpiScale, &visiblePaths,
         frameBudgetDeadline_, framePerfFreq_);
 
     // Tell pipeline which paths are visible for prioritization
     if (pipeline_ && !visiblePaths.empty()) {
         pipeline_->SetVisibleRange(visiblePaths);
     }
+    PrefetchScrollLanding(scrollY_, maxScroll_, grid, images_, sectionLayouts_, sections_,
+                          contentHeight, dpiScale);
+    RecordScrollStop(scrollY_, visiblePaths, scroll, contentHeight);
+    if (pipeline_) {
+        pipeline_->UpdateThumbnailPriorities(scrollDirection_);
+    }
 
     // === Header overlay (covers scrolling content) ===
     if (bgBrush_) {
@@ -1094,7 +1237,8 @@ void GalleryView::RenderAlbumsTab(Rendering::Direct2DRenderer* renderer,
                 uint32_t albumTargetPx = std::min(
                     static_cast<uint32_t>(ag.cardWidth * (renderer ? renderer->GetDpiX() / 96.0f : 1.0f)),
                     Theme::ThumbnailMaxPx);
-                thumbnail = pipeline_->RequestThumbnail(folderAlbums_[i].coverImage, albumTargetPx);
+                thumbnail = pipeline_->RequestThumbnail(folderAlbums_[i].coverImage, albumTargetPx,
+                                                        centerY - contentHeight * 0.5f);
             }
         }
         if (thumbnail) {
@@ -1233,13 +1377,22 @@ void GalleryView::RenderFolderDetail(Rendering::Direct2DRenderer* renderer,
         cellBrush_.Get(), textBrush_.Get(), secondaryBrush_.Get(), hoverBrush_.Get(),
         sectionFormat_.Get(), countRightFormat_.Get(),
         hoverX_, hoverY_, skipIndex_,
-        isFastScrolling_, dpiScale, &visiblePaths,
+        isFastScrolling_, IsScrollSettled(), dpiScale, &visiblePaths,
         frameBudgetDeadline_, framePerfFreq_);
 
     // Tell pipeline which paths are visible for prioritization
     if (pipeline_ && !visiblePaths.empty()) {
         pipeline_->SetVisibleRange(visiblePaths);
     }
+    if (!folderTransitionActive_) {
+        PrefetchScrollLanding(folderDetailScrollY_, folderDetailMaxScroll_, grid,
+                              folderDetailImages_, folderDetailSectionLayouts_, folderDetailSections_,
+                              contentHeight, dpiScale);
+        RecordScrollStop(folderDetailScrollY_, visiblePaths, scroll, contentHeight);
+    }
+    if (pipeline_) {
+        pipeline_->UpdateThumbnailPriorities(scrollDirection_);
+    }
 
     // Header text moved to RenderGlassFolderHeader (Pass 2) for glass backing
 
@@ -1774,13 +1927,36 @@ void GalleryView::Update(float deltaTime)
     // --- Fast-scroll detection ---
     {
         // Pick the active scroll animation's velocity
-        float rawVelocity = 0.0f;
+        const Animation::SpringAnimation* activeScroll = &albumsScrollY_;
         if (activeTab_ == GalleryTab::Photos) {
-            rawVelocity = std::abs(scrollY_.GetVelocity());
+            activeScroll = &scrollY_;
         } else if (inFolderDetail_) {
-            rawVelocity = std::abs(folderDetailScrollY_.GetVelocity());
+            activeScroll = &folderDetailScrollY_;
+        }
+        float signedVelocity = activeScroll->GetVelocity();
+        float rawVelocity = std::abs(signedVelocity);
+
+        // Track scroll motions from start to rest for landing-prefetch metrics
+        bool moving = isDragging_ || !activeScroll->IsFinished();
+        if (activeScroll != scrollMotionSpring_) {
+            scrollMotionSpring_ = activeScroll;
+            scrollMotionActive_ = false;
+            scrollStopPending_ = false;
+        }
+        if (moving && !scrollMotionActive_) {
+            scrollMotionActive_ = true;
+            scrollLandingPrefetched_ = false;
+            scrollMotionStart_ = activeScroll->GetValue();
+        } else if (!moving && scrollMotionActive_) {
+            scrollMotionActive_ = false;
+            scrollStopPending_ = true;
+        }
+
+        // Direction used to rank thumbnail decodes (ignore sub-pixel drift)
+        if (rawVelocity < 1.0f) {
+            scrollDirection_ = 0;
         } else {
-            rawVelocity = std::abs(albumsScrollY_.GetVelocity());
+            scrollDirection_ = signedVelocity > 0.0f ? 1 : -1;
         }
 
         scrollVelocitySmoothed_ = scrollVelocitySmoothed_ * 0.6f + rawVelocity * 0.4f;
@@ -1930,7 +2106,7 @@ void GalleryView::OnMouseUp(float x, float y)
             activeScroll = &folderDetailScrollY_;
         }
 
-        float inertiaTarget = activeScroll->GetValue() + scrollVelocity_ * 0.6f;
+        float inertiaTarget = activeScroll->GetValue() + scrollVelocity_ * kInertiaProjection;
         inertiaTarget = std::max(-80.0f, std::min(inertiaTarget, currentMaxScroll + 80.0f));
         activeScroll->SetTarget(inertiaTarget);
         activeScroll->SetConfig({Theme::ScrollStiffness, Theme::ScrollDamping, 1.0f, 0.5f});
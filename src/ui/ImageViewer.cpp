@@ -16,6 +16,8 @@ static constexpr float kDismissThreshold = 100.0f;
 static constexpr float kPageThreshold = 0.25f;  // Fraction of view width to trigger page change
 static constexpr float kDragThreshold = 5.0f;
 static constexpr ULONGLONG kDoubleTapMs = 300;
+static constexpr float kFullResMagnification = 1.05f;  // Preview stretch that triggers the full-res decode
+static constexpr float kDocStripMargin = 12.0f;        // Page strip inset from the bottom edge
 
 ImageViewer::ImageViewer()
     : pageOffsetX_(kPageSpring)
@@ -43,6 +45,7 @@ void ImageViewer::Initialize(Rendering::Direct2DRenderer* renderer,
 {
     pipeline_ = pipeline;
     engine_ = engine;
+    if (renderer) dpiScale_ = renderer->GetDpiX() / 96.0f;
     EnsureResources(renderer);
 }
 
@@ -52,6 +55,7 @@ void ImageViewer::EnsureResources(Rendering::Direct2DRenderer* renderer)
     bgBrush_ = renderer->CreateBrush(Theme::ViewerBg);
     overlayTextBrush_ = renderer->CreateBrush(D2D1::ColorF(1.0f, 1.0f, 1.0f, 0.9f));
     overlayBgBrush_ = renderer->CreateBrush(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.35f));
+    accentBrush_ = renderer->CreateBrush(Theme::Accent);
     counterFormat_ = renderer->CreateTextFormat(L"Segoe UI", 14.0f, DWRITE_FONT_WEIGHT_SEMI_BOLD);
     filenameFormat_ = renderer->CreateTextFormat(L"Segoe UI", 13.0f);
     if (counterFormat_) {
@@ -70,9 +74,13 @@ void ImageViewer::ReleaseDeviceResources()
     currentBitmap_.Reset();
     prevBitmap_.Reset();
     nextBitmap_.Reset();
+    docPageBitmap_.Reset();
+    currentStage_ = OpenStage::None;
+    pageRequested_ = false;
     bgBrush_.Reset();
     overlayTextBrush_.Reset();
     overlayBgBrush_.Reset();
+    accentBrush_.Reset();
     counterFormat_.Reset();
     filenameFormat_.Reset();
     resourcesCreated_ = false;
@@ -111,27 +119,144 @@ void ImageViewer::LoadCurrentPage()
 {
     if (!pipeline_ || images_.empty()) return;
 
-    currentBitmap_ = pipeline_->GetBitmap(images_[currentIndex_]);
-    prevBitmap_ = (currentIndex_ > 0) ? pipeline_->GetThumbnail(images_[currentIndex_ - 1]) : nullptr;
-    nextBitmap_ = (currentIndex_ + 1 < images_.size()) ? pipeline_->GetThumbnail(images_[currentIndex_ + 1]) : nullptr;
+    // Whatever is still queued for the page we left is no longer wanted
+    pipeline_->CancelOpenRequests();
+    pageRequested_ = true;
+    fullRequested_ = false;
+    currentTiled_ = false;
+
+    // A new image opens on its first document page; the last one's pages go
+    auto currentPath = images_[currentIndex_];
+    pipeline_->ReleaseDocPages();
+    docPageBitmap_.Reset();
+    currentDocPage_ = 0;
+    docPageCount_ = pipeline_->GetDocPageCount(currentPath);
+
+    // Source size from the scan probe until a decode reports it
+    if (!pipeline_->GetSourceSize(currentPath, sourceWidth_, sourceHeight_)) {
+        sourceWidth_ = sourceHeight_ = 0;
+    }
+
+    // Stage 1: cached thumbnails only (no decode on the UI thread), drawn upscaled
+    currentBitmap_ = pipeline_->GetCachedThumbnail(currentPath);
+    currentStage_ = currentBitmap_ ? OpenStage::Thumbnail : OpenStage::None;
+    prevBitmap_ = (currentIndex_ > 0) ? pipeline_->GetCachedThumbnail(images_[currentIndex_ - 1]) : nullptr;
+    nextBitmap_ = (currentIndex_ + 1 < images_.size()) ? pipeline_->GetCachedThumbnail(images_[currentIndex_ + 1]) : nullptr;
+
+    // Stage 2: screen-resolution decode. May call back immediately if cached.
+    uint32_t previewPx = PreviewMaxPx();
+    pipeline_->GetPreviewAsync(currentPath, previewPx, [this, currentPath](auto bmp, bool isFull) {
+        if (images_.empty() || images_[currentIndex_] != currentPath) return;
+        OpenStage stage = isFull ? OpenStage::Full : OpenStage::Preview;
+        if (stage <= currentStage_) return;
+        currentBitmap_ = bmp;
+        currentStage_ = stage;
+        if (pipeline_->GetSourceSize(currentPath, sourceWidth_, sourceHeight_)) {
+            currentTiled_ = !isFull && std::max(sourceWidth_, sourceHeight_) > Theme::TiledImageMinEdge;
+        }
+    });
 
-    // Prefetch full-res neighbors
+    // Prefetch screen-resolution neighbors (behind the current page's decode)
     if (currentIndex_ > 0) {
         auto expectedPath = images_[currentIndex_ - 1];
-        pipeline_->GetBitmapAsync(expectedPath, [this, expectedPath](auto bmp) {
+        pipeline_->GetPreviewAsync(expectedPath, previewPx, [this, expectedPath](auto bmp, bool) {
             if (currentIndex_ > 0 && images_[currentIndex_ - 1] == expectedPath) {
                 prevBitmap_ = bmp;
             }
-        });
+        }, Core::TaskPriority::Normal);
     }
     if (currentIndex_ + 1 < images_.size()) {
         auto expectedPath = images_[currentIndex_ + 1];
-        pipeline_->GetBitmapAsync(expectedPath, [this, expectedPath](auto bmp) {
+        pipeline_->GetPreviewAsync(expectedPath, previewPx, [this, expectedPath](auto bmp, bool) {
             if (currentIndex_ + 1 < images_.size() && images_[currentIndex_ + 1] == expectedPath) {
                 nextBitmap_ = bmp;
             }
-        });
+        }, Core::TaskPriority::Normal);
+    }
+}
+
+uint32_t ImageViewer::PreviewMaxPx() const
+{
+    // Never below the sharpest thumbnail, and never 0 (which means full resolution)
+    uint32_t screenPx = static_cast<uint32_t>(std::ceil(std::max(viewWidth_, viewHeight_) * dpiScale_));
+    return std::max(screenPx, Theme::ThumbnailMaxPx);
+}
+
+void ImageViewer::RenderTiles(Rendering::Direct2DRenderer* renderer, const D2D1_RECT_F& destRect)
+{
+    float destW = destRect.right - destRect.left;
+    float destH = destRect.bottom - destRect.top;
+    if (destW <= 0.0f || destH <= 0.0f || sourceWidth_ == 0 || sourceHeight_ == 0) return;
+
+    // Coarsest pyramid level that still has at least one pixel per screen pixel
+    float screenPerSource = destW * dpiScale_ / static_cast<float>(sourceWidth_);
+    int levelCount = Core::TiledImageSource::LevelCountFor(sourceWidth_, sourceHeight_);
+    int level = 0;
+    while (level + 1 < levelCount && screenPerSource * static_cast<float>(1u << (level + 1)) <= 1.0f) {
+        ++level;
     }
+
+    // Nothing to add while the preview is as dense as that level
+    uint32_t levelW, levelH;
+    Core::TiledImageSource::LevelSize(sourceWidth_, sourceHeight_, level, levelW, levelH);
+    if (currentBitmap_ && levelW <= currentBitmap_->GetPixelSize().width) return;
+
+    float visL = std::max(destRect.left, 0.0f);
+    float visT = std::max(destRect.top, 0.0f);
+    float visR = std::min(destRect.right, viewWidth_);
+    float visB = std::min(destRect.bottom, viewHeight_);
+    if (visR <= visL || visB <= visT) return;
+
+    // Screen -> level pixel scale
+    float sx = static_cast<float>(levelW) / destW;
+    float sy = static_cast<float>(levelH) / destH;
+    uint32_t lastTileX = (levelW - 1) / Core::kTileSize;
+    uint32_t lastTileY = (levelH - 1) / Core::kTileSize;
+    uint32_t tx0 = std::min(lastTileX, static_cast<uint32_t>((visL - destRect.left) * sx) / Core::kTileSize);
+    uint32_t tx1 = std::min(lastTileX, static_cast<uint32_t>((visR - destRect.left) * sx) / Core::kTileSize);
+    uint32_t ty0 = std::min(lastTileY, static_cast<uint32_t>((visT - destRect.top) * sy) / Core::kTileSize);
+    uint32_t ty1 = std::min(lastTileY, static_cast<uint32_t>((visB - destRect.top) * sy) / Core::kTileSize);
+
+    const auto& path = images_[currentIndex_];
+    for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+        for (uint32_t tx = tx0; tx <= tx1; ++tx) {
+            auto tile = pipeline_->RequestTile(path, level, tx, ty);
+            if (!tile) continue;  // preview shows through until it lands
+
+            auto px = tile->GetPixelSize();
+            float x0 = static_cast<float>(tx * Core::kTileSize);
+            float y0 = static_cast<float>(ty * Core::kTileSize);
+            D2D1_RECT_F tileRect = D2D1::RectF(
+                destRect.left + x0 / sx,
+                destRect.top + y0 / sy,
+                destRect.left + (x0 + px.width) / sx,
+                destRect.top + (y0 + px.height) / sy);
+            // Linear keeps neighbouring tiles from ringing at their shared edge
+            renderer->DrawImage(tile.Get(), tileRect, 1.0f, D2D1_INTERPOLATION_MODE_LINEAR);
+        }
+    }
+}
+
+void ImageViewer::RequestFullResolutionIfNeeded()
+{
+    // Stage 3 is only worth it once the preview is up and being magnified
+    if (!pipeline_ || images_.empty() || !currentBitmap_) return;
+    if (currentStage_ != OpenStage::Preview || fullRequested_ || currentTiled_ || currentDocPage_ > 0) return;
+
+    auto size = currentBitmap_->GetSize();
+    D2D1_RECT_F fitRect = CalculateFitRect(size.width, size.height);
+    float zoom = std::max(zoomSpring_.GetValue(), zoomSpring_.GetTarget());
+    float shownPx = (fitRect.right - fitRect.left) * zoom * dpiScale_;
+    float bitmapPx = static_cast<float>(currentBitmap_->GetPixelSize().width);
+    if (shownPx <= bitmapPx * kFullResMagnification) return;
+
+    fullRequested_ = true;
+    auto currentPath = images_[currentIndex_];
+    pipeline_->GetPreviewAsync(currentPath, 0, [this, currentPath](auto bmp, bool) {
+        if (images_.empty() || images_[currentIndex_] != currentPath) return;
+        currentBitmap_ = bmp;
+        currentStage_ = OpenStage::Full;
+    });
 }
 
 D2D1_RECT_F ImageViewer::CalculateFitRect(float imgW, float imgH) const
@@ -160,8 +285,9 @@ float ImageViewer::CalculateFitZoom(float imgW, float imgH) const
 
 D2D1_RECT_F ImageViewer::CalculatePanBounds() const
 {
-    if (!currentBitmap_) return D2D1::RectF(0, 0, 0, 0);
-    auto size = currentBitmap_->GetSize();
+    ID2D1Bitmap* bitmap = DisplayedBitmap();
+    if (!bitmap) return D2D1::RectF(0, 0, 0, 0);
+    auto size = bitmap->GetSize();
     D2D1_RECT_F fitRect = CalculateFitRect(size.width, size.height);
     float fitW = fitRect.right - fitRect.left;
     float fitH = fitRect.bottom - fitRect.top;
@@ -185,9 +311,14 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
     auto* ctx = renderer->GetContext();
     if (!ctx) return;
 
-    if (!currentBitmap_ && !images_.empty()) {
+    dpiScale_ = renderer->GetDpiX() / 96.0f;
+    if (!pageRequested_ && !images_.empty()) {
         LoadCurrentPage();
     }
+    if (pipeline_) {
+        pipeline_->FlushReadyTiles(Theme::MaxTilesPerFrame);
+        pipeline_->FlushReadyDocPages(Theme::MaxDocPagesPerFrame);
+    }
 
     float dismissY = dismissSpring_.GetValue();
     float dismissScale = 1.0f - std::abs(dismissY) / (viewHeight_ * 2.0f);
@@ -224,9 +355,25 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
         renderer->DrawImage(prevBitmap_.Get(), destRect, 1.0f);
     }
 
-    // Draw current page
-    if (currentBitmap_) {
-        auto size = currentBitmap_->GetSize();
+    // Draw current page; an animated GIF/WebP shows its playing frame and a
+    // multi-page document the page it's turned to (the last one shown stays
+    // up while that decodes)
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> shownBitmap = currentBitmap_;
+    if (pipeline_ && !images_.empty()) {
+        if (auto frame = pipeline_->RequestAnimationFrame(images_[currentIndex_], PreviewMaxPx())) {
+            shownBitmap = frame;
+        }
+        if (docPageCount_ > 1) {
+            if (auto page = pipeline_->RequestDocPage(images_[currentIndex_], currentDocPage_, PreviewMaxPx())) {
+                docPageBitmap_ = page;
+            }
+            if (currentDocPage_ > 0 && docPageBitmap_) {
+                shownBitmap = docPageBitmap_;
+            }
+        }
+    }
+    if (shownBitmap) {
+        auto size = shownBitmap->GetSize();
         D2D1_RECT_F fitRect = CalculateFitRect(size.width, size.height);
         fitZoom_ = CalculateFitZoom(size.width, size.height);
 
@@ -252,7 +399,10 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
             destRect.bottom -= dh;
         }
 
-        renderer->DrawImage(currentBitmap_.Get(), destRect, 1.0f);
+        renderer->DrawImage(shownBitmap.Get(), destRect, 1.0f);
+        if (currentTiled_ && currentDocPage_ == 0) {
+            RenderTiles(renderer, destRect);
+        }
     }
 
     // Draw next page
@@ -281,11 +431,16 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
         // Text shadow brush for readability
         auto shadowBrush = renderer->CreateBrush(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.6f * overlayAlpha));
 
-        // Image counter "3 / 15"
+        // Image counter "3 / 15", led by "Page 2 / 7" for multi-page documents
+        float counterLeft = viewWidth_ - (docPageCount_ > 1 ? 260.0f : 140.0f);
         if (counterFormat_ && overlayTextBrush_) {
             std::wstring counter = std::to_wstring(currentIndex_ + 1) + L" / " + std::to_wstring(images_.size());
+            if (docPageCount_ > 1) {
+                counter = L"Page " + std::to_wstring(currentDocPage_ + 1) + L" / " +
+                          std::to_wstring(docPageCount_) + L"   " + counter;
+            }
             D2D1_RECT_F counterRect = D2D1::RectF(
-                viewWidth_ - 140.0f, 6.0f, viewWidth_ - 14.0f, 38.0f);
+                counterLeft, 6.0f, viewWidth_ - 14.0f, 38.0f);
 
             // Shadow
             if (shadowBrush) {
@@ -304,7 +459,7 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
         // Filename
         if (filenameFormat_ && overlayTextBrush_) {
             auto name = images_[currentIndex_].filename().wstring();
-            D2D1_RECT_F nameRect = D2D1::RectF(14.0f, 6.0f, viewWidth_ - 150.0f, 38.0f);
+            D2D1_RECT_F nameRect = D2D1::RectF(14.0f, 6.0f, counterLeft - 10.0f, 38.0f);
 
             // Shadow
             if (shadowBrush) {
@@ -320,7 +475,88 @@ void ImageViewer::Render(Rendering::Direct2DRenderer* renderer, bool overlayMode
                           filenameFormat_.Get(), nameRect, overlayTextBrush_.Get());
             overlayTextBrush_->SetOpacity(1.0f);
         }
+
+        RenderDocPageStrip(renderer, overlayAlpha);
+    }
+}
+
+D2D1_RECT_F ImageViewer::DocPageCellRect(uint32_t page) const
+{
+    // Laid out around the current page, which sits at the centre
+    float cell = Theme::DocPageStripCell;
+    float centerX = viewWidth_ * 0.5f +
+                    (static_cast<float>(page) - static_cast<float>(currentDocPage_)) * (cell + Theme::ThumbnailGap);
+    float bottom = viewHeight_ - kDocStripMargin;
+    return D2D1::RectF(centerX - cell * 0.5f, bottom - cell, centerX + cell * 0.5f, bottom);
+}
+
+int ImageViewer::DocPageAt(float x, float y) const
+{
+    if (docPageCount_ <= 1) return -1;
+    uint32_t first = currentDocPage_ > Theme::DocPageStripRadius ? currentDocPage_ - Theme::DocPageStripRadius : 0;
+    uint32_t last = std::min(docPageCount_ - 1, currentDocPage_ + Theme::DocPageStripRadius);
+    for (uint32_t page = first; page <= last; ++page) {
+        D2D1_RECT_F cell = DocPageCellRect(page);
+        if (x >= cell.left && x < cell.right && y >= cell.top && y < cell.bottom) {
+            return static_cast<int>(page);
+        }
+    }
+    return -1;
+}
+
+void ImageViewer::RenderDocPageStrip(Rendering::Direct2DRenderer* renderer, float alpha)
+{
+    if (docPageCount_ <= 1 || !pipeline_ || images_.empty()) return;
+    auto* ctx = renderer->GetContext();
+
+    // Bottom bar behind the strip, like the top bar behind the counter
+    if (overlayBgBrush_) {
+        overlayBgBrush_->SetOpacity(alpha * 0.5f);
+        float top = viewHeight_ - Theme::DocPageStripCell - kDocStripMargin * 2.0f;
+        ctx->FillRectangle(D2D1::RectF(0, top, viewWidth_, viewHeight_), overlayBgBrush_.Get());
+    }
+
+    // Only cells within DocPageStripRadius are drawn: their thumbnails are
+    // all the pipeline keeps
+    const auto& path = images_[currentIndex_];
+    uint32_t cellPx = static_cast<uint32_t>(std::ceil(Theme::DocPageStripCell * dpiScale_));
+    uint32_t first = currentDocPage_ > Theme::DocPageStripRadius ? currentDocPage_ - Theme::DocPageStripRadius : 0;
+    uint32_t last = std::min(docPageCount_ - 1, currentDocPage_ + Theme::DocPageStripRadius);
+    for (uint32_t page = first; page <= last; ++page) {
+        D2D1_RECT_F cell = DocPageCellRect(page);
+        if (cell.right < 0.0f || cell.left > viewWidth_) continue;
+
+        if (auto thumb = pipeline_->RequestDocPageThumbnail(path, page, cellPx)) {
+            auto size = thumb->GetSize();
+            float scale = std::min((cell.right - cell.left) / size.width, (cell.bottom - cell.top) / size.height);
+            float w = size.width * scale;
+            float h = size.height * scale;
+            float cx = (cell.left + cell.right) * 0.5f;
+            float cy = (cell.top + cell.bottom) * 0.5f;
+            renderer->DrawImage(thumb.Get(), D2D1::RectF(cx - w * 0.5f, cy - h * 0.5f, cx + w * 0.5f, cy + h * 0.5f),
+                                alpha);
+        } else if (overlayBgBrush_) {
+            overlayBgBrush_->SetOpacity(alpha);
+            ctx->FillRectangle(cell, overlayBgBrush_.Get());
+        }
+
+        if (page == currentDocPage_ && accentBrush_) {
+            accentBrush_->SetOpacity(alpha);
+            ctx->DrawRectangle(cell, accentBrush_.Get(), 2.0f);
+            accentBrush_->SetOpacity(1.0f);
+        }
+    }
+    if (overlayBgBrush_) {
+        overlayBgBrush_->SetOpacity(1.0f);
+    }
+}
+
+ID2D1Bitmap* ImageViewer::DisplayedBitmap() const
+{
+    if (currentDocPage_ > 0 && docPageBitmap_) {
+        return docPageBitmap_.Get();
     }
+    return currentBitmap_.Get();
 }
 
 void ImageViewer::Update(float deltaTime)
@@ -336,6 +572,8 @@ void ImageViewer::Update(float deltaTime)
     panY_ = panYSpring_.GetValue();
     dismissOffsetY_ = dismissSpring_.GetValue();
 
+    RequestFullResolutionIfNeeded();
+
     // Check if page navigation completed
     if (!isPaging_ && std::abs(pageOffsetX_.GetValue()) < 1.0f && pageOffsetX_.IsFinished()) {
         pageOffsetX_.SetValue(0.0f);
@@ -488,6 +726,14 @@ void ImageViewer::OnMouseUp(float x, float y)
     // Check for double-tap
     ULONGLONG now = GetTickCount64();
     if (!hasDragged_) {
+        // A click in the page strip turns to that page
+        int docPage = DocPageAt(x, y);
+        if (docPage >= 0) {
+            GoToDocPage(static_cast<uint32_t>(docPage));
+            lastClickTime_ = 0;
+            return;
+        }
+
         if (now - lastClickTime_ < kDoubleTapMs &&
             std::abs(x - lastClickX_) < 20.0f &&
             std::abs(y - lastClickY_) < 20.0f) {
@@ -608,6 +854,14 @@ void ImageViewer::OnKeyDown(UINT key)
         case VK_RIGHT:
             GoNext();
             break;
+        case VK_PRIOR:
+            if (currentDocPage_ > 0) {
+                GoToDocPage(currentDocPage_ - 1);
+            }
+            break;
+        case VK_NEXT:
+            GoToDocPage(currentDocPage_ + 1);
+            break;
         case VK_ESCAPE:
             // Reset zoom/pan for clean hero transition from center
             zoom_ = 1.0f;
@@ -633,19 +887,21 @@ void ImageViewer::OnKeyDown(UINT key)
 
 D2D1_RECT_F ImageViewer::GetCurrentImageRect() const
 {
-    if (!currentBitmap_) {
+    ID2D1Bitmap* bitmap = DisplayedBitmap();
+    if (!bitmap) {
         return D2D1::RectF(0, 0, viewWidth_, viewHeight_);
     }
-    auto size = currentBitmap_->GetSize();
+    auto size = bitmap->GetSize();
     return CalculateFitRect(size.width, size.height);
 }
 
 D2D1_RECT_F ImageViewer::GetCurrentScreenRect() const
 {
-    if (!currentBitmap_) {
+    ID2D1Bitmap* bitmap = DisplayedBitmap();
+    if (!bitmap) {
         return D2D1::RectF(0, 0, viewWidth_, viewHeight_);
     }
-    auto size = currentBitmap_->GetSize();
+    auto size = bitmap->GetSize();
     D2D1_RECT_F fitRect = CalculateFitRect(size.width, size.height);
 
     float currentZoom = zoomSpring_.GetValue();
@@ -716,6 +972,26 @@ void ImageViewer::GoToIndex(size_t index)
     LoadCurrentPage();
 }
 
+void ImageViewer::GoToDocPage(uint32_t page)
+{
+    if (page >= docPageCount_ || page == currentDocPage_) return;
+
+    currentDocPage_ = page;
+    zoom_ = 1.0f;
+    panX_ = 0.0f;
+    panY_ = 0.0f;
+    isZoomedIn_ = false;
+    zoomSpring_.SetValue(1.0f);
+    zoomSpring_.SetTarget(1.0f);
+    zoomSpring_.SnapToTarget();
+    panXSpring_.SetValue(0.0f);
+    panXSpring_.SetTarget(0.0f);
+    panXSpring_.SnapToTarget();
+    panYSpring_.SetValue(0.0f);
+    panYSpring_.SetTarget(0.0f);
+    panYSpring_.SnapToTarget();
+}
+
 void ImageViewer::GoNext()
 {
     if (currentIndex_ + 1 < images_.size()) {
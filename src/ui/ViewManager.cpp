@@ -5,7 +5,12 @@ namespace UltraImageViewer {
 namespace UI {
 
 ViewManager::ViewManager() = default;
-ViewManager::~ViewManager() = default;
+ViewManager::~ViewManager()
+{
+    if (animEngine_ && frameClockId_) {
+        animEngine_->RemoveFrameClock(frameClockId_);
+    }
+}
 
 void ViewManager::Initialize(Rendering::Direct2DRenderer* renderer,
                               Animation::AnimationEngine* engine,
@@ -14,6 +19,13 @@ void ViewManager::Initialize(Rendering::Direct2DRenderer* renderer,
     animEngine_ = engine;
     pipeline_ = pipeline;
 
+    // Animated GIF/WebP frames advance on the engine's clock
+    if (animEngine_ && pipeline_) {
+        frameClockId_ = animEngine_->AddFrameClock([this](float dt) {
+            return pipeline_->AdvanceAnimations(dt);
+        });
+    }
+
     galleryView_.Initialize(renderer, pipeline, engine);
     imageViewer_.Initialize(renderer, pipeline, engine);
     transition_.Initialize(engine);